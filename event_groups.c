@@ -54,6 +54,7 @@
     typedef struct EventGroupDef_t
     {
         EventBits_t uxEventBits;
+        EventBits_t uxBitsWaitedFor; /**< Union of the bits waited for by the tasks in xTasksWaitingForBits.  May contain stale bits of tasks that have since timed out, but never omits a bit a blocked task is waiting for. */
         List_t xTasksWaitingForBits; /**< List of tasks waiting for a bit to be set. */
 
         #if ( configUSE_TRACE_FACILITY == 1 )
@@ -67,6 +68,46 @@
 
 /*-----------------------------------------------------------*/
 
+/* Dynamically allocated event groups are taken from, and returned to, a pool
+ * of event groups if configEVENT_GROUP_POOL_SLAB_LENGTH is greater than 0. */
+    #if ( configEVENT_GROUP_POOL_SLAB_LENGTH > 0 )
+        #define prvAllocateEventGroup()             pvTaskAllocateFromObjectPool( tskEVENT_GROUP_OBJECT_POOL )
+        #define prvFreeEventGroup( pxEventBits )    vTaskReturnToObjectPool( tskEVENT_GROUP_OBJECT_POOL, ( pxEventBits ) )
+    #else
+        #define prvAllocateEventGroup()             pvPortMalloc( sizeof( EventGroup_t ) )
+        #define prvFreeEventGroup( pxEventBits )    vPortFree( pxEventBits )
+    #endif
+
+/*
+ * When configUSE_EVENT_GROUP_DIRECT_FROM_ISR is 1, interrupts set and clear
+ * event bits and unblock waiting tasks directly rather than deferring the
+ * operation to the RTOS daemon task.  Suspending the scheduler does not stop
+ * interrupts from running, so the task level code must additionally hold a
+ * critical section while it accesses the event bits or the list of waiting
+ * tasks.  Otherwise suspending the scheduler is sufficient.
+ */
+    #if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 )
+        #define prvENTER_CRITICAL_IF_DIRECT_FROM_ISR()    taskENTER_CRITICAL()
+        #define prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR()     taskEXIT_CRITICAL()
+    #else
+        #define prvENTER_CRITICAL_IF_DIRECT_FROM_ISR()
+        #define prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR()
+    #endif
+
+/*
+ * Obtain the bits and control bits stored with a task waiting on an event
+ * group.  The value is held in the task's event list item value unless
+ * configUSE_64_BIT_EVENT_GROUPS is 1, in which case it may be wider than the
+ * event list item value and is held by the task itself.
+ */
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        #define eventGET_WAITER_VALUE( pxListItem )    uxTaskGetEventListItemValue( pxListItem )
+    #else
+        #define eventGET_WAITER_VALUE( pxListItem )    listGET_LIST_ITEM_VALUE( pxListItem )
+    #endif
+
+/*-----------------------------------------------------------*/
+
 /*
  * Test the bits set in uxCurrentEventBits to see if the wait condition is met.
  * The wait condition is defined by xWaitForAllBits.  If xWaitForAllBits is
@@ -111,6 +152,7 @@
             if( pxEventBits != NULL )
             {
                 pxEventBits->uxEventBits = 0;
+                pxEventBits->uxBitsWaitedFor = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
                 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -151,11 +193,12 @@
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxEventBits = ( EventGroup_t * ) pvPortMalloc( sizeof( EventGroup_t ) );
+            pxEventBits = ( EventGroup_t * ) prvAllocateEventGroup();
 
             if( pxEventBits != NULL )
             {
                 pxEventBits->uxEventBits = 0;
+                pxEventBits->uxBitsWaitedFor = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -203,6 +246,7 @@
         #endif
 
         vTaskSuspendAll();
+        prvENTER_CRITICAL_IF_DIRECT_FROM_ISR();
         {
             uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -229,6 +273,7 @@
                      * task's event list item so the kernel knows when a match is
                      * found.  Then enter the blocked state. */
                     vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+                    pxEventBits->uxBitsWaitedFor |= uxBitsToWaitFor;
 
                     /* This assignment is obsolete as uxReturn will get set after
                      * the task unblocks, but some compilers mistakenly generate a
@@ -245,6 +290,7 @@
                 }
             }
         }
+        prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR();
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -334,6 +380,7 @@
         #endif
 
         vTaskSuspendAll();
+        prvENTER_CRITICAL_IF_DIRECT_FROM_ISR();
         {
             const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -392,6 +439,7 @@
                  * task's event list item so the kernel knows when a match is
                  * found.  Then enter the blocked state. */
                 vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+                pxEventBits->uxBitsWaitedFor |= uxBitsToWaitFor;
 
                 /* This is obsolete as it will get set after the task unblocks, but
                  * some compilers mistakenly generate a warning about the variable
@@ -401,6 +449,7 @@
                 traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
             }
         }
+        prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR();
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -501,7 +550,38 @@
     }
 /*-----------------------------------------------------------*/
 
-    #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+    #if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 )
+
+        BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
+                                                const EventBits_t uxBitsToClear )
+        {
+            EventGroup_t * pxEventBits = xEventGroup;
+            UBaseType_t uxSavedInterruptStatus;
+
+            traceENTER_xEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear );
+
+            configASSERT( xEventGroup );
+            configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+            /* The event bits are accessed directly, so clear them in a critical
+             * section rather than pending the operation to the daemon task. */
+            /* MISRA Ref 4.7.1 [Return value shall be checked] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+            /* coverity[misra_c_2012_directive_4_7_violation] */
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
+
+                pxEventBits->uxEventBits &= ~uxBitsToClear;
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+            traceRETURN_xEventGroupClearBitsFromISR( pdPASS );
+
+            return pdPASS;
+        }
+
+    #elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                                 const EventBits_t uxBitsToClear )
@@ -510,6 +590,13 @@
 
             traceENTER_xEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear );
 
+            #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+            {
+                /* Only 32 bits can be passed to the RTOS daemon task. */
+                configASSERT( ( uxBitsToClear & ~( ( EventBits_t ) 0xffffffffU ) ) == 0 );
+            }
+            #endif
+
             traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
             xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL );
 
@@ -518,7 +605,7 @@
             return xReturn;
         }
 
-    #endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+    #endif /* if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 ) */
 /*-----------------------------------------------------------*/
 
     EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
@@ -551,7 +638,7 @@
         ListItem_t * pxNext;
         ListItem_t const * pxListEnd;
         List_t const * pxList;
-        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits, uxReturnBits;
+        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits, uxReturnBits, uxStillWaitedFor = 0;
         EventGroup_t * pxEventBits = xEventGroup;
         BaseType_t xMatchFound = pdFALSE;
 
@@ -565,6 +652,7 @@
         pxList = &( pxEventBits->xTasksWaitingForBits );
         pxListEnd = listGET_END_MARKER( pxList );
         vTaskSuspendAll();
+        prvENTER_CRITICAL_IF_DIRECT_FROM_ISR();
         {
             traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
@@ -573,72 +661,95 @@
             /* Set the bits. */
             pxEventBits->uxEventBits |= uxBitsToSet;
 
-            /* See if the new bit value should unblock any tasks. */
-            while( pxListItem != pxListEnd )
+            /* A blocked task's wait condition can only change if at least one of
+             * the bits it is waiting for is being set now.  If no blocked task is
+             * waiting for any of the bits being set then there is no need to walk
+             * the list of waiting tasks at all. */
+            if( ( pxEventBits->uxBitsWaitedFor & uxBitsToSet ) != ( EventBits_t ) 0 )
             {
-                pxNext = listGET_NEXT( pxListItem );
-                uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-                xMatchFound = pdFALSE;
+                /* See if the new bit value should unblock any tasks. */
+                while( pxListItem != pxListEnd )
+                {
+                    pxNext = listGET_NEXT( pxListItem );
+                    uxBitsWaitedFor = eventGET_WAITER_VALUE( pxListItem );
+                    xMatchFound = pdFALSE;
 
-                /* Split the bits waited for from the control bits. */
-                uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-                uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+                    /* Split the bits waited for from the control bits. */
+                    uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+                    uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
 
-                if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-                {
-                    /* Just looking for single bit being set. */
-                    if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+                    if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
                     {
+                        /* Just looking for single bit being set. */
+                        if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+                        {
+                            xMatchFound = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+                    {
+                        /* All bits are set. */
                         xMatchFound = pdTRUE;
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        /* Need all bits to be set, but not all the bits were set. */
                     }
-                }
-                else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-                {
-                    /* All bits are set. */
-                    xMatchFound = pdTRUE;
-                }
-                else
-                {
-                    /* Need all bits to be set, but not all the bits were set. */
-                }
 
-                if( xMatchFound != pdFALSE )
-                {
-                    /* The bits match.  Should the bits be cleared on exit? */
-                    if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                    if( xMatchFound != pdFALSE )
                     {
-                        uxBitsToClear |= uxBitsWaitedFor;
+                        /* The bits match.  Should the bits be cleared on exit? */
+                        if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                        {
+                            uxBitsToClear |= uxBitsWaitedFor;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        /* Store the actual event flag value in the task's event list
+                         * item before removing the task from the event list.  The
+                         * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+                         * that is was unblocked due to its required bits matching, rather
+                         * than because it timed out. */
+                        vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        /* The task remains blocked, so its bits remain of
+                         * interest. */
+                        uxStillWaitedFor |= uxBitsWaitedFor;
                     }
 
-                    /* Store the actual event flag value in the task's event list
-                     * item before removing the task from the event list.  The
-                     * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                     * that is was unblocked due to its required bits matching, rather
-                     * than because it timed out. */
-                    vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+                    /* Move onto the next list item.  Note pxListItem->pxNext is not
+                     * used here as the list item may have been removed from the event list
+                     * and inserted into the ready/pending reading list. */
+                    pxListItem = pxNext;
                 }
 
-                /* Move onto the next list item.  Note pxListItem->pxNext is not
-                 * used here as the list item may have been removed from the event list
-                 * and inserted into the ready/pending reading list. */
-                pxListItem = pxNext;
-            }
+                /* The whole list was walked, so the union of the bits waited for
+                 * can be rebuilt exactly, dropping any bits belonging to tasks that
+                 * have since unblocked or timed out. */
+                pxEventBits->uxBitsWaitedFor = uxStillWaitedFor;
 
-            /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-             * bit was set in the control word. */
-            pxEventBits->uxEventBits &= ~uxBitsToClear;
+                /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+                 * bit was set in the control word. */
+                pxEventBits->uxEventBits &= ~uxBitsToClear;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
             /* Snapshot resulting bits. */
             uxReturnBits = pxEventBits->uxEventBits;
         }
+        prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR();
         ( void ) xTaskResumeAll();
 
         traceRETURN_xEventGroupSetBits( uxReturnBits );
@@ -659,6 +770,7 @@
         pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 
         vTaskSuspendAll();
+        prvENTER_CRITICAL_IF_DIRECT_FROM_ISR();
         {
             traceEVENT_GROUP_DELETE( xEventGroup );
 
@@ -670,13 +782,14 @@
                 vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
             }
         }
+        prvEXIT_CRITICAL_IF_DIRECT_FROM_ISR();
         ( void ) xTaskResumeAll();
 
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
         {
             /* The event group can only have been allocated dynamically - free
              * it again. */
-            vPortFree( pxEventBits );
+            prvFreeEventGroup( pxEventBits );
         }
         #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
         {
@@ -684,7 +797,7 @@
              * dynamically, so check before attempting to free the memory. */
             if( pxEventBits->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
             {
-                vPortFree( pxEventBits );
+                prvFreeEventGroup( pxEventBits );
             }
             else
             {
@@ -812,7 +925,117 @@
     }
 /*-----------------------------------------------------------*/
 
-    #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+    #if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 )
+
+        BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
+                                              const EventBits_t uxBitsToSet,
+                                              BaseType_t * pxHigherPriorityTaskWoken )
+        {
+            ListItem_t * pxListItem;
+            ListItem_t * pxNext;
+            ListItem_t const * pxListEnd;
+            List_t const * pxList;
+            EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits, uxStillWaitedFor = 0;
+            EventGroup_t * pxEventBits = xEventGroup;
+            BaseType_t xWaitForAllBits, xYieldRequired = pdFALSE;
+            UBaseType_t uxSavedInterruptStatus;
+
+            traceENTER_xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken );
+
+            configASSERT( xEventGroup );
+            configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+            /* RTOS ports that support interrupt nesting have the concept of a
+             * maximum system call (or maximum API call) interrupt priority.
+             * See the comment in xQueueGenericSendFromISR(). */
+            portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+            pxList = &( pxEventBits->xTasksWaitingForBits );
+            pxListEnd = listGET_END_MARKER( pxList );
+
+            /* Task level code accesses the event bits and the list of waiting
+             * tasks from within a critical section, so the tasks whose wait
+             * condition is met can be unblocked directly from here.  The time
+             * spent in the critical section is bounded by the number of tasks
+             * blocked on this event group, and the list is not walked at all if
+             * none of those tasks is waiting for any of the bits being set. */
+            /* MISRA Ref 4.7.1 [Return value shall be checked] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+            /* coverity[misra_c_2012_directive_4_7_violation] */
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+                pxEventBits->uxEventBits |= uxBitsToSet;
+
+                if( ( pxEventBits->uxBitsWaitedFor & uxBitsToSet ) != ( EventBits_t ) 0 )
+                {
+                    pxListItem = listGET_HEAD_ENTRY( pxList );
+
+                    while( pxListItem != pxListEnd )
+                    {
+                        pxNext = listGET_NEXT( pxListItem );
+                        uxBitsWaitedFor = eventGET_WAITER_VALUE( pxListItem );
+
+                        /* Split the bits waited for from the control bits. */
+                        uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+                        uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+                        xWaitForAllBits = ( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 ) ? pdTRUE : pdFALSE;
+
+                        if( prvTestWaitCondition( pxEventBits->uxEventBits, uxBitsWaitedFor, xWaitForAllBits ) != pdFALSE )
+                        {
+                            if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                            {
+                                uxBitsToClear |= uxBitsWaitedFor;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+
+                            /* See the comment in xEventGroupSetBits(). */
+                            if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+                            {
+                                xYieldRequired = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            uxStillWaitedFor |= uxBitsWaitedFor;
+                        }
+
+                        pxListItem = pxNext;
+                    }
+
+                    pxEventBits->uxBitsWaitedFor = uxStillWaitedFor;
+                    pxEventBits->uxEventBits &= ~uxBitsToClear;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+            if( ( xYieldRequired != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+            {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            traceRETURN_xEventGroupSetBitsFromISR( pdPASS );
+
+            return pdPASS;
+        }
+
+    #elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                               const EventBits_t uxBitsToSet,
@@ -822,6 +1045,13 @@
 
             traceENTER_xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken );
 
+            #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+            {
+                /* Only 32 bits can be passed to the RTOS daemon task. */
+                configASSERT( ( uxBitsToSet & ~( ( EventBits_t ) 0xffffffffU ) ) == 0 );
+            }
+            #endif
+
             traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
             xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken );
 
@@ -830,7 +1060,7 @@
             return xReturn;
         }
 
-    #endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+    #endif /* if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 ) */
 /*-----------------------------------------------------------*/
 
     #if ( configUSE_TRACE_FACILITY == 1 )
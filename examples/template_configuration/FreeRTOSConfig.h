@@ -174,6 +174,15 @@
  * optimization. Defaults to 1 if left undefined. */
 #define configUSE_MINI_LIST_ITEM                   1
 
+/* Set configUSE_LIST_SEARCH_TREE to 1 to index the items that vListInsert()
+ * places in sorted lists, such as the delayed task lists, the timer lists and
+ * the priority ordered event lists, with a red-black tree, so inserting into
+ * a list of n items takes O(log n) rather than O(n) time.  Adds three
+ * pointers and a UBaseType_t to each list item and a pointer to each list, so
+ * is only worthwhile for lists of hundreds of items or more.  Defaults to 0
+ * if left undefined. */
+#define configUSE_LIST_SEARCH_TREE                 0
+
 /* Sets the type used by the parameter to xTaskCreate() that specifies the stack
  * size of the task being created.  The same type is used to return information
  * about stack usage in various other API calls.  Defaults to size_t if left
@@ -242,6 +251,55 @@
  * used if configUSE_TIMERS is set to 1. */
 #define configTIMER_QUEUE_LENGTH        10
 
+/* Set configUSE_TIMER_WHEEL to 1 to hold active timers in a hierarchical timer
+ * wheel, making starting, stopping and resetting a timer constant time rather
+ * than proportional to the number of active timers.  The wheel has
+ * configTIMER_WHEEL_LEVELS levels of 2^configTIMER_WHEEL_SLOT_BITS slots each,
+ * and covers timers that expire within the same
+ * 2^( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) tick block as the
+ * current time - timers that expire later are held in a sorted list until their
+ * block is reached.  Each slot uses a List_t, so the wheel adds
+ * configTIMER_WHEEL_LEVELS * 2^configTIMER_WHEEL_SLOT_BITS lists of RAM.
+ * configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS must be less than the
+ * number of bits in TickType_t.  configUSE_TIMER_WHEEL defaults to 0,
+ * configTIMER_WHEEL_SLOT_BITS to 6 and configTIMER_WHEEL_LEVELS to 3 (2 if
+ * configTICK_TYPE_WIDTH_IN_BITS is TICK_TYPE_WIDTH_16_BITS) if left
+ * undefined.  Only used if configUSE_TIMERS is set to 1. */
+#define configUSE_TIMER_WHEEL           0
+#define configTIMER_WHEEL_SLOT_BITS     6
+#define configTIMER_WHEEL_LEVELS        3
+
+/* Set configUSE_TIMER_DIRECT_COMMANDS to 1 to have xTimerStart(),
+ * xTimerReset(), xTimerStop() and xTimerChangePeriod() called from a task update
+ * the active timers directly with the scheduler suspended, rather than sending a
+ * command to the timer task.  The timer task is only unblocked if the timer
+ * expires before the time until which the timer task is blocked.  Deleting a
+ * timer, and the FromISR() versions of the functions, still send a command to the
+ * timer task, so are not ordered with respect to the direct commands.  Defaults
+ * to 0 if left undefined.  Only used if configUSE_TIMERS is set to 1. */
+#define configUSE_TIMER_DIRECT_COMMANDS    0
+
+/* Set configUSE_TIMER_SLACK to 1 to give each timer a slack - the number of
+ * ticks by which the processing of the timer may be delayed after its expiry
+ * time.  The timer task then blocks until the latest time at which it can
+ * process all the timers that expire before that time without exceeding any of
+ * their slacks, so timers that expire close together are processed in one wake
+ * up.  configTIMER_DEFAULT_SLACK sets the slack of newly created timers, which
+ * can be changed using vTimerSetSlack().  configUSE_TIMER_SLACK and
+ * configTIMER_DEFAULT_SLACK default to 0 if left undefined.  Only used if
+ * configUSE_TIMERS is set to 1. */
+#define configUSE_TIMER_SLACK              0
+#define configTIMER_DEFAULT_SLACK          0
+
+/* Set configTIMER_DEFERRED_CALL_RING_LENGTH to a value greater than 0 to have
+ * xTimerPendFunctionCallFromISR() write the pended function to a per-core ring
+ * of that length instead of sending one message per call on the timer queue.
+ * The timer task executes every function in the ring each time it runs, so a
+ * burst of interrupts does not fill the timer queue.  Calls that do not fit in
+ * the ring fail, and are counted.  Defaults to 0 (disabled) if left undefined.
+ * Only used if INCLUDE_xTimerPendFunctionCall is set to 1. */
+#define configTIMER_DEFERRED_CALL_RING_LENGTH    0
+
 /******************************************************************************/
 /* Event Group related definitions. *******************************************/
 /******************************************************************************/
@@ -253,6 +311,21 @@
 
 #define configUSE_EVENT_GROUPS    1
 
+/* Set configUSE_EVENT_GROUP_DIRECT_FROM_ISR to 1 to have
+ * xEventGroupSetBitsFromISR() and xEventGroupClearBitsFromISR() access the
+ * event group directly from the interrupt, instead of deferring the operation
+ * to the timer task.  Task level event group operations then use critical
+ * sections in addition to suspending the scheduler.  Defaults to 0 if left
+ * undefined. */
+#define configUSE_EVENT_GROUP_DIRECT_FROM_ISR    0
+
+/* Set configUSE_64_BIT_EVENT_GROUPS to 1 to make EventBits_t a 64-bit type no
+ * matter the setting of configTICK_TYPE_WIDTH_IN_BITS, giving 56 usable event
+ * bits per event group.  Otherwise EventBits_t is the same width as TickType_t
+ * and the most significant 8 bits are reserved for use by the kernel.  Not
+ * supported by the MPU ports.  Defaults to 0 if left undefined. */
+#define configUSE_64_BIT_EVENT_GROUPS            0
+
 /******************************************************************************/
 /* Stream Buffer related definitions. *****************************************/
 /******************************************************************************/
@@ -303,10 +376,77 @@
 #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP    0
 
 /* Set configENABLE_HEAP_PROTECTOR to 1 to enable bounds checking and
- * obfuscation to internal heap block pointers in heap_4.c and heap_5.c to help
- * catch pointer corruptions. Defaults to 0 if left undefined. */
+ * obfuscation to internal heap block pointers in heap_4.c, heap_5.c and
+ * heap_6.c to help catch pointer corruptions. Defaults to 0 if left undefined. */
 #define configENABLE_HEAP_PROTECTOR                  0
 
+/* configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 and configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2
+ * size the free list array used by the constant time allocator in heap_6.c.
+ * Each power of two block size is divided into
+ * 2 ^ configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 free lists (between 1 and 5,
+ * defaults to 4), and heap regions must be smaller than
+ * 2 ^ configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 bytes (defaults to one less than the
+ * number of bits in a size_t).  Smaller values use less RAM.  Only used if
+ * heap_6.c is included in the build. */
+#define configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2      4
+#define configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2          24
+
+/* In SMP builds, set configHEAP_PER_CORE_CACHE_LENGTH to a value greater than
+ * 0 to have heap_4.c and heap_5.c keep a cache of up to that many free blocks
+ * of each small size class for each core.  Most small allocations and frees
+ * then complete without locking the heap.  Blocks are moved between a cache and
+ * the heap half a cache at a time.  Small requests are rounded up to the block
+ * size of their size class, and blocks held in a cache are reported as
+ * allocated by xPortGetFreeHeapSize() and vPortGetHeapStats().  If the heap
+ * cannot satisfy a request, the blocks held in every cache are returned to it
+ * and the request is tried again.  configHEAP_PER_CORE_CACHE_SIZE_CLASSES sets the number of size classes, each
+ * holding blocks twice the size of the size class below it, starting at twice
+ * the size of the heap block header.  Defaults to 0 (no caches) and 4 size
+ * classes if left undefined.  Ignored in single core builds. */
+#define configHEAP_PER_CORE_CACHE_LENGTH             0
+#define configHEAP_PER_CORE_CACHE_SIZE_CLASSES       4
+
+/* Set configISR_HEAP_NUMBER_OF_BLOCKS to a value greater than 0 to have
+ * heap_4.c, heap_5.c and heap_6.c provide pvPortMallocFromISR() and
+ * vPortFreeFromISR(), which allocate and free blocks of
+ * configISR_HEAP_BLOCK_SIZE bytes from a statically allocated pool of that
+ * many blocks.  The pool is separate from the heap and is accessed with
+ * interrupts masked, so it can be used from interrupts, and allocation and
+ * free take a constant time.  Defaults to 0 (no pool) if left undefined. */
+#define configISR_HEAP_NUMBER_OF_BLOCKS              0
+#define configISR_HEAP_BLOCK_SIZE                    0
+
+/* Set configHEAP_INSTRUMENTATION to 1 to have heap_4.c and heap_5.c provide
+ * vPortGetHeapInstrumentation(), which reports a histogram of the sizes of the
+ * free blocks, the number of allocations made by each of up to
+ * configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS tasks, and the minimum, average
+ * and maximum time allocations have held the heap locked.  Each histogram
+ * entry counts blocks twice the size of the entry below it, starting at 16
+ * bytes.  Define configHEAP_INSTRUMENTATION_GET_KEY() to count allocations
+ * against something other than the calling task, for example
+ * __builtin_return_address( 0 ) to count them per call site.  Times are
+ * measured with configHEAP_INSTRUMENTATION_GET_TIME(), which defaults to
+ * portGET_RUN_TIME_COUNTER_VALUE().  Defaults to 0 (no instrumentation), 16
+ * histogram entries and 8 keys if left undefined. */
+#define configHEAP_INSTRUMENTATION                      0
+#define configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS    16
+#define configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS       8
+
+/* Set configTASK_POOL_SLAB_LENGTH, configQUEUE_POOL_SLAB_LENGTH,
+ * configTIMER_POOL_SLAB_LENGTH and configEVENT_GROUP_POOL_SLAB_LENGTH to a
+ * value greater than 0 to have dynamically allocated task control blocks,
+ * queues, software timers and event groups respectively taken from a pool of
+ * fixed size objects instead of directly from the heap.  When a pool is empty
+ * the kernel allocates a slab of that many objects from the heap in one
+ * allocation.  Deleted objects are returned to their pool, and slabs are never
+ * returned to the heap.  Only queues that do not have a storage area, which
+ * includes all semaphores and mutexes, are pooled.  Defaults to 0 (objects are
+ * allocated directly from the heap) if left undefined. */
+#define configTASK_POOL_SLAB_LENGTH                  0
+#define configQUEUE_POOL_SLAB_LENGTH                 0
+#define configTIMER_POOL_SLAB_LENGTH                 0
+#define configEVENT_GROUP_POOL_SLAB_LENGTH           0
+
 /******************************************************************************/
 /* Interrupt nesting behaviour configuration. *********************************/
 /******************************************************************************/
@@ -558,6 +698,17 @@
  * tskNO_AFFINITY if left undefined. */
 #define configTIMER_SERVICE_TASK_CORE_AFFINITY    tskNO_AFFINITY
 
+/* When using SMP (i.e. configNUMBER_OF_CORES is greater than one), set
+ * configUSE_TIMER_SERVICE_TASK_PER_CORE to 1 to create one RTOS Daemon/Timer
+ * Service task per core, each with its own active timers and command queue, so
+ * timer callbacks and pended function calls execute on multiple cores.  A timer
+ * is processed by the timer task of the core from which it was last started,
+ * or of the core set by vTimerSetCoreID().  Pended function calls execute in the
+ * timer task of the calling core.  configTIMER_SERVICE_TASK_CORE_AFFINITY is not
+ * used, and configUSE_CORE_AFFINITY must be set to 1.  Defaults to 0 if left
+ * undefined. */
+#define configUSE_TIMER_SERVICE_TASK_PER_CORE     0
+
 /******************************************************************************/
 /* ARMv8-M secure side port related definitions. ******************************/
 /******************************************************************************/
@@ -629,6 +780,55 @@
  * Defaults to 1 if left undefined. */
 #define configCHECK_HANDLER_INSTALLATION    1
 
+/******************************************************************************/
+/* POSIX port Specific Configuration definitions. *****************************/
+/******************************************************************************/
+
+/* Set configPOSIX_USE_UCONTEXT to 1 to run every task of the GCC/Posix port on
+ * the host thread that started the scheduler and switch between them with
+ * swapcontext(), or 0 to give each task its own pthread.  Switching in user
+ * space is much faster, but task stacks must then be sized for the host C
+ * library.  Only supported on Linux hosts.  Defaults to 0 if left undefined. */
+#define configPOSIX_USE_UCONTEXT    0
+
+/* Set configPOSIX_VIRTUAL_TIME to 1 to run the GCC/Posix port in virtual time,
+ * where idle periods are skipped instead of waited out, so simulations that
+ * spend most of their time blocked run as fast as the host allows.  Ticks are
+ * only taken while the idle task runs, so runs are repeatable, but a task that
+ * never blocks stops simulated time and is not time sliced.  Requires
+ * configUSE_TICKLESS_IDLE and INCLUDE_xTaskGetIdleTaskHandle to be 1 and
+ * configNUMBER_OF_CORES to be 1.  Defaults to 0 if left undefined. */
+#define configPOSIX_VIRTUAL_TIME    0
+
+/* configPOSIX_TASK_CPU_AFFINITY and configPOSIX_TIMER_CPU_AFFINITY are bit masks
+ * of the host CPUs that the GCC/Posix port runs tasks and generates the tick
+ * and simulated interrupts on.  0 leaves the threads unpinned.  Only supported
+ * on Linux hosts.  Default to 0 if left undefined. */
+#define configPOSIX_TASK_CPU_AFFINITY     0
+#define configPOSIX_TIMER_CPU_AFFINITY    0
+
+/* Set configPOSIX_USE_SCHED_FIFO to 1 to run the host threads of the GCC/Posix
+ * port under the SCHED_FIFO policy, tasks at configPOSIX_SCHED_FIFO_PRIORITY
+ * and the timers one priority higher, and to lock all memory with mlockall().
+ * This makes timing measurements repeatable, but usually needs CAP_SYS_NICE
+ * and CAP_IPC_LOCK.  configPOSIX_USE_SCHED_FIFO defaults to 0 and
+ * configPOSIX_SCHED_FIFO_PRIORITY to 10 if left undefined. */
+#define configPOSIX_USE_SCHED_FIFO         0
+#define configPOSIX_SCHED_FIFO_PRIORITY    10
+
+/* Set configPOSIX_SCHEDULE_LOG to 1 to allow the GCC/Posix port to record the
+ * points at which ticks and simulated interrupts are taken, and every task
+ * selected by vTaskSwitchContext(), to a file with vPortRecordSchedule(), and
+ * to replay the same interleaving from that file with vPortReplaySchedule().
+ * Interrupts are then only taken when a task enables interrupts or while the
+ * idle task runs, unless a task runs for configPOSIX_SCHEDULE_LOG_FORCE_TICKS
+ * ticks without enabling interrupts, when they are taken wherever it is.
+ * Requires configPOSIX_USE_UCONTEXT, INCLUDE_xTaskGetIdleTaskHandle and
+ * INCLUDE_xTaskGetSchedulerState to be 1.  configPOSIX_SCHEDULE_LOG defaults
+ * to 0 and configPOSIX_SCHEDULE_LOG_FORCE_TICKS to 10 if left undefined. */
+#define configPOSIX_SCHEDULE_LOG                0
+#define configPOSIX_SCHEDULE_LOG_FORCE_TICKS    10
+
 /******************************************************************************/
 /* Definitions that include or exclude functionality. *************************/
 /******************************************************************************/
@@ -325,10 +325,60 @@
     #define configUSE_TIMERS    0
 #endif
 
+#ifndef configUSE_TIMER_WHEEL
+    #define configUSE_TIMER_WHEEL    0
+#endif
+
+#ifndef configTIMER_WHEEL_SLOT_BITS
+    #define configTIMER_WHEEL_SLOT_BITS    6
+#endif
+
+#ifndef configTIMER_WHEEL_LEVELS
+    #if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+        #define configTIMER_WHEEL_LEVELS    2
+    #else
+        #define configTIMER_WHEEL_LEVELS    3
+    #endif
+#endif
+
+/* The number of ticks spanned by the timer wheel must be representable by a
+ * TickType_t. */
+#if ( configUSE_TIMER_WHEEL == 1 )
+    #if ( ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) >= 16 ) ) || \
+          ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_32_BITS ) && ( ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) >= 32 ) ) || \
+          ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_64_BITS ) && ( ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) >= 64 ) ) )
+        #error configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS must be less than the number of bits in TickType_t.
+    #endif
+#endif
+
+#ifndef configUSE_TIMER_DIRECT_COMMANDS
+    #define configUSE_TIMER_DIRECT_COMMANDS    0
+#endif
+
+#ifndef configUSE_TIMER_SLACK
+    #define configUSE_TIMER_SLACK    0
+#endif
+
+#ifndef configTIMER_DEFAULT_SLACK
+    #define configTIMER_DEFAULT_SLACK    0
+#endif
+
+#ifndef configTIMER_DEFERRED_CALL_RING_LENGTH
+    #define configTIMER_DEFERRED_CALL_RING_LENGTH    0
+#endif
+
 #ifndef configUSE_EVENT_GROUPS
     #define configUSE_EVENT_GROUPS    1
 #endif
 
+#ifndef configUSE_EVENT_GROUP_DIRECT_FROM_ISR
+    #define configUSE_EVENT_GROUP_DIRECT_FROM_ISR    0
+#endif
+
+#ifndef configUSE_64_BIT_EVENT_GROUPS
+    #define configUSE_64_BIT_EVENT_GROUPS    0
+#endif
+
 #ifndef configUSE_STREAM_BUFFERS
     #define configUSE_STREAM_BUFFERS    1
 #endif
@@ -512,6 +562,10 @@
     #define configUSE_PASSIVE_IDLE_HOOK    0
 #endif /* configUSE_PASSIVE_IDLE_HOOK */
 
+#ifndef configUSE_TIMER_SERVICE_TASK_PER_CORE
+    #define configUSE_TIMER_SERVICE_TASK_PER_CORE    0
+#endif /* configUSE_TIMER_SERVICE_TASK_PER_CORE */
+
 /* The timers module relies on xTaskGetSchedulerState(). */
 #if configUSE_TIMERS == 1
 
@@ -595,6 +649,10 @@
     #define configUSE_MINI_LIST_ITEM    1
 #endif
 
+#ifndef configUSE_LIST_SEARCH_TREE
+    #define configUSE_LIST_SEARCH_TREE    0
+#endif
+
 #ifndef portPOINTER_SIZE_TYPE
     #define portPOINTER_SIZE_TYPE    uint32_t
 #endif
@@ -1580,6 +1638,38 @@
     #define traceRETURN_xTimerGetPeriod( xTimerPeriodInTicks )
 #endif
 
+#ifndef traceENTER_vTimerSetSlack
+    #define traceENTER_vTimerSetSlack( xTimer, xSlackInTicks )
+#endif
+
+#ifndef traceRETURN_vTimerSetSlack
+    #define traceRETURN_vTimerSetSlack()
+#endif
+
+#ifndef traceENTER_xTimerGetSlack
+    #define traceENTER_xTimerGetSlack( xTimer )
+#endif
+
+#ifndef traceRETURN_xTimerGetSlack
+    #define traceRETURN_xTimerGetSlack( xTimerSlackInTicks )
+#endif
+
+#ifndef traceENTER_vTimerSetCoreID
+    #define traceENTER_vTimerSetCoreID( xTimer, xCoreID )
+#endif
+
+#ifndef traceRETURN_vTimerSetCoreID
+    #define traceRETURN_vTimerSetCoreID()
+#endif
+
+#ifndef traceENTER_xTimerGetCoreID
+    #define traceENTER_xTimerGetCoreID( xTimer )
+#endif
+
+#ifndef traceRETURN_xTimerGetCoreID
+    #define traceRETURN_xTimerGetCoreID( xTimerCoreID )
+#endif
+
 #ifndef traceENTER_vTimerSetReloadMode
     #define traceENTER_vTimerSetReloadMode( xTimer, xAutoReload )
 #endif
@@ -1668,6 +1758,14 @@
     #define traceRETURN_xTimerPendFunctionCall( xReturn )
 #endif
 
+#ifndef traceENTER_uxTimerGetDeferredCallOverflowCount
+    #define traceENTER_uxTimerGetDeferredCallOverflowCount()
+#endif
+
+#ifndef traceRETURN_uxTimerGetDeferredCallOverflowCount
+    #define traceRETURN_uxTimerGetDeferredCallOverflowCount( uxOverflowCount )
+#endif
+
 #ifndef traceENTER_uxTimerGetTimerNumber
     #define traceENTER_uxTimerGetTimerNumber( xTimer )
 #endif
@@ -2096,6 +2194,14 @@
     #define traceRETURN_vTaskRemoveFromUnorderedEventList()
 #endif
 
+#ifndef traceENTER_xTaskRemoveFromUnorderedEventListFromISR
+    #define traceENTER_xTaskRemoveFromUnorderedEventListFromISR( pxEventListItem, xItemValue )
+#endif
+
+#ifndef traceRETURN_xTaskRemoveFromUnorderedEventListFromISR
+    #define traceRETURN_xTaskRemoveFromUnorderedEventListFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_vTaskSetTimeOutState
     #define traceENTER_vTaskSetTimeOutState( pxTimeOut )
 #endif
@@ -2112,6 +2218,22 @@
     #define traceRETURN_vTaskInternalSetTimeOutState()
 #endif
 
+#ifndef traceENTER_pvTaskAllocateFromObjectPool
+    #define traceENTER_pvTaskAllocateFromObjectPool( uxPool )
+#endif
+
+#ifndef traceRETURN_pvTaskAllocateFromObjectPool
+    #define traceRETURN_pvTaskAllocateFromObjectPool( pvObject )
+#endif
+
+#ifndef traceENTER_vTaskReturnToObjectPool
+    #define traceENTER_vTaskReturnToObjectPool( uxPool, pvObject )
+#endif
+
+#ifndef traceRETURN_vTaskReturnToObjectPool
+    #define traceRETURN_vTaskReturnToObjectPool()
+#endif
+
 #ifndef traceENTER_xTaskCheckForTimeOut
     #define traceENTER_xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait )
 #endif
@@ -2312,6 +2434,14 @@
     #define traceRETURN_uxTaskResetEventItemValue( uxReturn )
 #endif
 
+#ifndef traceENTER_uxTaskGetEventListItemValue
+    #define traceENTER_uxTaskGetEventListItemValue( pxEventListItem )
+#endif
+
+#ifndef traceRETURN_uxTaskGetEventListItemValue
+    #define traceRETURN_uxTaskGetEventListItemValue( uxReturn )
+#endif
+
 #ifndef traceENTER_pvTaskIncrementMutexHeldCount
     #define traceENTER_pvTaskIncrementMutexHeldCount()
 #endif
@@ -2830,6 +2960,26 @@
     #define configSUPPORT_DYNAMIC_ALLOCATION    1
 #endif
 
+#ifndef configTASK_POOL_SLAB_LENGTH
+    #define configTASK_POOL_SLAB_LENGTH    0
+#endif
+
+#ifndef configQUEUE_POOL_SLAB_LENGTH
+    #define configQUEUE_POOL_SLAB_LENGTH    0
+#endif
+
+#ifndef configTIMER_POOL_SLAB_LENGTH
+    #define configTIMER_POOL_SLAB_LENGTH    0
+#endif
+
+#ifndef configEVENT_GROUP_POOL_SLAB_LENGTH
+    #define configEVENT_GROUP_POOL_SLAB_LENGTH    0
+#endif
+
+#if ( ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) && ( ( configTASK_POOL_SLAB_LENGTH > 0 ) || ( configQUEUE_POOL_SLAB_LENGTH > 0 ) || ( configTIMER_POOL_SLAB_LENGTH > 0 ) || ( configEVENT_GROUP_POOL_SLAB_LENGTH > 0 ) ) )
+    #error The object pools are refilled from the heap, so cannot be used without dynamic allocation, but configSUPPORT_DYNAMIC_ALLOCATION is not set to 1.
+#endif
+
 #if ( ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
     #error configUSE_STATS_FORMATTING_FUNCTIONS cannot be used without dynamic allocation, but configSUPPORT_DYNAMIC_ALLOCATION is not set to 1.
 #endif
@@ -2896,6 +3046,14 @@
     #error configUSE_PORT_OPTIMISED_TASK_SELECTION is not supported in SMP FreeRTOS
 #endif
 
+#if ( ( configUSE_TIMER_SERVICE_TASK_PER_CORE != 0 ) && ( ( configNUMBER_OF_CORES == 1 ) || ( configUSE_CORE_AFFINITY == 0 ) ) )
+    #error configUSE_TIMER_SERVICE_TASK_PER_CORE requires configNUMBER_OF_CORES to be greater than 1 and configUSE_CORE_AFFINITY to be set to 1
+#endif
+
+#if ( ( configUSE_64_BIT_EVENT_GROUPS == 1 ) && ( portUSING_MPU_WRAPPERS == 1 ) )
+    #error configUSE_64_BIT_EVENT_GROUPS is not supported by the MPU ports as their system call wrappers do not pass 64-bit parameters
+#endif
+
 #ifndef configINITIAL_TICK_COUNT
     #define configINITIAL_TICK_COUNT    0
 #endif
@@ -3113,6 +3271,10 @@ struct xSTATIC_LIST_ITEM
     #endif
     TickType_t xDummy2;
     void * pvDummy3[ 4 ];
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+        void * pvDummy5[ 3 ];
+        UBaseType_t uxDummy6;
+    #endif
     #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
         TickType_t xDummy4;
     #endif
@@ -3143,6 +3305,9 @@ typedef struct xSTATIC_LIST
     UBaseType_t uxDummy2;
     void * pvDummy3;
     StaticMiniListItem_t xDummy4;
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+        void * pvDummy6;
+    #endif
     #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
         TickType_t xDummy5;
     #endif
@@ -3219,6 +3384,9 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t uxDummy27;
+    #endif
 } StaticTask_t;
 
 /*
@@ -3280,7 +3448,11 @@ typedef StaticQueue_t StaticSemaphore_t;
  */
 typedef struct xSTATIC_EVENT_GROUP
 {
-    TickType_t xDummy1;
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t xDummy1[ 2 ];
+    #else
+        TickType_t xDummy1[ 2 ];
+    #endif
     StaticList_t xDummy2;
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -3311,11 +3483,18 @@ typedef struct xSTATIC_TIMER
     void * pvDummy1;
     StaticListItem_t xDummy2;
     TickType_t xDummy3;
+    #if ( configUSE_TIMER_SLACK == 1 )
+        TickType_t xDummy4;
+    #endif
     void * pvDummy5;
     TaskFunction_t pvDummy6;
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy7;
     #endif
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+        BaseType_t xDummy9[ 2 ];
+        UBaseType_t uxDummy10;
+    #endif
     uint8_t ucDummy8;
 } StaticTimer_t;
 
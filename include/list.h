@@ -149,6 +149,11 @@ struct xLIST_ITEM
     struct xLIST_ITEM * configLIST_VOLATILE pxPrevious; /**< Pointer to the previous ListItem_t in the list. */
     void * pvOwner;                                     /**< Pointer to the object (normally a TCB) that contains the list item.  There is therefore a two way link between the object containing the list item and the list item itself. */
     struct xLIST * configLIST_VOLATILE pxContainer;     /**< Pointer to the list in which this list item is placed (if any). */
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+        struct xLIST_ITEM * configLIST_VOLATILE pxTreeParent;      /**< Parent of the item in the red-black tree that indexes items inserted with vListInsert(). */
+        struct xLIST_ITEM * configLIST_VOLATILE pxTreeChild[ 2 ]; /**< Left and right children of the item in the tree. */
+        UBaseType_t uxTreeColour;                                 /**< Colour of the item in the tree, or 0 if the item is not in a tree. */
+    #endif
     listSECOND_LIST_ITEM_INTEGRITY_CHECK_VALUE          /**< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 };
 typedef struct xLIST_ITEM ListItem_t;
@@ -175,6 +180,9 @@ typedef struct xLIST
     configLIST_VOLATILE UBaseType_t uxNumberOfItems;
     ListItem_t * configLIST_VOLATILE pxIndex; /**< Used to walk through the list.  Points to the last item returned by a call to listGET_OWNER_OF_NEXT_ENTRY (). */
     MiniListItem_t xListEnd;                  /**< List item that contains the maximum possible item value meaning it is always at the end of the list and is therefore used as a marker. */
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+        ListItem_t * configLIST_VOLATILE pxTreeRoot; /**< Root of the red-black tree that vListInsert() searches, or NULL if it is empty. */
+    #endif
     listSECOND_LIST_INTEGRITY_CHECK_VALUE     /**< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 } List_t;
 
@@ -319,7 +327,13 @@ typedef struct xLIST
  * \page listREMOVE_ITEM listREMOVE_ITEM
  * \ingroup LinkedList
  */
-#define listREMOVE_ITEM( pxItemToRemove ) \
+#if ( configUSE_LIST_SEARCH_TREE == 1 )
+
+/* Items that are in the search tree must be removed from it too, which is
+ * too much to inline. */
+    #define listREMOVE_ITEM( pxItemToRemove )    ( ( void ) uxListRemove( pxItemToRemove ) )
+#else
+    #define listREMOVE_ITEM( pxItemToRemove ) \
     do {                                  \
         /* The list item knows which list it is in.  Obtain the list from the list \
          * item. */                                                                                 \
@@ -336,6 +350,7 @@ typedef struct xLIST
         ( pxItemToRemove )->pxContainer = NULL;                                                     \
         ( ( pxList )->uxNumberOfItems ) = ( UBaseType_t ) ( ( ( pxList )->uxNumberOfItems ) - 1U ); \
     } while( 0 )
+#endif /* if ( configUSE_LIST_SEARCH_TREE == 1 ) */
 
 /*
  * Inline version of vListInsertEnd() to provide slight optimisation for
@@ -384,6 +399,41 @@ typedef struct xLIST
         ( ( pxList )->uxNumberOfItems ) = ( UBaseType_t ) ( ( ( pxList )->uxNumberOfItems ) + 1U ); \
     } while( 0 )
 
+/*
+ * Move a list item to the end of the list that contains it, so it becomes the
+ * last item found when walking the list from its head.  Does nothing if it is
+ * already the last item.  Cheaper than removing the item and inserting it
+ * again, as the list it is in and the number of items do not change.
+ *
+ * The end is the end marker rather than pxIndex, so this is only for lists
+ * that are not walked with listGET_OWNER_OF_NEXT_ENTRY(), and not for items
+ * inserted with vListInsert().
+ *
+ * @param pxListItem The list item to be moved.
+ *
+ * \page listMOVE_TO_END listMOVE_TO_END
+ * \ingroup LinkedList
+ */
+#define listMOVE_TO_END( pxListItem )                                                           \
+    do {                                                                                        \
+        ListItem_t * const pxMoveItem = ( pxListItem );                                         \
+        ListItem_t * const pxMoveEnd = ( ListItem_t * ) &( pxMoveItem->pxContainer->xListEnd ); \
+                                                                                                \
+        listTEST_LIST_INTEGRITY( pxMoveItem->pxContainer );                                     \
+        listTEST_LIST_ITEM_INTEGRITY( pxMoveItem );                                             \
+                                                                                                \
+        if( pxMoveItem->pxNext != pxMoveEnd )                                                   \
+        {                                                                                       \
+            pxMoveItem->pxNext->pxPrevious = pxMoveItem->pxPrevious;                            \
+            pxMoveItem->pxPrevious->pxNext = pxMoveItem->pxNext;                                \
+                                                                                                \
+            pxMoveItem->pxNext = pxMoveEnd;                                                     \
+            pxMoveItem->pxPrevious = pxMoveEnd->pxPrevious;                                     \
+            pxMoveEnd->pxPrevious->pxNext = pxMoveItem;                                         \
+            pxMoveEnd->pxPrevious = pxMoveItem;                                                 \
+        }                                                                                       \
+    } while( 0 )
+
 /*
  * Access function to obtain the owner of the first entry in a list.  Lists
  * are normally sorted in ascending item value order.
@@ -455,6 +505,10 @@ void vListInitialiseItem( ListItem_t * const pxItem ) PRIVILEGED_FUNCTION;
  * Insert a list item into a list.  The item will be inserted into the list in
  * a position determined by its item value (ascending item value order).
  *
+ * When configUSE_LIST_SEARCH_TREE is set to 1 the position is found in
+ * O(log n) time by searching a red-black tree of the items that were inserted
+ * with vListInsert(), rather than by walking the list from its head.
+ *
  * @param pxList The list into which the item is to be inserted.
  *
  * @param pxNewListItem The item that is to be placed in the list.
@@ -102,6 +102,18 @@
     #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP    0
 #endif
 
+#ifndef configHEAP_INSTRUMENTATION
+    #define configHEAP_INSTRUMENTATION    0
+#endif
+
+#ifndef configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS
+    #define configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS    16
+#endif
+
+#ifndef configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS
+    #define configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS    8
+#endif
+
 #include "mpu_wrappers.h"
 
 /* *INDENT-OFF* */
@@ -155,18 +167,46 @@ typedef struct HeapRegion
 /* Used to pass information about the heap out of vPortGetHeapStats(). */
 typedef struct xHeapStats
 {
-    size_t xAvailableHeapSpaceInBytes;      /* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
-    size_t xSizeOfLargestFreeBlockInBytes;  /* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
-    size_t xSizeOfSmallestFreeBlockInBytes; /* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
-    size_t xNumberOfFreeBlocks;             /* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
-    size_t xMinimumEverFreeBytesRemaining;  /* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
-    size_t xNumberOfSuccessfulAllocations;  /* The number of calls to pvPortMalloc() that have returned a valid memory block. */
-    size_t xNumberOfSuccessfulFrees;        /* The number of calls to vPortFree() that has successfully freed a block of memory. */
+    size_t xAvailableHeapSpaceInBytes;        /* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
+    size_t xSizeOfLargestFreeBlockInBytes;    /* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xSizeOfSmallestFreeBlockInBytes;   /* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xNumberOfFreeBlocks;               /* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
+    size_t xMinimumEverFreeBytesRemaining;    /* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
+    size_t xNumberOfSuccessfulAllocations;    /* The number of calls to pvPortMalloc() that have returned a valid memory block. */
+    size_t xNumberOfSuccessfulFrees;          /* The number of calls to vPortFree() that has successfully freed a block of memory. */
+    size_t xNumberOfFreeISRBlocks;            /* The number of blocks currently available to pvPortMallocFromISR().  Always 0 if configISR_HEAP_NUMBER_OF_BLOCKS is 0. */
+    size_t xMinimumEverFreeISRBlocks;         /* The minimum number of blocks there have been available to pvPortMallocFromISR() since the system booted. */
+    size_t xNumberOfSuccessfulISRAllocations; /* The number of calls to pvPortMallocFromISR() that have returned a valid memory block. */
+    size_t xNumberOfSuccessfulISRFrees;       /* The number of calls to vPortFreeFromISR() that have successfully freed a block of memory. */
 } HeapStats_t;
 
+/* Used to pass the allocations counted against one task or call site out of
+ * vPortGetHeapInstrumentation(). */
+typedef struct xHeapAllocationCounter
+{
+    void * pvKey;                      /* The value configHEAP_INSTRUMENTATION_GET_KEY() returned when the allocations were made - by default the handle of the calling task. */
+    size_t xNumberOfAllocations;       /* The number of allocations made with this key that returned a valid memory block. */
+    size_t xNumberOfFailedAllocations; /* The number of allocations made with this key that returned NULL. */
+    size_t xBytesAllocated;            /* The total number of bytes requested by the allocations made with this key that returned a valid memory block. */
+} HeapAllocationCounter_t;
+
+/* Used to pass information about heap fragmentation and allocation latency out
+ * of vPortGetHeapInstrumentation(). */
+typedef struct xHeapInstrumentation
+{
+    size_t xFreeBlockHistogram[ configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS ]; /* Entry n holds the number of free blocks of at least ( 16 << n ) bytes and less than ( 32 << n ) bytes at the time vPortGetHeapInstrumentation() is called.  The first entry also counts smaller blocks and the last entry also counts larger blocks. */
+    uint32_t ulMinimumAllocationTime;                                          /* The shortest time an allocation has held the heap locked, in the units of configHEAP_INSTRUMENTATION_GET_TIME(). */
+    uint32_t ulMaximumAllocationTime;                                          /* The longest time an allocation has held the heap locked. */
+    uint32_t ulAverageAllocationTime;                                          /* The average time an allocation has held the heap locked. */
+    size_t xNumberOfTimedAllocations;                                          /* The number of allocations the above times were measured over.  Allocations satisfied from a per-core cache do not lock the heap so are not timed. */
+    size_t xNumberOfUntrackedAllocations;                                      /* The number of allocations not counted in xAllocationCounters[] because the table was already full when they were made. */
+    size_t xNumberOfAllocationCounters;                                        /* The number of valid entries in xAllocationCounters[]. */
+    HeapAllocationCounter_t xAllocationCounters[ configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS ];
+} HeapInstrumentation_t;
+
 /*
- * Used to define multiple heap regions for use by heap_5.c.  This function
- * must be called before any calls to pvPortMalloc() - not creating a task,
+ * Used to define multiple heap regions for use by heap_5.c and heap_6.c.  This
+ * function must be called before any calls to pvPortMalloc() - not creating a task,
  * queue, semaphore, mutex, software timer, event group, etc. will result in
  * pvPortMalloc being called.
  *
@@ -177,12 +217,43 @@ typedef struct xHeapStats
  */
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
 
+/*
+ * As vPortDefineHeapRegions(), but also gives each region application defined
+ * flags that pvPortMallocFromRegions() uses to select the regions an
+ * allocation can be placed in.  puxRegionFlags[ n ] holds the flags of the
+ * region defined by pxHeapRegions[ n ].  Regions defined with
+ * vPortDefineHeapRegions() have no flags set.  Provided by heap_5.c.
+ */
+void vPortDefineHeapRegionsWithFlags( const HeapRegion_t * const pxHeapRegions,
+                                      const UBaseType_t * const puxRegionFlags ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate memory only from the heap regions whose flags have every bit set
+ * that is set in uxRegionFlags.  The regions are tried in address order.
+ * Provided by heap_5.c.
+ */
+void * pvPortMallocFromRegions( size_t xWantedSize,
+                                UBaseType_t uxRegionFlags ) PRIVILEGED_FUNCTION;
+
 /*
  * Returns a HeapStats_t structure filled with information about the current
  * heap state.
  */
 void vPortGetHeapStats( HeapStats_t * pxHeapStats );
 
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/*
+ * Returns a HeapInstrumentation_t structure filled with a histogram of the
+ * sizes of the free blocks, the allocations counted against each task or call
+ * site, and the time allocations have held the heap locked since the system
+ * booted or vPortResetHeapInstrumentation() was last called.  Provided by
+ * heap_4.c and heap_5.c.
+ */
+    void vPortGetHeapInstrumentation( HeapInstrumentation_t * pxHeapInstrumentation );
+    void vPortResetHeapInstrumentation( void );
+#endif
+
 /*
  * Map to the memory management routines required for the port.
  */
@@ -190,11 +261,33 @@ void * pvPortMalloc( size_t xWantedSize ) PRIVILEGED_FUNCTION;
 void * pvPortCalloc( size_t xNum,
                      size_t xSize ) PRIVILEGED_FUNCTION;
 void vPortFree( void * pv ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate memory aligned to xAlignment bytes, which must be a power of two,
+ * and change the size of a block of allocated memory.  pvPortRealloc() resizes
+ * the block in place if it is shrinking or if the memory that follows it is
+ * free, otherwise it moves the block.  Provided by heap_4.c and heap_5.c.
+ */
+void * pvPortMallocAligned( size_t xWantedSize,
+                            size_t xAlignment ) PRIVILEGED_FUNCTION;
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize ) PRIVILEGED_FUNCTION;
 void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 void xPortResetHeapMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Allocate and free fixed size blocks of configISR_HEAP_BLOCK_SIZE bytes from
+ * a pool of configISR_HEAP_NUMBER_OF_BLOCKS blocks that is separate from the
+ * heap.  The pool is accessed with interrupts masked, so these functions can
+ * be called from both tasks and interrupts, and take a constant time.  Blocks
+ * allocated by pvPortMallocFromISR() must be freed by vPortFreeFromISR().
+ * Provided by heap_4.c, heap_5.c and heap_6.c.
+ */
+void * pvPortMallocFromISR( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vPortFreeFromISR( void * pv ) PRIVILEGED_FUNCTION;
+
 #if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
     void * pvPortMallocStack( size_t xSize ) PRIVILEGED_FUNCTION;
     void vPortFreeStack( void * pv ) PRIVILEGED_FUNCTION;
@@ -122,6 +122,18 @@ typedef enum
     eSetValueWithoutOverwrite /* Set the task's notification value if the previous value has been read by the task. */
 } eNotifyAction;
 
+/*
+ * Used internally only.  The type of the value stored with a task that is
+ * blocked on an unordered event list, which is used by event groups to hold
+ * the event bits.  It matches TickType_t unless configUSE_64_BIT_EVENT_GROUPS
+ * is set to 1.
+ */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    typedef uint64_t     EventItemValue_t;
+#else
+    typedef TickType_t   EventItemValue_t;
+#endif
+
 /*
  * Used internally only.
  */
@@ -3534,7 +3546,7 @@ BaseType_t xTaskIncrementTick( void ) PRIVILEGED_FUNCTION;
 void vTaskPlaceOnEventList( List_t * const pxEventList,
                             const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
-                                     const TickType_t xItemValue,
+                                     const EventItemValue_t xItemValue,
                                      const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
 /*
@@ -3578,7 +3590,28 @@ void vTaskPlaceOnEventListRestricted( List_t * const pxEventList,
  */
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
-                                        const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+                                        const EventItemValue_t xItemValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
+ * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be called
+ * from a critical section within an ISR.
+ *
+ * This function performs the same function as
+ * vTaskRemoveFromUnorderedEventList() but does not require the scheduler to be
+ * suspended.  If the scheduler is suspended the unblocked task is held on the
+ * pending ready list until the scheduler is resumed.  It is used by event
+ * groups when configUSE_EVENT_GROUP_DIRECT_FROM_ISR is set to 1.
+ *
+ * @return pdTRUE if the task being removed has a higher priority than the task
+ * making the call, otherwise pdFALSE.
+ */
+#if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 )
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const EventItemValue_t xItemValue ) PRIVILEGED_FUNCTION;
+#endif
 
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
@@ -3598,7 +3631,11 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
  * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
  * THE EVENT BITS MODULE.
  */
-TickType_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
+EventItemValue_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    EventItemValue_t uxTaskGetEventListItemValue( const ListItem_t * pxEventListItem ) PRIVILEGED_FUNCTION;
+#endif
 
 /*
  * Return the handle of the calling task.
@@ -3703,6 +3740,28 @@ TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Identifies the pool used by pvTaskAllocateFromObjectPool()
+ * and vTaskReturnToObjectPool().
+ */
+#define tskTCB_OBJECT_POOL            ( ( UBaseType_t ) 0U )
+#define tskQUEUE_OBJECT_POOL          ( ( UBaseType_t ) 1U )
+#define tskTIMER_OBJECT_POOL          ( ( UBaseType_t ) 2U )
+#define tskEVENT_GROUP_OBJECT_POOL    ( ( UBaseType_t ) 3U )
+
+/*
+ * For internal use only.  Take a kernel object from a pool of objects of the
+ * same type, first refilling the pool from the heap with a slab of
+ * config[TASK|QUEUE|TIMER|EVENT_GROUP]_POOL_SLAB_LENGTH objects if it is
+ * empty.  Objects returned to the pool with vTaskReturnToObjectPool() are
+ * reused, and the slabs are never returned to the heap.
+ */
+#if ( ( configTASK_POOL_SLAB_LENGTH > 0 ) || ( configQUEUE_POOL_SLAB_LENGTH > 0 ) || ( configTIMER_POOL_SLAB_LENGTH > 0 ) || ( configEVENT_GROUP_POOL_SLAB_LENGTH > 0 ) )
+    void * pvTaskAllocateFromObjectPool( UBaseType_t uxPool ) PRIVILEGED_FUNCTION;
+    void vTaskReturnToObjectPool( UBaseType_t uxPool,
+                                  void * pvObject ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * For internal use only. Same as portYIELD_WITHIN_API() in single core FreeRTOS.
  * For SMP this is not defined by the port.
@@ -67,6 +67,9 @@
 #define tmrCOMMAND_STOP_FROM_ISR                ( ( BaseType_t ) 8 )
 #define tmrCOMMAND_CHANGE_PERIOD_FROM_ISR       ( ( BaseType_t ) 9 )
 
+/* Passed to vTimerSetCoreID() to have a timer processed by the timer service
+ * task of the core from which it is started, rather than of a fixed core. */
+#define tmrFOLLOW_CALLING_CORE                  ( ( BaseType_t ) -1 )
 
 /**
  * Type by which software timers are referenced.  For example, a call to
@@ -451,6 +454,8 @@ BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  *
  * Simply returns the handle of the timer service/daemon task.  It it not valid
  * to call xTimerGetTimerDaemonTaskHandle() before the scheduler has been started.
+ * If configUSE_TIMER_SERVICE_TASK_PER_CORE is set to 1 then the handle of the
+ * timer service task of core 0 is returned.
  */
 TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
 
@@ -1133,6 +1138,14 @@ TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
  * allows the callback function to execute contiguously in time with the
  * interrupt - just as if the callback had executed in the interrupt itself.
  *
+ * If configTIMER_DEFERRED_CALL_RING_LENGTH is greater than 0 the function is
+ * written to a ring of that length that belongs to the core on which the
+ * interrupt executes, rather than being sent on the timer queue, and all the
+ * functions in the ring are executed each time the daemon task runs.  A message
+ * is only sent to the daemon task when the ring was empty.  If the ring is full
+ * the call fails, and the failure is counted (see
+ * uxTimerGetDeferredCallOverflowCount()).
+ *
  * @param xFunctionToPend The function to execute from the timer service/
  * daemon task.  The function must conform to the PendedFunction_t
  * prototype.
@@ -1245,6 +1258,23 @@ TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
                                        TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 #endif
 
+/**
+ * UBaseType_t uxTimerGetDeferredCallOverflowCount( void );
+ *
+ * Returns the number of times xTimerPendFunctionCallFromISR() failed because
+ * the deferred call ring was full.  A non-zero value indicates that
+ * configTIMER_DEFERRED_CALL_RING_LENGTH is too small for the rate at which
+ * interrupts pend functions.
+ *
+ * configTIMER_DEFERRED_CALL_RING_LENGTH must be greater than 0 for this
+ * function to be available.
+ *
+ * @return The total number of deferred call ring overflows on all cores.
+ */
+#if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+    UBaseType_t uxTimerGetDeferredCallOverflowCount( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * const char * const pcTimerGetName( TimerHandle_t xTimer );
  *
@@ -1313,6 +1343,87 @@ UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+/**
+ * void vTimerSetSlack( TimerHandle_t xTimer, const TickType_t xSlackInTicks );
+ *
+ * configUSE_TIMER_SLACK must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * Sets the number of ticks by which the timer service task may delay
+ * processing a timer after its expiry time.  The timer service task uses the
+ * slack to process timers that expire close together in one wake up instead of
+ * waking for each timer, which also lets tickless idle sleep for longer.  The
+ * slack does not change the expiry time itself, so an auto-reload timer does
+ * not drift.  Timers are created with a slack of configTIMER_DEFAULT_SLACK
+ * ticks.
+ *
+ * @param xTimer The handle of the timer being updated.
+ *
+ * @param xSlackInTicks The maximum number of ticks that the processing of the
+ * timer may be delayed.  0 means the timer is processed at its expiry time.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    void vTimerSetSlack( TimerHandle_t xTimer,
+                         const TickType_t xSlackInTicks ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * TickType_t xTimerGetSlack( TimerHandle_t xTimer );
+ *
+ * configUSE_TIMER_SLACK must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * Returns the slack of a timer, as set by vTimerSetSlack().
+ *
+ * @param xTimer The handle of the timer being queried.
+ *
+ * @return The slack of the timer in ticks.
+ */
+#if ( configUSE_TIMER_SLACK == 1 )
+    TickType_t xTimerGetSlack( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * void vTimerSetCoreID( TimerHandle_t xTimer, const BaseType_t xCoreID );
+ *
+ * configUSE_TIMER_SERVICE_TASK_PER_CORE must be set to 1 in FreeRTOSConfig.h
+ * for this function to be available.
+ *
+ * Binds a timer to the timer service task of a core.  The callback of the timer
+ * then executes in the timer service task of that core.  Timers are created
+ * with a core ID of tmrFOLLOW_CALLING_CORE, which moves the timer to the timer
+ * service task of the core from which it is started.  A timer only moves to
+ * another timer service task when a command is sent to it while it is dormant
+ * and no other commands for it are waiting to be processed, so commands are
+ * always processed in the order in which they were sent.
+ *
+ * @param xTimer The handle of the timer being updated.
+ *
+ * @param xCoreID The core whose timer service task processes the timer, or
+ * tmrFOLLOW_CALLING_CORE.
+ */
+#if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+    void vTimerSetCoreID( TimerHandle_t xTimer,
+                          const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xTimerGetCoreID( TimerHandle_t xTimer );
+ *
+ * configUSE_TIMER_SERVICE_TASK_PER_CORE must be set to 1 in FreeRTOSConfig.h
+ * for this function to be available.
+ *
+ * Returns the core ID of a timer, as set by vTimerSetCoreID().
+ *
+ * @param xTimer The handle of the timer being queried.
+ *
+ * @return The core whose timer service task processes the timer, or
+ * tmrFOLLOW_CALLING_CORE.
+ */
+#if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+    BaseType_t xTimerGetCoreID( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer );
  *
@@ -1401,6 +1512,30 @@ BaseType_t xTimerGenericCommandFromISR( TimerHandle_t xTimer,
                                          StackType_t ** ppxTimerTaskStackBuffer,
                                          configSTACK_DEPTH_TYPE * puxTimerTaskStackSize );
 
+/**
+ * task.h
+ * @code{c}
+ * void vApplicationGetPerCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer, StackType_t ** ppxTimerTaskStackBuffer, configSTACK_DEPTH_TYPE * puxTimerTaskStackSize, BaseType_t xTimerTaskIndex )
+ * @endcode
+ *
+ * This function is used to provide statically allocated blocks of memory to FreeRTOS to hold the TCBs of the
+ * additional timer service tasks created when configUSE_TIMER_SERVICE_TASK_PER_CORE is set to 1.  The memory of
+ * the timer service task of core 0 is obtained from vApplicationGetTimerTaskMemory(), and this function is called
+ * with timer task index 0, 1 ... ( configNUMBER_OF_CORES - 2 ) to get the memory of the timer service tasks of
+ * cores 1, 2 ... ( configNUMBER_OF_CORES - 1 ).
+ *
+ * @param ppxTimerTaskTCBBuffer   A handle to a statically allocated TCB buffer
+ * @param ppxTimerTaskStackBuffer A handle to a statically allocated Stack buffer for the timer task
+ * @param puxTimerTaskStackSize   A pointer to the number of elements that will fit in the allocated stack buffer
+ * @param xTimerTaskIndex         The index of the timer task buffer
+ */
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+        void vApplicationGetPerCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                                    StackType_t ** ppxTimerTaskStackBuffer,
+                                                    configSTACK_DEPTH_TYPE * puxTimerTaskStackSize,
+                                                    BaseType_t xTimerTaskIndex );
+    #endif
+
 #endif
 
 #if ( configUSE_DAEMON_TASK_STARTUP_HOOK != 0 )
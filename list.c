@@ -42,6 +42,55 @@
  * generate the correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+#if ( configUSE_LIST_SEARCH_TREE == 1 )
+
+/* Colours of the nodes of the red-black tree that indexes the items inserted
+ * with vListInsert().  Items that are not in a tree are listTREE_NONE. */
+    #define listTREE_NONE     ( ( UBaseType_t ) 0U )
+    #define listTREE_RED      ( ( UBaseType_t ) 1U )
+    #define listTREE_BLACK    ( ( UBaseType_t ) 2U )
+
+/* Indexes into pxTreeChild[]. */
+    #define listTREE_LEFT     ( ( UBaseType_t ) 0U )
+    #define listTREE_RIGHT    ( ( UBaseType_t ) 1U )
+
+/*
+ * Returns the colour of a tree node, treating the NULL leaves as black.
+ */
+    static UBaseType_t prvTreeColour( const ListItem_t * const pxNode ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes pxNew the child of pxParent in place of pxOld, or the root of the tree
+ * if pxParent is NULL.
+ */
+    static void prvTreeReplaceChild( List_t * const pxList,
+                                     ListItem_t * const pxParent,
+                                     const ListItem_t * const pxOld,
+                                     ListItem_t * const pxNew ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves pxNode down in the direction uxDirection, replacing it with its child
+ * on the other side.
+ */
+    static void prvTreeRotate( List_t * const pxList,
+                               ListItem_t * const pxNode,
+                               const UBaseType_t uxDirection ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds pxNewListItem to the tree after any items with the same item value, and
+ * returns the list item it must be placed after in the list.
+ */
+    static ListItem_t * prvTreeInsert( List_t * const pxList,
+                                       ListItem_t * const pxNewListItem ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes pxItemToRemove from the tree.
+ */
+    static void prvTreeRemove( List_t * const pxList,
+                               ListItem_t * const pxItemToRemove ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_LIST_SEARCH_TREE */
+
 /*-----------------------------------------------------------
 * PUBLIC LIST API documented in list.h
 *----------------------------------------------------------*/
@@ -77,6 +126,12 @@ void vListInitialise( List_t * const pxList )
 
     pxList->uxNumberOfItems = ( UBaseType_t ) 0U;
 
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+    {
+        pxList->pxTreeRoot = NULL;
+    }
+    #endif
+
     /* Write known values into the list if
      * configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
     listSET_LIST_INTEGRITY_CHECK_1_VALUE( pxList );
@@ -93,6 +148,12 @@ void vListInitialiseItem( ListItem_t * const pxItem )
     /* Make sure the list item is not recorded as being on a list. */
     pxItem->pxContainer = NULL;
 
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+    {
+        pxItem->uxTreeColour = listTREE_NONE;
+    }
+    #endif
+
     /* Write known values into the list item if
      * configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
     listSET_FIRST_LIST_ITEM_INTEGRITY_CHECK_VALUE( pxItem );
@@ -140,7 +201,6 @@ void vListInsert( List_t * const pxList,
                   ListItem_t * const pxNewListItem )
 {
     ListItem_t * pxIterator;
-    const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
 
     traceENTER_vListInsert( pxList, pxNewListItem );
 
@@ -150,53 +210,66 @@ void vListInsert( List_t * const pxList,
     listTEST_LIST_INTEGRITY( pxList );
     listTEST_LIST_ITEM_INTEGRITY( pxNewListItem );
 
-    /* Insert the new list item into the list, sorted in xItemValue order.
-     *
-     * If the list already contains a list item with the same item value then the
-     * new list item should be placed after it.  This ensures that TCBs which are
-     * stored in ready lists (all of which have the same xItemValue value) get a
-     * share of the CPU.  However, if the xItemValue is the same as the back marker
-     * the iteration loop below will not end.  Therefore the value is checked
-     * first, and the algorithm slightly modified if necessary. */
-    if( xValueOfInsertion == portMAX_DELAY )
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
     {
-        pxIterator = pxList->xListEnd.pxPrevious;
+        /* Items with the same item value are placed in the order they were
+         * inserted, as below, but the position is found by descending the
+         * tree rather than by walking the list. */
+        pxIterator = prvTreeInsert( pxList, pxNewListItem );
     }
-    else
+    #else /* configUSE_LIST_SEARCH_TREE */
     {
-        /* *** NOTE ***********************************************************
-        *  If you find your application is crashing here then likely causes are
-        *  listed below.  In addition see https://www.freertos.org/Why-FreeRTOS/FAQs for
-        *  more tips, and ensure configASSERT() is defined!
-        *  https://www.FreeRTOS.org/a00110.html#configASSERT
-        *
-        *   1) Stack overflow -
-        *      see https://www.FreeRTOS.org/Stacks-and-stack-overflow-checking.html
-        *   2) Incorrect interrupt priority assignment, especially on Cortex-M
-        *      parts where numerically high priority values denote low actual
-        *      interrupt priorities, which can seem counter intuitive.  See
-        *      https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html and the definition
-        *      of configMAX_SYSCALL_INTERRUPT_PRIORITY on
-        *      https://www.FreeRTOS.org/a00110.html
-        *   3) Calling an API function from within a critical section or when
-        *      the scheduler is suspended, or calling an API function that does
-        *      not end in "FromISR" from an interrupt.
-        *   4) Using a queue or semaphore before it has been initialised or
-        *      before the scheduler has been started (are interrupts firing
-        *      before vTaskStartScheduler() has been called?).
-        *   5) If the FreeRTOS port supports interrupt nesting then ensure that
-        *      the priority of the tick interrupt is at or below
-        *      configMAX_SYSCALL_INTERRUPT_PRIORITY.
-        **********************************************************************/
-
-        for( pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); pxIterator->pxNext->xItemValue <= xValueOfInsertion; pxIterator = pxIterator->pxNext )
-        {
-            /* There is nothing to do here, just iterating to the wanted
-             * insertion position.
-             * IF YOU FIND YOUR CODE STUCK HERE, SEE THE NOTE JUST ABOVE.
-             */
+        const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
+
+        /* Insert the new list item into the list, sorted in xItemValue order.
+         *
+         * If the list already contains a list item with the same item value then the
+         * new list item should be placed after it.  This ensures that TCBs which are
+         * stored in ready lists (all of which have the same xItemValue value) get a
+         * share of the CPU.  However, if the xItemValue is the same as the back marker
+         * the iteration loop below will not end.  Therefore the value is checked
+         * first, and the algorithm slightly modified if necessary. */
+        if( xValueOfInsertion == portMAX_DELAY )
+        {
+            pxIterator = pxList->xListEnd.pxPrevious;
+        }
+        else
+        {
+            /* *** NOTE ***********************************************************
+            *  If you find your application is crashing here then likely causes are
+            *  listed below.  In addition see https://www.freertos.org/Why-FreeRTOS/FAQs for
+            *  more tips, and ensure configASSERT() is defined!
+            *  https://www.FreeRTOS.org/a00110.html#configASSERT
+            *
+            *   1) Stack overflow -
+            *      see https://www.FreeRTOS.org/Stacks-and-stack-overflow-checking.html
+            *   2) Incorrect interrupt priority assignment, especially on Cortex-M
+            *      parts where numerically high priority values denote low actual
+            *      interrupt priorities, which can seem counter intuitive.  See
+            *      https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html and the definition
+            *      of configMAX_SYSCALL_INTERRUPT_PRIORITY on
+            *      https://www.FreeRTOS.org/a00110.html
+            *   3) Calling an API function from within a critical section or when
+            *      the scheduler is suspended, or calling an API function that does
+            *      not end in "FromISR" from an interrupt.
+            *   4) Using a queue or semaphore before it has been initialised or
+            *      before the scheduler has been started (are interrupts firing
+            *      before vTaskStartScheduler() has been called?).
+            *   5) If the FreeRTOS port supports interrupt nesting then ensure that
+            *      the priority of the tick interrupt is at or below
+            *      configMAX_SYSCALL_INTERRUPT_PRIORITY.
+            **********************************************************************/
+
+            for( pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); pxIterator->pxNext->xItemValue <= xValueOfInsertion; pxIterator = pxIterator->pxNext )
+            {
+                /* There is nothing to do here, just iterating to the wanted
+                 * insertion position.
+                 * IF YOU FIND YOUR CODE STUCK HERE, SEE THE NOTE JUST ABOVE.
+                 */
+            }
         }
     }
+    #endif /* configUSE_LIST_SEARCH_TREE */
 
     pxNewListItem->pxNext = pxIterator->pxNext;
     pxNewListItem->pxNext->pxPrevious = pxNewListItem;
@@ -222,6 +295,19 @@ UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove )
 
     traceENTER_uxListRemove( pxItemToRemove );
 
+    #if ( configUSE_LIST_SEARCH_TREE == 1 )
+    {
+        if( pxItemToRemove->uxTreeColour != listTREE_NONE )
+        {
+            prvTreeRemove( pxList, pxItemToRemove );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif
+
     pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
     pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
 
@@ -246,3 +332,267 @@ UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove )
     return pxList->uxNumberOfItems;
 }
 /*-----------------------------------------------------------*/
+
+#if ( configUSE_LIST_SEARCH_TREE == 1 )
+
+    static UBaseType_t prvTreeColour( const ListItem_t * const pxNode )
+    {
+        UBaseType_t uxColour = listTREE_BLACK;
+
+        if( pxNode != NULL )
+        {
+            uxColour = pxNode->uxTreeColour;
+        }
+
+        return uxColour;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTreeReplaceChild( List_t * const pxList,
+                                     ListItem_t * const pxParent,
+                                     const ListItem_t * const pxOld,
+                                     ListItem_t * const pxNew )
+    {
+        if( pxParent == NULL )
+        {
+            pxList->pxTreeRoot = pxNew;
+        }
+        else if( pxParent->pxTreeChild[ listTREE_LEFT ] == pxOld )
+        {
+            pxParent->pxTreeChild[ listTREE_LEFT ] = pxNew;
+        }
+        else
+        {
+            pxParent->pxTreeChild[ listTREE_RIGHT ] = pxNew;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTreeRotate( List_t * const pxList,
+                               ListItem_t * const pxNode,
+                               const UBaseType_t uxDirection )
+    {
+        const UBaseType_t uxOther = listTREE_RIGHT - uxDirection;
+        ListItem_t * const pxChild = pxNode->pxTreeChild[ uxOther ];
+        ListItem_t * const pxGrandchild = pxChild->pxTreeChild[ uxDirection ];
+
+        pxNode->pxTreeChild[ uxOther ] = pxGrandchild;
+
+        if( pxGrandchild != NULL )
+        {
+            pxGrandchild->pxTreeParent = pxNode;
+        }
+
+        prvTreeReplaceChild( pxList, pxNode->pxTreeParent, pxNode, pxChild );
+        pxChild->pxTreeParent = pxNode->pxTreeParent;
+
+        pxChild->pxTreeChild[ uxDirection ] = pxNode;
+        pxNode->pxTreeParent = pxChild;
+    }
+/*-----------------------------------------------------------*/
+
+    static ListItem_t * prvTreeInsert( List_t * const pxList,
+                                       ListItem_t * const pxNewListItem )
+    {
+        const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
+        ListItem_t * pxIterator;
+        ListItem_t * pxNode = pxList->pxTreeRoot;
+        ListItem_t * pxParent = NULL;
+        ListItem_t * pxGrandparent;
+        ListItem_t * pxUncle;
+        UBaseType_t uxDirection = listTREE_RIGHT;
+
+        /* Items with the same value go to the right, so after the existing
+         * ones in the list. */
+        while( pxNode != NULL )
+        {
+            pxParent = pxNode;
+            uxDirection = ( xValueOfInsertion < pxNode->xItemValue ) ? listTREE_LEFT : listTREE_RIGHT;
+            pxNode = pxNode->pxTreeChild[ uxDirection ];
+        }
+
+        pxNewListItem->pxTreeParent = pxParent;
+        pxNewListItem->pxTreeChild[ listTREE_LEFT ] = NULL;
+        pxNewListItem->pxTreeChild[ listTREE_RIGHT ] = NULL;
+        pxNewListItem->uxTreeColour = listTREE_RED;
+
+        /* The tree is kept in the same order as the list, so the new item's
+         * neighbour in the list is its parent in the tree. */
+        if( pxParent == NULL )
+        {
+            pxList->pxTreeRoot = pxNewListItem;
+            pxIterator = pxList->xListEnd.pxPrevious;
+        }
+        else
+        {
+            pxParent->pxTreeChild[ uxDirection ] = pxNewListItem;
+
+            if( uxDirection == listTREE_RIGHT )
+            {
+                pxIterator = pxParent;
+            }
+            else
+            {
+                pxIterator = pxParent->pxPrevious;
+            }
+        }
+
+        /* Restore the red-black properties, which keep the tree's height
+         * within twice the logarithm of the number of items. */
+        pxNode = pxNewListItem;
+
+        while( ( pxNode->pxTreeParent != NULL ) && ( pxNode->pxTreeParent->uxTreeColour == listTREE_RED ) )
+        {
+            /* A red node is never the root, so the grandparent exists. */
+            pxParent = pxNode->pxTreeParent;
+            pxGrandparent = pxParent->pxTreeParent;
+            uxDirection = ( pxGrandparent->pxTreeChild[ listTREE_LEFT ] == pxParent ) ? listTREE_LEFT : listTREE_RIGHT;
+            pxUncle = pxGrandparent->pxTreeChild[ listTREE_RIGHT - uxDirection ];
+
+            if( prvTreeColour( pxUncle ) == listTREE_RED )
+            {
+                pxParent->uxTreeColour = listTREE_BLACK;
+                pxUncle->uxTreeColour = listTREE_BLACK;
+                pxGrandparent->uxTreeColour = listTREE_RED;
+                pxNode = pxGrandparent;
+            }
+            else
+            {
+                if( pxNode == pxParent->pxTreeChild[ listTREE_RIGHT - uxDirection ] )
+                {
+                    prvTreeRotate( pxList, pxParent, uxDirection );
+                    pxNode = pxParent;
+                    pxParent = pxNode->pxTreeParent;
+                }
+
+                pxParent->uxTreeColour = listTREE_BLACK;
+                pxGrandparent->uxTreeColour = listTREE_RED;
+                prvTreeRotate( pxList, pxGrandparent, listTREE_RIGHT - uxDirection );
+            }
+        }
+
+        pxList->pxTreeRoot->uxTreeColour = listTREE_BLACK;
+
+        return pxIterator;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTreeRemove( List_t * const pxList,
+                               ListItem_t * const pxItemToRemove )
+    {
+        ListItem_t * pxNode;
+        ListItem_t * pxParent;
+        ListItem_t * pxSuccessor;
+        ListItem_t * pxSibling;
+        UBaseType_t uxRemovedColour = pxItemToRemove->uxTreeColour;
+        UBaseType_t uxDirection;
+
+        if( ( pxItemToRemove->pxTreeChild[ listTREE_LEFT ] == NULL ) || ( pxItemToRemove->pxTreeChild[ listTREE_RIGHT ] == NULL ) )
+        {
+            /* Replace the item with its only child, if any. */
+            pxNode = pxItemToRemove->pxTreeChild[ ( pxItemToRemove->pxTreeChild[ listTREE_LEFT ] == NULL ) ? listTREE_RIGHT : listTREE_LEFT ];
+            pxParent = pxItemToRemove->pxTreeParent;
+            prvTreeReplaceChild( pxList, pxParent, pxItemToRemove, pxNode );
+
+            if( pxNode != NULL )
+            {
+                pxNode->pxTreeParent = pxParent;
+            }
+        }
+        else
+        {
+            /* Replace the item with its successor, the leftmost item of its
+             * right subtree, which has no left child. */
+            pxSuccessor = pxItemToRemove->pxTreeChild[ listTREE_RIGHT ];
+
+            while( pxSuccessor->pxTreeChild[ listTREE_LEFT ] != NULL )
+            {
+                pxSuccessor = pxSuccessor->pxTreeChild[ listTREE_LEFT ];
+            }
+
+            uxRemovedColour = pxSuccessor->uxTreeColour;
+            pxNode = pxSuccessor->pxTreeChild[ listTREE_RIGHT ];
+
+            if( pxSuccessor->pxTreeParent == pxItemToRemove )
+            {
+                pxParent = pxSuccessor;
+            }
+            else
+            {
+                pxParent = pxSuccessor->pxTreeParent;
+                pxParent->pxTreeChild[ listTREE_LEFT ] = pxNode;
+
+                if( pxNode != NULL )
+                {
+                    pxNode->pxTreeParent = pxParent;
+                }
+
+                pxSuccessor->pxTreeChild[ listTREE_RIGHT ] = pxItemToRemove->pxTreeChild[ listTREE_RIGHT ];
+                pxSuccessor->pxTreeChild[ listTREE_RIGHT ]->pxTreeParent = pxSuccessor;
+            }
+
+            prvTreeReplaceChild( pxList, pxItemToRemove->pxTreeParent, pxItemToRemove, pxSuccessor );
+            pxSuccessor->pxTreeParent = pxItemToRemove->pxTreeParent;
+            pxSuccessor->pxTreeChild[ listTREE_LEFT ] = pxItemToRemove->pxTreeChild[ listTREE_LEFT ];
+            pxSuccessor->pxTreeChild[ listTREE_LEFT ]->pxTreeParent = pxSuccessor;
+            pxSuccessor->uxTreeColour = pxItemToRemove->uxTreeColour;
+        }
+
+        pxItemToRemove->uxTreeColour = listTREE_NONE;
+
+        /* Removing a black node leaves pxNode's side of pxParent one black
+         * node short, which is made up by recolouring and rotating. */
+        if( uxRemovedColour == listTREE_BLACK )
+        {
+            while( ( pxNode != pxList->pxTreeRoot ) && ( prvTreeColour( pxNode ) == listTREE_BLACK ) )
+            {
+                /* pxNode can be a NULL leaf, but its sibling is not. */
+                uxDirection = ( pxParent->pxTreeChild[ listTREE_LEFT ] == pxNode ) ? listTREE_LEFT : listTREE_RIGHT;
+                pxSibling = pxParent->pxTreeChild[ listTREE_RIGHT - uxDirection ];
+
+                if( pxSibling->uxTreeColour == listTREE_RED )
+                {
+                    pxSibling->uxTreeColour = listTREE_BLACK;
+                    pxParent->uxTreeColour = listTREE_RED;
+                    prvTreeRotate( pxList, pxParent, uxDirection );
+                    pxSibling = pxParent->pxTreeChild[ listTREE_RIGHT - uxDirection ];
+                }
+
+                if( ( prvTreeColour( pxSibling->pxTreeChild[ listTREE_LEFT ] ) == listTREE_BLACK ) &&
+                    ( prvTreeColour( pxSibling->pxTreeChild[ listTREE_RIGHT ] ) == listTREE_BLACK ) )
+                {
+                    pxSibling->uxTreeColour = listTREE_RED;
+                    pxNode = pxParent;
+                    pxParent = pxNode->pxTreeParent;
+                }
+                else
+                {
+                    if( prvTreeColour( pxSibling->pxTreeChild[ listTREE_RIGHT - uxDirection ] ) == listTREE_BLACK )
+                    {
+                        pxSibling->pxTreeChild[ uxDirection ]->uxTreeColour = listTREE_BLACK;
+                        pxSibling->uxTreeColour = listTREE_RED;
+                        prvTreeRotate( pxList, pxSibling, listTREE_RIGHT - uxDirection );
+                        pxSibling = pxParent->pxTreeChild[ listTREE_RIGHT - uxDirection ];
+                    }
+
+                    pxSibling->uxTreeColour = pxParent->uxTreeColour;
+                    pxParent->uxTreeColour = listTREE_BLACK;
+                    pxSibling->pxTreeChild[ listTREE_RIGHT - uxDirection ]->uxTreeColour = listTREE_BLACK;
+                    prvTreeRotate( pxList, pxParent, uxDirection );
+                    pxNode = pxList->pxTreeRoot;
+                }
+            }
+
+            if( pxNode != NULL )
+            {
+                pxNode->uxTreeColour = listTREE_BLACK;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_LIST_SEARCH_TREE */
+/*-----------------------------------------------------------*/
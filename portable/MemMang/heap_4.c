@@ -55,6 +55,45 @@
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
 #endif
 
+/* pvPortMallocFromISR() and vPortFreeFromISR() are implemented by the pool of
+ * fixed size blocks that heap_4.c, heap_5.c and heap_6.c share. */
+#include "heap_isr_pool.h"
+
+#ifndef configHEAP_PER_CORE_CACHE_LENGTH
+    #define configHEAP_PER_CORE_CACHE_LENGTH    0
+#endif
+
+#ifndef configHEAP_PER_CORE_CACHE_SIZE_CLASSES
+    #define configHEAP_PER_CORE_CACHE_SIZE_CLASSES    4
+#endif
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* Allocations are counted against the calling task unless
+ * configHEAP_INSTRUMENTATION_GET_KEY() is defined to return something else,
+ * such as the return address of the function that called pvPortMalloc(). */
+    #ifndef configHEAP_INSTRUMENTATION_GET_KEY
+        #define configHEAP_INSTRUMENTATION_GET_KEY()    ( ( void * ) xTaskGetCurrentTaskHandle() )
+    #endif
+
+/* The time each allocation holds the heap locked is measured using the run
+ * time stats counter unless configHEAP_INSTRUMENTATION_GET_TIME() is defined. */
+    #ifndef configHEAP_INSTRUMENTATION_GET_TIME
+        #ifdef portGET_RUN_TIME_COUNTER_VALUE
+            #define configHEAP_INSTRUMENTATION_GET_TIME()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+        #else
+            #error configHEAP_INSTRUMENTATION is 1 but neither configHEAP_INSTRUMENTATION_GET_TIME nor portGET_RUN_TIME_COUNTER_VALUE is defined.
+        #endif
+    #endif
+
+    #define heapGET_INSTRUMENTATION_KEY()    configHEAP_INSTRUMENTATION_GET_KEY()
+#else
+    #define heapGET_INSTRUMENTATION_KEY()    NULL
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
+/* Small blocks are only cached per core in SMP builds. */
+#define heapUSE_PER_CORE_CACHE    ( ( configHEAP_PER_CORE_CACHE_LENGTH > 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize << 1 ) )
 
@@ -73,6 +112,17 @@
 /* Check if the subtraction operation ( a - b ) will result in underflow. */
 #define heapSUBTRACT_WILL_UNDERFLOW( a, b )    ( ( a ) < ( b ) )
 
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* Entry n of the free block histogram counts blocks of at least
+ * ( 1 << ( heapHISTOGRAM_FIRST_BUCKET_SHIFT + n ) ) bytes. */
+    #define heapHISTOGRAM_FIRST_BUCKET_SHIFT    ( ( size_t ) 4 )
+
+/* Max value that fits in a uint32_t type. */
+    #define heapUINT32_MAX                      ( ( uint32_t ) 0xffffffffUL )
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /* MSB of the xBlockSize member of an BlockLink_t structure is used to track
  * the allocation status of a block.  When MSB of the xBlockSize member of
  * an BlockLink_t structure is set then the block belongs to the application.
@@ -83,6 +133,27 @@
 #define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
 #define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
 
+/* The size, including the BlockLink_t structure, of the allocated block that
+ * holds the memory pv returned to the application. */
+#define heapALLOCATED_BLOCK_SIZE( pv )           ( ( ( const BlockLink_t * ) ( ( ( const uint8_t * ) ( pv ) ) - xHeapStructSize ) )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK )
+
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/* The size, including the BlockLink_t structure, of the blocks held in the
+ * per-core caches for each size class.  Each size class holds blocks twice
+ * the size of the blocks in the size class below it. */
+    #define heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass )    ( heapMINIMUM_BLOCK_SIZE << ( uxSizeClass ) )
+
+/* The number of blocks moved between a per-core cache and the heap each time
+ * the heap is locked to refill or drain the cache. */
+    #define heapCACHE_TRANSFER_COUNT                     ( ( configHEAP_PER_CORE_CACHE_LENGTH + 1 ) / 2 )
+
+/* The pxNextFreeBlock member of a block held in a per-core cache is set to
+ * this value so freeing the block a second time can be caught. */
+    #define heapCACHED_BLOCK_MARKER                      heapPROTECT_BLOCK_POINTER( &xStart )
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
 /*-----------------------------------------------------------*/
 
 /* Allocate the memory for the heap. */
@@ -151,6 +222,87 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEG
  */
 static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * The implementation of pvPortMalloc() and pvPortMallocAligned().  If
+ * configHEAP_INSTRUMENTATION is 1 the allocation is counted against pvKey.
+ */
+static void * prvMallocAligned( size_t xWantedSize,
+                                size_t xAlignment,
+                                void * pvKey ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a block of xWantedSize bytes, including the BlockLink_t structure,
+ * from the list of free blocks.  The memory returned is aligned to xAlignment
+ * bytes.  Must be called with the scheduler suspended.
+ */
+static void * prvAllocateBlock( size_t xWantedSize,
+                                size_t xAlignment ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the size of the block needed to hold xWantedSize bytes, including
+ * the BlockLink_t structure, or 0 if xWantedSize is 0 or too large.
+ */
+static size_t prvGetWantedBlockSize( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of bytes that must be skipped at the start of the free
+ * block pxBlock so the memory returned from it is aligned to xAlignment bytes.
+ */
+static size_t prvGetAlignmentPadding( const BlockLink_t * pxBlock,
+                                      size_t xAlignment ) PRIVILEGED_FUNCTION;
+
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/*
+ * Return the size class of an allocation request or of a block being freed.
+ * configHEAP_PER_CORE_CACHE_SIZE_CLASSES is returned if the request or block
+ * is too large to be cached.
+ */
+    static UBaseType_t prvGetRequestSizeClass( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+    static UBaseType_t prvGetBlockSizeClass( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a block of the given size class from the cache of the calling core,
+ * and counts it as an allocation.  Returns NULL if the cache is empty.
+ */
+    static void * prvTakeFromCache( UBaseType_t uxSizeClass ) PRIVILEGED_FUNCTION;
+
+/*
+ * Places up to heapCACHE_TRANSFER_COUNT blocks of the given size class in the
+ * cache of the calling core.  If the cache is full, heapCACHE_TRANSFER_COUNT
+ * blocks are first drained from the cache back to the heap.  xIsFree is pdTRUE
+ * if the blocks are being freed by the application, rather than moved to the
+ * cache from the heap, so are counted as frees.
+ */
+    static void prvAddToCache( UBaseType_t uxSizeClass,
+                               void * const * ppvBlocks,
+                               UBaseType_t uxNumberOfBlocks,
+                               BaseType_t xIsFree ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns every block held in the caches of all the cores to the heap, and
+ * returns the number of blocks returned.  Must be called with the scheduler
+ * suspended.
+ */
+    static size_t prvFlushCaches( void ) PRIVILEGED_FUNCTION;
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/*
+ * Counts an allocation of xWantedSize bytes, which returned pvReturn, against
+ * pvKey.  If the allocation locked the heap, xHeapWasLocked is pdTRUE and
+ * ulLockedTime is the time the heap was locked for.
+ */
+    static void prvRecordAllocation( void * pvKey,
+                                     size_t xWantedSize,
+                                     const void * pvReturn,
+                                     BaseType_t xHeapWasLocked,
+                                     uint32_t ulLockedTime ) PRIVILEGED_FUNCTION;
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -168,40 +320,112 @@ PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/* Each core caches a few free blocks of each small size class so most small
+ * allocations and frees complete without locking the heap.  Blocks held in a
+ * cache remain marked as allocated, so are not counted as free heap space.
+ * The allocations and frees a cache satisfies are counted in the cache, as
+ * they do not lock the heap, and added to the heap's counts by
+ * vPortGetHeapStats(). */
+    typedef struct HeapCache
+    {
+        UBaseType_t uxNumberOfBlocks[ configHEAP_PER_CORE_CACHE_SIZE_CLASSES ];
+        void * pvBlocks[ configHEAP_PER_CORE_CACHE_SIZE_CLASSES ][ configHEAP_PER_CORE_CACHE_LENGTH ];
+        size_t xNumberOfAllocations;
+        size_t xNumberOfFrees;
+    } HeapCache_t;
+
+    PRIVILEGED_DATA static HeapCache_t xHeapCaches[ configNUMBER_OF_CORES ];
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* The allocations counted against each task or call site, and the time
+ * allocations have held the heap locked, as reported by
+ * vPortGetHeapInstrumentation().  Only accessed from critical sections. */
+    PRIVILEGED_DATA static HeapAllocationCounter_t xAllocationCounters[ configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS ];
+    PRIVILEGED_DATA static size_t xNumberOfAllocationCounters = ( size_t ) 0U;
+    PRIVILEGED_DATA static size_t xNumberOfUntrackedAllocations = ( size_t ) 0U;
+    PRIVILEGED_DATA static size_t xNumberOfTimedAllocations = ( size_t ) 0U;
+    PRIVILEGED_DATA static uint32_t ulMinimumAllocationTime = heapUINT32_MAX;
+    PRIVILEGED_DATA static uint32_t ulMaximumAllocationTime = 0U;
+    PRIVILEGED_DATA static uint32_t ulTotalAllocationTime = 0U;
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /*-----------------------------------------------------------*/
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    BlockLink_t * pxBlock;
-    BlockLink_t * pxPreviousBlock;
-    BlockLink_t * pxNewBlockLink;
+    return prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, heapGET_INSTRUMENTATION_KEY() );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocAligned( size_t xWantedSize,
+                            size_t xAlignment )
+{
+    return prvMallocAligned( xWantedSize, xAlignment, heapGET_INSTRUMENTATION_KEY() );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvMallocAligned( size_t xWantedSize,
+                                size_t xAlignment,
+                                void * pvKey ) /* PRIVILEGED_FUNCTION */
+{
     void * pvReturn = NULL;
-    size_t xAdditionalRequiredSize;
-    size_t xAllocatedBlockSize = 0;
 
-    if( xWantedSize > 0 )
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+        size_t xRequestedSize = xWantedSize;
+        BaseType_t xHeapWasLocked = pdFALSE;
+        uint32_t ulLockedTime = 0U;
+    #endif
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxSizeClass = ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES;
+        void * pvRefillBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfRefillBlocks = 0;
+    #endif
+
+    /* The alignment must be a power of two.  Every block is aligned to at
+     * least portBYTE_ALIGNMENT. */
+    configASSERT( ( xAlignment & ( xAlignment - 1U ) ) == 0U );
+
+    if( xAlignment < ( size_t ) portBYTE_ALIGNMENT )
     {
-        /* The wanted size must be increased so it can contain a BlockLink_t
-         * structure in addition to the requested amount of bytes. */
-        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        xAlignment = ( size_t ) portBYTE_ALIGNMENT;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xWantedSize = prvGetWantedBlockSize( xWantedSize );
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+    {
+        /* Small requests that need no more than the default alignment are
+         * rounded up to the block size of their size class, so any cached
+         * block of a size class can satisfy any such request of that size
+         * class. */
+        if( ( xWantedSize > 0 ) && ( xAlignment == ( size_t ) portBYTE_ALIGNMENT ) )
         {
-            xWantedSize += xHeapStructSize;
+            uxSizeClass = prvGetRequestSizeClass( xWantedSize );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-            /* Ensure that blocks are always aligned to the required number
-             * of bytes. */
-            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
-            {
-                /* Byte alignment required. */
-                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+        if( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES )
+        {
+            xWantedSize = heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass );
+            pvReturn = prvTakeFromCache( uxSizeClass );
 
-                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
-                {
-                    xWantedSize += xAdditionalRequiredSize;
-                }
-                else
-                {
-                    xWantedSize = 0;
-                }
+            if( pvReturn != NULL )
+            {
+                traceMALLOC( pvReturn, heapALLOCATED_BLOCK_SIZE( pvReturn ) );
             }
             else
             {
@@ -210,128 +434,122 @@ void * pvPortMalloc( size_t xWantedSize )
         }
         else
         {
-            xWantedSize = 0;
+            mtCOVERAGE_TEST_MARKER();
         }
     }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
+    #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
 
-    vTaskSuspendAll();
+    if( pvReturn == NULL )
     {
-        /* If this is the first call to malloc then the heap will require
-         * initialisation to setup the list of free blocks. */
-        if( pxEnd == NULL )
+        vTaskSuspendAll();
         {
-            prvHeapInit();
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
-        }
+            #if ( configHEAP_INSTRUMENTATION == 1 )
+            {
+                ulLockedTime = configHEAP_INSTRUMENTATION_GET_TIME();
+            }
+            #endif
 
-        /* Check the block size we are trying to allocate is not so large that the
-         * top bit is set.  The top bit of the block size member of the BlockLink_t
-         * structure is used to determine who owns the block - the application or
-         * the kernel, so it must be free. */
-        if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
-        {
-            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+            /* If this is the first call to malloc then the heap will require
+             * initialisation to setup the list of free blocks. */
+            if( pxEnd == NULL )
             {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
-                heapVALIDATE_BLOCK_POINTER( pxBlock );
+                prvHeapInit();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
+            pvReturn = prvAllocateBlock( xWantedSize, xAlignment );
+
+            #if ( heapUSE_PER_CORE_CACHE == 1 )
+            {
+                /* Blocks held in the per-core caches are not free heap space,
+                 * so they may be all that stops the request being satisfied.
+                 * If so, return the blocks of every cache to the heap, where
+                 * they coalesce with their free neighbours, and try once
+                 * more. */
+                if( ( pvReturn == NULL ) && ( prvFlushCaches() > 0U ) )
                 {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
-                    heapVALIDATE_BLOCK_POINTER( pxBlock );
+                    pvReturn = prvAllocateBlock( xWantedSize, xAlignment );
                 }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
+                else
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock ) ) + xHeapStructSize );
-                    heapVALIDATE_BLOCK_POINTER( pvReturn );
-
-                    /* This block is being returned for use so must be taken out
-                     * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-                    /* If the block is larger than required it can be split into
-                     * two. */
-                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
-
-                    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
-                    {
-                        /* This block is to be split into two.  Create a new
-                         * block following the number of bytes requested. The void
-                         * cast is used to prevent byte alignment warnings from the
-                         * compiler. */
-                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
 
-                        /* Calculate the sizes of two blocks split from the
-                         * single block. */
-                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
+            if( pvReturn != NULL )
+            {
+                xNumberOfSuccessfulAllocations++;
+                traceMALLOC( pvReturn, heapALLOCATED_BLOCK_SIZE( pvReturn ) );
+            }
+            else
+            {
+                traceMALLOC( pvReturn, 0U );
+            }
 
-                        /* Insert the new block into the list of free blocks. */
-                        pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
-                        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
-                    }
-                    else
+            #if ( heapUSE_PER_CORE_CACHE == 1 )
+            {
+                /* The cache of the calling core had no block of this size class -
+                 * take more while the heap is locked so the next allocations of
+                 * this size class on this core do not need to lock the heap. */
+                if( ( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) && ( pvReturn != NULL ) )
+                {
+                    for( uxNumberOfRefillBlocks = 0; uxNumberOfRefillBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT; uxNumberOfRefillBlocks++ )
                     {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+                        pvRefillBlocks[ uxNumberOfRefillBlocks ] = prvAllocateBlock( xWantedSize, xAlignment );
 
-                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
-                    {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
+                        if( pvRefillBlocks[ uxNumberOfRefillBlocks ] == NULL )
+                        {
+                            break;
+                        }
                     }
-
-                    xAllocatedBlockSize = pxBlock->xBlockSize;
-
-                    /* The block is being returned - it is allocated and owned
-                     * by the application and has no "next" block. */
-                    heapALLOCATE_BLOCK( pxBlock );
-                    pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
-                    xNumberOfSuccessfulAllocations++;
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
-            else
+            #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+            #if ( configHEAP_INSTRUMENTATION == 1 )
             {
-                mtCOVERAGE_TEST_MARKER();
+                ulLockedTime = configHEAP_INSTRUMENTATION_GET_TIME() - ulLockedTime;
+                xHeapWasLocked = pdTRUE;
             }
+            #endif
         }
-        else
+        ( void ) xTaskResumeAll();
+
+        #if ( heapUSE_PER_CORE_CACHE == 1 )
         {
-            mtCOVERAGE_TEST_MARKER();
+            if( uxNumberOfRefillBlocks > 0U )
+            {
+                prvAddToCache( uxSizeClass, pvRefillBlocks, uxNumberOfRefillBlocks, pdFALSE );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
+        #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
 
-        traceMALLOC( pvReturn, xAllocatedBlockSize );
-
-        /* Prevent compiler warnings when trace macros are not used. */
-        ( void ) xAllocatedBlockSize;
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+    {
+        prvRecordAllocation( pvKey, xRequestedSize, pvReturn, xHeapWasLocked, ulLockedTime );
     }
-    ( void ) xTaskResumeAll();
+    #else
+    {
+        ( void ) pvKey;
+    }
+    #endif
 
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
@@ -346,7 +564,7 @@ void * pvPortMalloc( size_t xWantedSize )
     }
     #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
 
-    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( xAlignment - 1U ) ) == 0 );
     return pvReturn;
 }
 /*-----------------------------------------------------------*/
@@ -355,6 +573,11 @@ void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
+    BaseType_t xReturnToHeap = pdTRUE;
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxSizeClass;
+    #endif
 
     if( pv != NULL )
     {
@@ -387,15 +610,43 @@ void vPortFree( void * pv )
                 }
                 #endif
 
-                vTaskSuspendAll();
+                #if ( heapUSE_PER_CORE_CACHE == 1 )
                 {
-                    /* Add this block to the list of free blocks. */
-                    xFreeBytesRemaining += pxLink->xBlockSize;
-                    traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
-                    xNumberOfSuccessfulFrees++;
+                    uxSizeClass = prvGetBlockSizeClass( pxLink->xBlockSize );
+
+                    if( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES )
+                    {
+                        /* Small blocks are held, still marked as allocated, in
+                         * the cache of the calling core instead of being
+                         * returned to the heap. */
+                        traceFREE( pv, pxLink->xBlockSize );
+                        heapALLOCATE_BLOCK( pxLink );
+                        prvAddToCache( uxSizeClass, &pv, 1U, pdTRUE );
+                        xReturnToHeap = pdFALSE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+                if( xReturnToHeap != pdFALSE )
+                {
+                    vTaskSuspendAll();
+                    {
+                        /* Add this block to the list of free blocks. */
+                        xFreeBytesRemaining += pxLink->xBlockSize;
+                        traceFREE( pv, pxLink->xBlockSize );
+                        prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                        xNumberOfSuccessfulFrees++;
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
-                ( void ) xTaskResumeAll();
             }
             else
             {
@@ -441,7 +692,7 @@ void * pvPortCalloc( size_t xNum,
 
     if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
     {
-        pv = pvPortMalloc( xNum * xSize );
+        pv = prvMallocAligned( xNum * xSize, ( size_t ) portBYTE_ALIGNMENT, heapGET_INSTRUMENTATION_KEY() );
 
         if( pv != NULL )
         {
@@ -453,47 +704,201 @@ void * pvPortCalloc( size_t xNum,
 }
 /*-----------------------------------------------------------*/
 
-static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize )
 {
-    BlockLink_t * pxFirstFreeBlock;
-    portPOINTER_SIZE_TYPE uxStartAddress, uxEndAddress;
-    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
-
-    /* Ensure the heap starts on a correctly aligned boundary. */
-    uxStartAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+    BlockLink_t * pxNextBlock;
+    BlockLink_t * pxIterator;
+    BlockLink_t * pxNewBlockLink;
+    size_t xBlockSize;
+    size_t xNewBlockSize;
+    void * pvReturn = NULL;
 
-    if( ( uxStartAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    if( pv == NULL )
     {
-        uxStartAddress += ( portBYTE_ALIGNMENT - 1 );
-        uxStartAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
-        xTotalHeapSize -= ( size_t ) ( uxStartAddress - ( portPOINTER_SIZE_TYPE ) ucHeap );
+        pvReturn = prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, heapGET_INSTRUMENTATION_KEY() );
     }
-
-    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+    else if( xWantedSize == 0 )
     {
-        vApplicationGetRandomHeapCanary( &( xHeapCanary ) );
+        vPortFree( pv );
     }
-    #endif
+    else
+    {
+        /* The memory being resized will have an BlockLink_t structure
+         * immediately before it. */
+        puc -= xHeapStructSize;
 
-    /* xStart is used to hold a pointer to the first item in the list of free
-     * blocks.  The void cast is used to prevent compiler warnings. */
-    xStart.pxNextFreeBlock = ( void * ) heapPROTECT_BLOCK_POINTER( uxStartAddress );
-    xStart.xBlockSize = ( size_t ) 0;
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
 
-    /* pxEnd is used to mark the end of the list of free blocks and is inserted
-     * at the end of the heap space. */
-    uxEndAddress = uxStartAddress + ( portPOINTER_SIZE_TYPE ) xTotalHeapSize;
-    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
-    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
-    pxEnd = ( BlockLink_t * ) uxEndAddress;
-    pxEnd->xBlockSize = 0;
-    pxEnd->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+        heapVALIDATE_BLOCK_POINTER( pxLink );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == heapPROTECT_BLOCK_POINTER( NULL ) );
 
-    /* To start with there is a single free block that is sized to take up the
-     * entire heap space, minus the space taken by pxEnd. */
-    pxFirstFreeBlock = ( BlockLink_t * ) uxStartAddress;
-    pxFirstFreeBlock->xBlockSize = ( size_t ) ( uxEndAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlock );
-    pxFirstFreeBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+        xBlockSize = pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+        xNewBlockSize = prvGetWantedBlockSize( xWantedSize );
+
+        if( ( xNewBlockSize > 0 ) && ( heapBLOCK_SIZE_IS_VALID( xNewBlockSize ) != 0 ) )
+        {
+            vTaskSuspendAll();
+            {
+                if( xNewBlockSize > xBlockSize )
+                {
+                    /* The block can grow in place if the block that follows it
+                     * in memory is in the list of free blocks and is large
+                     * enough.  The list is in address order, so iterate until
+                     * a block at or above the following block is found. */
+                    pxNextBlock = ( void * ) ( puc + xBlockSize );
+                    heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+
+                    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxNextBlock; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+                    {
+                        /* Nothing to do here, just iterate to the right position. */
+                    }
+
+                    if( ( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) == pxNextBlock ) &&
+                        ( pxNextBlock != pxEnd ) &&
+                        ( ( xNewBlockSize - xBlockSize ) <= pxNextBlock->xBlockSize ) )
+                    {
+                        pxIterator->pxNextFreeBlock = pxNextBlock->pxNextFreeBlock;
+                        xFreeBytesRemaining -= pxNextBlock->xBlockSize;
+                        xBlockSize += pxNextBlock->xBlockSize;
+                        pvReturn = pv;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The block is shrinking so can always stay in place. */
+                    pvReturn = pv;
+                }
+
+                if( pvReturn != NULL )
+                {
+                    traceFREE( pv, pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK );
+
+                    /* Return the end of the block to the list of free blocks
+                     * if it is large enough to form a block of its own. */
+                    if( ( xBlockSize - xNewBlockSize ) > heapMINIMUM_BLOCK_SIZE )
+                    {
+                        pxNewBlockLink = ( void * ) ( puc + xNewBlockSize );
+                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                        pxNewBlockLink->xBlockSize = xBlockSize - xNewBlockSize;
+                        xBlockSize = xNewBlockSize;
+
+                        #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                        {
+                            ( void ) memset( ( ( uint8_t * ) pxNewBlockLink ) + xHeapStructSize, 0, pxNewBlockLink->xBlockSize - xHeapStructSize );
+                        }
+                        #endif
+
+                        xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+                        prvInsertBlockIntoFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    pxLink->xBlockSize = xBlockSize;
+                    heapALLOCATE_BLOCK( pxLink );
+                    traceMALLOC( pv, xBlockSize );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pvReturn == NULL )
+        {
+            /* The block could not be resized in place, so move it to a new
+             * block.  The new block is larger than the old one, so all the
+             * memory of the old block can be copied. */
+            pvReturn = prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, heapGET_INSTRUMENTATION_KEY() );
+
+            if( pvReturn != NULL )
+            {
+                ( void ) memcpy( pvReturn, pv, xBlockSize - xHeapStructSize );
+                vPortFree( pv );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstFreeBlock;
+    portPOINTER_SIZE_TYPE uxStartAddress, uxEndAddress;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxStartAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+
+    if( ( uxStartAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        uxStartAddress += ( portBYTE_ALIGNMENT - 1 );
+        uxStartAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+        xTotalHeapSize -= ( size_t ) ( uxStartAddress - ( portPOINTER_SIZE_TYPE ) ucHeap );
+    }
+
+    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+    {
+        vApplicationGetRandomHeapCanary( &( xHeapCanary ) );
+    }
+    #endif
+
+    /* xStart is used to hold a pointer to the first item in the list of free
+     * blocks.  The void cast is used to prevent compiler warnings. */
+    xStart.pxNextFreeBlock = ( void * ) heapPROTECT_BLOCK_POINTER( uxStartAddress );
+    xStart.xBlockSize = ( size_t ) 0;
+
+    /* pxEnd is used to mark the end of the list of free blocks and is inserted
+     * at the end of the heap space. */
+    uxEndAddress = uxStartAddress + ( portPOINTER_SIZE_TYPE ) xTotalHeapSize;
+    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    pxEnd = ( BlockLink_t * ) uxEndAddress;
+    pxEnd->xBlockSize = 0;
+    pxEnd->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by pxEnd. */
+    pxFirstFreeBlock = ( BlockLink_t * ) uxStartAddress;
+    pxFirstFreeBlock->xBlockSize = ( size_t ) ( uxEndAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlock );
+    pxFirstFreeBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
 
     /* Only one block exists - and it covers the entire usable heap space. */
     xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
@@ -569,11 +974,457 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVI
 }
 /*-----------------------------------------------------------*/
 
+static void * prvAllocateBlock( size_t xWantedSize,
+                                size_t xAlignment ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+    void * pvReturn = NULL;
+    size_t xPadding;
+
+    /* Check the block size we are trying to allocate is not so large that the
+     * top bit is set.  The top bit of the block size member of the BlockLink_t
+     * structure is used to determine who owns the block - the application or
+     * the kernel, so it must be free. */
+    if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+    {
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            /* Traverse the list from the start (lowest address) block until
+             * one of adequate size, once any padding needed to align it is
+             * skipped, is found. */
+            pxPreviousBlock = &xStart;
+            pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            xPadding = prvGetAlignmentPadding( pxBlock, xAlignment );
+
+            while( ( ( pxBlock->xBlockSize < xWantedSize ) || ( ( pxBlock->xBlockSize - xWantedSize ) < xPadding ) ) &&
+                   ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
+            {
+                pxPreviousBlock = pxBlock;
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                heapVALIDATE_BLOCK_POINTER( pxBlock );
+                xPadding = prvGetAlignmentPadding( pxBlock, xAlignment );
+            }
+
+            /* If the end marker was reached then a block of adequate size
+             * was not found. */
+            if( pxBlock != pxEnd )
+            {
+                if( xPadding > 0U )
+                {
+                    /* Leave the padding at the start of the block in the list
+                     * of free blocks as a block of its own, and allocate from
+                     * the aligned block that follows it. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xPadding );
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xPadding;
+                    pxNewBlockLink->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+                    pxBlock->xBlockSize = xPadding;
+                    pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+                    pxPreviousBlock = pxBlock;
+                    pxBlock = pxNewBlockLink;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Return the memory space pointed to - jumping over the
+                 * BlockLink_t structure at its start. */
+                pvReturn = ( void * ) ( ( ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock ) ) + xHeapStructSize );
+                heapVALIDATE_BLOCK_POINTER( pvReturn );
+
+                /* This block is being returned for use so must be taken out
+                 * of the list of free blocks. */
+                pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+                /* If the block is larger than required it can be split into
+                 * two. */
+                configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+                if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                {
+                    /* This block is to be split into two.  Create a new
+                     * block following the number of bytes requested. The void
+                     * cast is used to prevent byte alignment warnings from the
+                     * compiler. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                    /* Calculate the sizes of two blocks split from the
+                     * single block. */
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    /* Insert the new block into the list of free blocks. */
+                    pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
+                    pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block is being returned - it is allocated and owned
+                 * by the application and has no "next" block. */
+                heapALLOCATE_BLOCK( pxBlock );
+                pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetWantedBlockSize( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    size_t xAdditionalRequiredSize;
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain a BlockLink_t
+         * structure in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xWantedSize;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetAlignmentPadding( const BlockLink_t * pxBlock,
+                                      size_t xAlignment ) /* PRIVILEGED_FUNCTION */
+{
+    portPOINTER_SIZE_TYPE uxAddress;
+    size_t xPadding = 0;
+
+    /* Every block is already aligned to portBYTE_ALIGNMENT. */
+    if( xAlignment > ( size_t ) portBYTE_ALIGNMENT )
+    {
+        uxAddress = ( ( portPOINTER_SIZE_TYPE ) pxBlock ) + ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+        xPadding = ( size_t ) ( ( ( portPOINTER_SIZE_TYPE ) xAlignment ) - ( uxAddress & ( ( portPOINTER_SIZE_TYPE ) xAlignment - 1U ) ) );
+        xPadding &= ( xAlignment - 1U );
+
+        /* The bytes skipped at the start of the block remain free as a block
+         * of their own, so must be large enough to form a block. */
+        while( ( xPadding > 0U ) && ( xPadding < heapMINIMUM_BLOCK_SIZE ) )
+        {
+            xPadding += xAlignment;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xPadding;
+}
+/*-----------------------------------------------------------*/
+
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+    static UBaseType_t prvGetRequestSizeClass( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxSizeClass = 0;
+
+        /* Find the smallest size class that holds blocks large enough. */
+        while( ( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) &&
+               ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass ) < xWantedSize ) )
+        {
+            uxSizeClass++;
+        }
+
+        return uxSizeClass;
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvGetBlockSizeClass( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxSizeClass = prvGetRequestSizeClass( xBlockSize );
+
+        /* A block is only split if the remainder is large enough to form a
+         * block of its own, so a block allocated for a size class can be up to
+         * heapMINIMUM_BLOCK_SIZE bytes larger than the block size of the size
+         * class. */
+        if( ( uxSizeClass == ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) ||
+            ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass ) > xBlockSize ) )
+        {
+            if( ( uxSizeClass > 0U ) &&
+                ( xBlockSize <= ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass - 1U ) + heapMINIMUM_BLOCK_SIZE ) ) )
+            {
+                uxSizeClass--;
+            }
+            else
+            {
+                uxSizeClass = ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return uxSizeClass;
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvTakeFromCache( UBaseType_t uxSizeClass ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvReturn = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* The cache is accessed from a critical section that masks interrupts
+         * and holds the ISR lock, instead of the heap being locked.  Masking
+         * interrupts stops the calling task being preempted by another task
+         * using the same cache, or moving to another core.  The ISR lock stops
+         * prvFlushCaches() emptying the cache on another core at the same
+         * time. */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxCache = &( xHeapCaches[ portGET_CORE_ID() ] );
+
+            if( pxCache->uxNumberOfBlocks[ uxSizeClass ] > 0U )
+            {
+                pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                pvReturn = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                pxCache->xNumberOfAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( pvReturn != NULL )
+        {
+            /* This casting is to keep the compiler from issuing warnings. */
+            pxLink = ( void * ) ( ( ( uint8_t * ) pvReturn ) - xHeapStructSize );
+
+            configASSERT( pxLink->pxNextFreeBlock == heapCACHED_BLOCK_MARKER );
+            pxLink->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAddToCache( UBaseType_t uxSizeClass,
+                               void * const * ppvBlocks,
+                               UBaseType_t uxNumberOfBlocks,
+                               BaseType_t xIsFree ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvDrainedBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfDrainedBlocks = 0;
+        UBaseType_t uxBlock;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* Draining heapCACHE_TRANSFER_COUNT blocks from a full cache leaves
+         * room for all the blocks being added. */
+        configASSERT( uxNumberOfBlocks <= ( UBaseType_t ) heapCACHE_TRANSFER_COUNT );
+
+        for( uxBlock = 0; uxBlock < uxNumberOfBlocks; uxBlock++ )
+        {
+            /* This casting is to keep the compiler from issuing warnings. */
+            pxLink = ( void * ) ( ( ( uint8_t * ) ppvBlocks[ uxBlock ] ) - xHeapStructSize );
+            pxLink->pxNextFreeBlock = heapCACHED_BLOCK_MARKER;
+        }
+
+        /* See the comment in prvTakeFromCache(). */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxCache = &( xHeapCaches[ portGET_CORE_ID() ] );
+
+            if( xIsFree != pdFALSE )
+            {
+                pxCache->xNumberOfFrees += ( size_t ) uxNumberOfBlocks;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            for( uxBlock = 0; uxBlock < uxNumberOfBlocks; uxBlock++ )
+            {
+                if( pxCache->uxNumberOfBlocks[ uxSizeClass ] == ( UBaseType_t ) configHEAP_PER_CORE_CACHE_LENGTH )
+                {
+                    while( uxNumberOfDrainedBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT )
+                    {
+                        pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                        pvDrainedBlocks[ uxNumberOfDrainedBlocks ] = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                        uxNumberOfDrainedBlocks++;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ] = ppvBlocks[ uxBlock ];
+                pxCache->uxNumberOfBlocks[ uxSizeClass ]++;
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( uxNumberOfDrainedBlocks > 0U )
+        {
+            /* Return the drained blocks to the heap while it is locked once. */
+            vTaskSuspendAll();
+            {
+                for( uxBlock = 0; uxBlock < uxNumberOfDrainedBlocks; uxBlock++ )
+                {
+                    /* This casting is to keep the compiler from issuing warnings. */
+                    pxLink = ( void * ) ( ( ( uint8_t * ) pvDrainedBlocks[ uxBlock ] ) - xHeapStructSize );
+
+                    heapFREE_BLOCK( pxLink );
+                    xFreeBytesRemaining += pxLink->xBlockSize;
+                    prvInsertBlockIntoFreeList( pxLink );
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvFlushCaches( void ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvFlushedBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfTakenBlocks;
+        UBaseType_t uxCore;
+        UBaseType_t uxSizeClass;
+        UBaseType_t uxBlock;
+        size_t xNumberOfFlushedBlocks = 0;
+        UBaseType_t uxSavedInterruptStatus;
+
+        for( uxCore = 0; uxCore < ( UBaseType_t ) configNUMBER_OF_CORES; uxCore++ )
+        {
+            pxCache = &( xHeapCaches[ uxCore ] );
+
+            for( uxSizeClass = 0; uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES; uxSizeClass++ )
+            {
+                do
+                {
+                    uxNumberOfTakenBlocks = 0;
+
+                    /* The ISR lock is only held while up to
+                     * heapCACHE_TRANSFER_COUNT blocks are taken from the cache,
+                     * so the time for which interrupts are masked does not
+                     * depend on how many blocks are cached.  The caller has
+                     * locked the heap, so the blocks are returned to the heap
+                     * once the ISR lock is released. */
+                    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+                    {
+                        while( ( pxCache->uxNumberOfBlocks[ uxSizeClass ] > 0U ) &&
+                               ( uxNumberOfTakenBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT ) )
+                        {
+                            pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                            pvFlushedBlocks[ uxNumberOfTakenBlocks ] = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                            uxNumberOfTakenBlocks++;
+                        }
+                    }
+                    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+                    for( uxBlock = 0; uxBlock < uxNumberOfTakenBlocks; uxBlock++ )
+                    {
+                        /* This casting is to keep the compiler from issuing warnings. */
+                        pxLink = ( void * ) ( ( ( uint8_t * ) pvFlushedBlocks[ uxBlock ] ) - xHeapStructSize );
+
+                        configASSERT( pxLink->pxNextFreeBlock == heapCACHED_BLOCK_MARKER );
+                        heapFREE_BLOCK( pxLink );
+                        xFreeBytesRemaining += pxLink->xBlockSize;
+                        prvInsertBlockIntoFreeList( pxLink );
+                    }
+
+                    xNumberOfFlushedBlocks += ( size_t ) uxNumberOfTakenBlocks;
+                } while( uxNumberOfTakenBlocks == ( UBaseType_t ) heapCACHE_TRANSFER_COUNT );
+            }
+        }
+
+        return xNumberOfFlushedBlocks;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
 void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 {
     BlockLink_t * pxBlock;
     size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
 
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxCore;
+    #endif
+
     vTaskSuspendAll();
     {
         pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
@@ -615,12 +1466,195 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
         pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
         pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
         pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+
+        #if ( heapUSE_PER_CORE_CACHE == 1 )
+        {
+            /* The critical section holds the ISR lock, so no core is using
+             * its cache. */
+            for( uxCore = 0; uxCore < ( UBaseType_t ) configNUMBER_OF_CORES; uxCore++ )
+            {
+                pxHeapStats->xNumberOfSuccessfulAllocations += xHeapCaches[ uxCore ].xNumberOfAllocations;
+                pxHeapStats->xNumberOfSuccessfulFrees += xHeapCaches[ uxCore ].xNumberOfFrees;
+            }
+        }
+        #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
         pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+
+        heapISR_POOL_GET_STATS( pxHeapStats );
     }
     taskEXIT_CRITICAL();
 }
 /*-----------------------------------------------------------*/
 
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+    static void prvRecordAllocation( void * pvKey,
+                                     size_t xWantedSize,
+                                     const void * pvReturn,
+                                     BaseType_t xHeapWasLocked,
+                                     uint32_t ulLockedTime ) /* PRIVILEGED_FUNCTION */
+    {
+        size_t xCounter = 0;
+
+        taskENTER_CRITICAL();
+        {
+            if( xHeapWasLocked != pdFALSE )
+            {
+                if( ulLockedTime < ulMinimumAllocationTime )
+                {
+                    ulMinimumAllocationTime = ulLockedTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ulLockedTime > ulMaximumAllocationTime )
+                {
+                    ulMaximumAllocationTime = ulLockedTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Halve the total time and the number of allocations it was
+                 * measured over, rather than let the total overflow, so the
+                 * average remains valid. */
+                if( ulTotalAllocationTime > ( heapUINT32_MAX - ulLockedTime ) )
+                {
+                    ulTotalAllocationTime /= 2U;
+                    xNumberOfTimedAllocations /= 2U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                ulTotalAllocationTime += ulLockedTime;
+                xNumberOfTimedAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Find the counter for this key, or claim an unused one if this is
+             * the first allocation made with the key. */
+            while( ( xCounter < xNumberOfAllocationCounters ) && ( xAllocationCounters[ xCounter ].pvKey != pvKey ) )
+            {
+                xCounter++;
+            }
+
+            if( ( xCounter == xNumberOfAllocationCounters ) && ( xCounter < ( size_t ) configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS ) )
+            {
+                ( void ) memset( &( xAllocationCounters[ xCounter ] ), 0, sizeof( HeapAllocationCounter_t ) );
+                xAllocationCounters[ xCounter ].pvKey = pvKey;
+                xNumberOfAllocationCounters++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xCounter == xNumberOfAllocationCounters )
+            {
+                xNumberOfUntrackedAllocations++;
+            }
+            else if( pvReturn != NULL )
+            {
+                xAllocationCounters[ xCounter ].xNumberOfAllocations++;
+                xAllocationCounters[ xCounter ].xBytesAllocated += xWantedSize;
+            }
+            else
+            {
+                xAllocationCounters[ xCounter ].xNumberOfFailedAllocations++;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortGetHeapInstrumentation( HeapInstrumentation_t * pxHeapInstrumentation )
+    {
+        BlockLink_t * pxBlock;
+        size_t xBucket;
+        size_t xSize;
+
+        ( void ) memset( pxHeapInstrumentation->xFreeBlockHistogram, 0, sizeof( pxHeapInstrumentation->xFreeBlockHistogram ) );
+
+        vTaskSuspendAll();
+        {
+            pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+
+            /* pxBlock will be NULL if the heap has not been initialised.  The
+             * heap is initialised automatically when the first allocation is
+             * made. */
+            if( pxBlock != NULL )
+            {
+                while( pxBlock != pxEnd )
+                {
+                    /* Entry n of the histogram counts blocks whose size has its
+                     * most significant bit at heapHISTOGRAM_FIRST_BUCKET_SHIFT + n. */
+                    xBucket = 0;
+                    xSize = pxBlock->xBlockSize >> ( heapHISTOGRAM_FIRST_BUCKET_SHIFT + 1U );
+
+                    while( ( xSize > 0U ) && ( xBucket < ( ( size_t ) configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS - 1U ) ) )
+                    {
+                        xSize >>= 1;
+                        xBucket++;
+                    }
+
+                    pxHeapInstrumentation->xFreeBlockHistogram[ xBucket ]++;
+
+                    /* Move to the next block in the chain until the last block
+                     * is reached. */
+                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        taskENTER_CRITICAL();
+        {
+            if( xNumberOfTimedAllocations > 0U )
+            {
+                pxHeapInstrumentation->ulMinimumAllocationTime = ulMinimumAllocationTime;
+                pxHeapInstrumentation->ulAverageAllocationTime = ulTotalAllocationTime / ( uint32_t ) xNumberOfTimedAllocations;
+            }
+            else
+            {
+                pxHeapInstrumentation->ulMinimumAllocationTime = 0U;
+                pxHeapInstrumentation->ulAverageAllocationTime = 0U;
+            }
+
+            pxHeapInstrumentation->ulMaximumAllocationTime = ulMaximumAllocationTime;
+            pxHeapInstrumentation->xNumberOfTimedAllocations = xNumberOfTimedAllocations;
+            pxHeapInstrumentation->xNumberOfUntrackedAllocations = xNumberOfUntrackedAllocations;
+            pxHeapInstrumentation->xNumberOfAllocationCounters = xNumberOfAllocationCounters;
+            ( void ) memcpy( pxHeapInstrumentation->xAllocationCounters, xAllocationCounters, sizeof( xAllocationCounters ) );
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortResetHeapInstrumentation( void )
+    {
+        taskENTER_CRITICAL();
+        {
+            xNumberOfAllocationCounters = ( size_t ) 0U;
+            xNumberOfUntrackedAllocations = ( size_t ) 0U;
+            xNumberOfTimedAllocations = ( size_t ) 0U;
+            ulMinimumAllocationTime = heapUINT32_MAX;
+            ulMaximumAllocationTime = 0U;
+            ulTotalAllocationTime = 0U;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /*
  * Reset the state in this file. This state is normally initialized at start up.
  * This function must be called by the application before restarting the
@@ -634,5 +1668,20 @@ void vPortHeapResetState( void )
     xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
     xNumberOfSuccessfulAllocations = ( size_t ) 0U;
     xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        ( void ) memset( xHeapCaches, 0, sizeof( xHeapCaches ) );
+    #endif
+
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+        xNumberOfAllocationCounters = ( size_t ) 0U;
+        xNumberOfUntrackedAllocations = ( size_t ) 0U;
+        xNumberOfTimedAllocations = ( size_t ) 0U;
+        ulMinimumAllocationTime = heapUINT32_MAX;
+        ulMaximumAllocationTime = 0U;
+        ulTotalAllocationTime = 0U;
+    #endif
+
+    heapISR_POOL_RESET_STATE();
 }
 /*-----------------------------------------------------------*/
@@ -31,6 +31,15 @@
  * across multiple non-contiguous blocks and combines (coalescences) adjacent
  * memory blocks as they are freed.
  *
+ * Each region keeps its free blocks in separate lists by size, one list for
+ * each power of two, so an allocation takes the first block from the first
+ * non-empty list of blocks that are all large enough instead of walking past
+ * blocks that are too small.  The time taken to find a block is therefore
+ * bounded by the number of regions and lists.  If no such list has a free
+ * block only the first block of each smaller list is checked, so an allocation
+ * can fail even though a large enough block is further along one of those
+ * lists.
+ *
  * See heap_1.c, heap_2.c, heap_3.c and heap_4.c for alternative
  * implementations, and the memory management pages of https://www.FreeRTOS.org
  * for more information.
@@ -67,6 +76,29 @@
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * pvPortMalloc() can allocate memory from any region, and tries the regions in
+ * address order.  Defining the regions with vPortDefineHeapRegionsWithFlags()
+ * instead gives each region application defined flags.
+ * pvPortMallocFromRegions() only allocates memory from regions whose flags
+ * have all the bits set that are set in its uxRegionFlags parameter, so the
+ * application can use the flags to place an allocation in, for example, fast
+ * internal RAM or bulk external RAM:
+ *
+ * #define mainFAST_RAM    ( 1U << 0 )
+ *
+ * HeapRegion_t xHeapRegions[] =
+ * {
+ *  { ( uint8_t * ) 0x20000000UL, 0x8000 },  << Internal RAM.
+ *  { ( uint8_t * ) 0x60000000UL, 0x80000 }, << External RAM.
+ *  { NULL, 0 }
+ * };
+ *
+ * const UBaseType_t uxRegionFlags[] = { mainFAST_RAM, 0 };
+ *
+ * vPortDefineHeapRegionsWithFlags( xHeapRegions, uxRegionFlags );
+ *
+ * pvBuffer = pvPortMallocFromRegions( xSize, mainFAST_RAM );
+ *
  */
 #include <stdlib.h>
 #include <string.h>
@@ -89,8 +121,48 @@
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
 #endif
 
-/* Block sizes must not get too small. */
-#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize << 1 ) )
+/* pvPortMallocFromISR() and vPortFreeFromISR() are implemented by the pool of
+ * fixed size blocks that heap_4.c, heap_5.c and heap_6.c share. */
+#include "heap_isr_pool.h"
+
+#ifndef configHEAP_PER_CORE_CACHE_LENGTH
+    #define configHEAP_PER_CORE_CACHE_LENGTH    0
+#endif
+
+#ifndef configHEAP_PER_CORE_CACHE_SIZE_CLASSES
+    #define configHEAP_PER_CORE_CACHE_SIZE_CLASSES    4
+#endif
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* Allocations are counted against the calling task unless
+ * configHEAP_INSTRUMENTATION_GET_KEY() is defined to return something else,
+ * such as the return address of the function that called pvPortMalloc(). */
+    #ifndef configHEAP_INSTRUMENTATION_GET_KEY
+        #define configHEAP_INSTRUMENTATION_GET_KEY()    ( ( void * ) xTaskGetCurrentTaskHandle() )
+    #endif
+
+/* The time each allocation holds the heap locked is measured using the run
+ * time stats counter unless configHEAP_INSTRUMENTATION_GET_TIME() is defined. */
+    #ifndef configHEAP_INSTRUMENTATION_GET_TIME
+        #ifdef portGET_RUN_TIME_COUNTER_VALUE
+            #define configHEAP_INSTRUMENTATION_GET_TIME()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+        #else
+            #error configHEAP_INSTRUMENTATION is 1 but neither configHEAP_INSTRUMENTATION_GET_TIME nor portGET_RUN_TIME_COUNTER_VALUE is defined.
+        #endif
+    #endif
+
+    #define heapGET_INSTRUMENTATION_KEY()    configHEAP_INSTRUMENTATION_GET_KEY()
+#else
+    #define heapGET_INSTRUMENTATION_KEY()    NULL
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
+/* Small blocks are only cached per core in SMP builds. */
+#define heapUSE_PER_CORE_CACHE    ( ( configHEAP_PER_CORE_CACHE_LENGTH > 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+/* Block sizes must not get too small - a free block holds a FreeBlockLinks_t
+ * structure after its BlockLink_t structure. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize + xFreeBlockLinksSize ) )
 
 /* Assumes 8bit bytes! */
 #define heapBITS_PER_BYTE         ( ( size_t ) 8 )
@@ -107,6 +179,25 @@
 /* Check if the subtraction operation ( a - b ) will result in underflow. */
 #define heapSUBTRACT_WILL_UNDERFLOW( a, b )    ( ( a ) < ( b ) )
 
+/* Each region has one list of free blocks for each bit in a size_t.  List n
+ * holds the free blocks whose size has bit n as its most significant set
+ * bit. */
+#define heapNUMBER_OF_BINS                     ( sizeof( size_t ) * heapBITS_PER_BYTE )
+
+/* The FreeBlockLinks_t structure held in a free block. */
+#define heapFREE_BLOCK_LINKS( pxBlock )        ( ( FreeBlockLinks_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + xHeapStructSize ) )
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* Entry n of the free block histogram counts blocks of at least
+ * ( 1 << ( heapHISTOGRAM_FIRST_BUCKET_SHIFT + n ) ) bytes. */
+    #define heapHISTOGRAM_FIRST_BUCKET_SHIFT    ( ( size_t ) 4 )
+
+/* Max value that fits in a uint32_t type. */
+    #define heapUINT32_MAX                      ( ( uint32_t ) 0xffffffffUL )
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /* MSB of the xBlockSize member of an BlockLink_t structure is used to track
  * the allocation status of a block.  When MSB of the xBlockSize member of
  * an BlockLink_t structure is set then the block belongs to the application.
@@ -117,6 +208,27 @@
 #define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
 #define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
 
+/* The size, including the BlockLink_t structure, of the allocated block that
+ * holds the memory pv returned to the application. */
+#define heapALLOCATED_BLOCK_SIZE( pv )           ( ( ( const BlockLink_t * ) ( ( ( const uint8_t * ) ( pv ) ) - xHeapStructSize ) )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK )
+
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/* The size, including the BlockLink_t structure, of the blocks held in the
+ * per-core caches for each size class.  Each size class holds blocks twice
+ * the size of the blocks in the size class below it. */
+    #define heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass )    ( heapMINIMUM_BLOCK_SIZE << ( uxSizeClass ) )
+
+/* The number of blocks moved between a per-core cache and the heap each time
+ * the heap is locked to refill or drain the cache. */
+    #define heapCACHE_TRANSFER_COUNT                     ( ( configHEAP_PER_CORE_CACHE_LENGTH + 1 ) / 2 )
+
+/* The pxNextFreeBlock member of a block held in a per-core cache is set to
+ * this value so freeing the block a second time can be caught. */
+    #define heapCACHED_BLOCK_MARKER                      heapPROTECT_BLOCK_POINTER( &xStart )
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
 /* Setting configENABLE_HEAP_PROTECTOR to 1 enables heap block pointers
  * protection using an application supplied canary value to catch heap
  * corruption should a heap buffer overflow occur.
@@ -161,6 +273,28 @@ typedef struct A_BLOCK_LINK
     size_t xBlockSize;                     /**< The size of the free block. */
 } BlockLink_t;
 
+/* Free blocks hold this structure in the memory that follows their BlockLink_t
+ * structure, so a free block can be removed from the list of free blocks
+ * without searching it for the previous block, and so it can be held in the
+ * list of free blocks of its size. */
+typedef struct A_FREE_BLOCK_LINKS
+{
+    BlockLink_t * pxPreviousFreeBlock; /**< The previous free block in the list of free blocks in address order. */
+    BlockLink_t * pxNextBinBlock;      /**< The next free block in the list of free blocks of this size. */
+    BlockLink_t * pxPreviousBinBlock;  /**< The previous free block in the list of free blocks of this size. */
+} FreeBlockLinks_t;
+
+/* Each heap region starts with this structure, which holds the flags the
+ * region was defined with and the lists of free blocks in the region. */
+typedef struct A_REGION_LINK
+{
+    struct A_REGION_LINK * pxNextRegion;         /**< The region at the next higher address. */
+    BlockLink_t * pxRegionEnd;                   /**< The end marker of the region. */
+    UBaseType_t uxFlags;                         /**< The flags the region was defined with. */
+    size_t xBinMap;                              /**< Bit n is set if the list pxBins[ n ] is not empty. */
+    BlockLink_t * pxBins[ heapNUMBER_OF_BINS ]; /**< The lists of free blocks of each size. */
+} RegionLink_t;
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -171,6 +305,139 @@ typedef struct A_BLOCK_LINK
  */
 static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
+void vPortDefineHeapRegionsWithFlags( const HeapRegion_t * const pxHeapRegions,
+                                      const UBaseType_t * const puxRegionFlags ) PRIVILEGED_FUNCTION;
+
+/*
+ * The implementation of pvPortMalloc() and pvPortMallocAligned().  If
+ * configHEAP_INSTRUMENTATION is 1 the allocation is counted against pvKey.
+ */
+static void * prvMallocAligned( size_t xWantedSize,
+                                size_t xAlignment,
+                                UBaseType_t uxRegionFlags,
+                                void * pvKey ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a block of xWantedSize bytes, including the BlockLink_t structure,
+ * from the list of free blocks of a region that has all the flags set in
+ * uxRegionFlags.  The memory returned is aligned to xAlignment bytes.  Must be
+ * called with the scheduler suspended.
+ */
+static void * prvAllocateBlock( size_t xWantedSize,
+                                size_t xAlignment,
+                                UBaseType_t uxRegionFlags ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a free block in pxRegion that can hold xWantedSize bytes once the
+ * padding needed to align it to xAlignment bytes is skipped, or NULL if none
+ * is found.  Only the first block of each list of free blocks is examined, so
+ * the time taken does not depend on the number of free blocks.
+ */
+static BlockLink_t * prvFindFreeBlock( const RegionLink_t * pxRegion,
+                                       size_t xWantedSize,
+                                       size_t xAlignment ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the index of the list of free blocks that holds blocks of
+ * xBlockSize bytes.
+ */
+static size_t prvGetBinIndex( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the region that contains pxBlock.
+ */
+static RegionLink_t * prvGetRegion( const BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a free block to, and remove a free block from, the list of free blocks
+ * of its size in pxRegion.  The size of the block must not change while it is
+ * in the list.
+ */
+static void prvAddToBin( RegionLink_t * pxRegion,
+                         BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+static void prvRemoveFromBin( RegionLink_t * pxRegion,
+                              BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a free block to the list of free blocks, after pxPreviousBlock, and to
+ * the list of free blocks of its size.  Neither merges the block with its
+ * neighbours.
+ */
+static void prvAddToFreeList( RegionLink_t * pxRegion,
+                              BlockLink_t * pxBlock,
+                              BlockLink_t * pxPreviousBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove a free block from the list of free blocks and from the list of free
+ * blocks of its size.
+ */
+static void prvRemoveFromFreeList( RegionLink_t * pxRegion,
+                                   BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the size of the block needed to hold xWantedSize bytes, including
+ * the BlockLink_t structure, or 0 if xWantedSize is 0 or too large.
+ */
+static size_t prvGetWantedBlockSize( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of bytes that must be skipped at the start of the free
+ * block pxBlock so the memory returned from it is aligned to xAlignment bytes.
+ */
+static size_t prvGetAlignmentPadding( const BlockLink_t * pxBlock,
+                                      size_t xAlignment ) PRIVILEGED_FUNCTION;
+
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/*
+ * Return the size class of an allocation request or of a block being freed.
+ * configHEAP_PER_CORE_CACHE_SIZE_CLASSES is returned if the request or block
+ * is too large to be cached.
+ */
+    static UBaseType_t prvGetRequestSizeClass( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+    static UBaseType_t prvGetBlockSizeClass( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a block of the given size class from the cache of the calling core,
+ * and counts it as an allocation.  Returns NULL if the cache is empty.
+ */
+    static void * prvTakeFromCache( UBaseType_t uxSizeClass ) PRIVILEGED_FUNCTION;
+
+/*
+ * Places up to heapCACHE_TRANSFER_COUNT blocks of the given size class in the
+ * cache of the calling core.  If the cache is full, heapCACHE_TRANSFER_COUNT
+ * blocks are first drained from the cache back to the heap.  xIsFree is pdTRUE
+ * if the blocks are being freed by the application, rather than moved to the
+ * cache from the heap, so are counted as frees.
+ */
+    static void prvAddToCache( UBaseType_t uxSizeClass,
+                               void * const * ppvBlocks,
+                               UBaseType_t uxNumberOfBlocks,
+                               BaseType_t xIsFree ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns every block held in the caches of all the cores to the heap, and
+ * returns the number of blocks returned.  Must be called with the scheduler
+ * suspended.
+ */
+    static size_t prvFlushCaches( void ) PRIVILEGED_FUNCTION;
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/*
+ * Counts an allocation of xWantedSize bytes, which returned pvReturn, against
+ * pvKey.  If the allocation locked the heap, xHeapWasLocked is pdTRUE and
+ * ulLockedTime is the time the heap was locked for.
+ */
+    static void prvRecordAllocation( void * pvKey,
+                                     size_t xWantedSize,
+                                     const void * pvReturn,
+                                     BaseType_t xHeapWasLocked,
+                                     uint32_t ulLockedTime ) PRIVILEGED_FUNCTION;
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
 
 #if ( configENABLE_HEAP_PROTECTOR == 1 )
 
@@ -188,10 +455,18 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  * block must by correctly byte aligned. */
 static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
 
+/* The space held by the FreeBlockLinks_t structure in a free block, and by the
+ * RegionLink_t structure at the start of each region. */
+static const size_t xFreeBlockLinksSize = ( sizeof( FreeBlockLinks_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+static const size_t xRegionStructSize = ( sizeof( RegionLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
 /* Create a couple of list links to mark the start and end of the list. */
 PRIVILEGED_DATA static BlockLink_t xStart;
 PRIVILEGED_DATA static BlockLink_t * pxEnd = NULL;
 
+/* The region with the lowest address. */
+PRIVILEGED_DATA static RegionLink_t * pxFirstRegion = NULL;
+
 /* Keeps track of the number of calls to allocate and free memory as well as the
  * number of free bytes remaining, but says nothing about fragmentation. */
 PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
@@ -199,6 +474,41 @@ PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+/* Each core caches a few free blocks of each small size class so most small
+ * allocations and frees complete without locking the heap.  Blocks held in a
+ * cache remain marked as allocated, so are not counted as free heap space.
+ * The allocations and frees a cache satisfies are counted in the cache, as
+ * they do not lock the heap, and added to the heap's counts by
+ * vPortGetHeapStats(). */
+    typedef struct HeapCache
+    {
+        UBaseType_t uxNumberOfBlocks[ configHEAP_PER_CORE_CACHE_SIZE_CLASSES ];
+        void * pvBlocks[ configHEAP_PER_CORE_CACHE_SIZE_CLASSES ][ configHEAP_PER_CORE_CACHE_LENGTH ];
+        size_t xNumberOfAllocations;
+        size_t xNumberOfFrees;
+    } HeapCache_t;
+
+    PRIVILEGED_DATA static HeapCache_t xHeapCaches[ configNUMBER_OF_CORES ];
+
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+/* The allocations counted against each task or call site, and the time
+ * allocations have held the heap locked, as reported by
+ * vPortGetHeapInstrumentation().  Only accessed from critical sections. */
+    PRIVILEGED_DATA static HeapAllocationCounter_t xAllocationCounters[ configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS ];
+    PRIVILEGED_DATA static size_t xNumberOfAllocationCounters = ( size_t ) 0U;
+    PRIVILEGED_DATA static size_t xNumberOfUntrackedAllocations = ( size_t ) 0U;
+    PRIVILEGED_DATA static size_t xNumberOfTimedAllocations = ( size_t ) 0U;
+    PRIVILEGED_DATA static uint32_t ulMinimumAllocationTime = heapUINT32_MAX;
+    PRIVILEGED_DATA static uint32_t ulMaximumAllocationTime = 0U;
+    PRIVILEGED_DATA static uint32_t ulTotalAllocationTime = 0U;
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 #if ( configENABLE_HEAP_PROTECTOR == 1 )
 
 /* Canary value for protecting internal heap pointers. */
@@ -214,40 +524,85 @@ PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    BlockLink_t * pxBlock;
-    BlockLink_t * pxPreviousBlock;
-    BlockLink_t * pxNewBlockLink;
+    return prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, ( UBaseType_t ) 0U, heapGET_INSTRUMENTATION_KEY() );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocAligned( size_t xWantedSize,
+                            size_t xAlignment )
+{
+    return prvMallocAligned( xWantedSize, xAlignment, ( UBaseType_t ) 0U, heapGET_INSTRUMENTATION_KEY() );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocFromRegions( size_t xWantedSize,
+                                UBaseType_t uxRegionFlags )
+{
+    return prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, uxRegionFlags, heapGET_INSTRUMENTATION_KEY() );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvMallocAligned( size_t xWantedSize,
+                                size_t xAlignment,
+                                UBaseType_t uxRegionFlags,
+                                void * pvKey ) /* PRIVILEGED_FUNCTION */
+{
     void * pvReturn = NULL;
-    size_t xAdditionalRequiredSize;
-    size_t xAllocatedBlockSize = 0;
+
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+        size_t xRequestedSize = xWantedSize;
+        BaseType_t xHeapWasLocked = pdFALSE;
+        uint32_t ulLockedTime = 0U;
+    #endif
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxSizeClass = ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES;
+        void * pvRefillBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfRefillBlocks = 0;
+    #endif
 
     /* The heap must be initialised before the first call to
      * pvPortMalloc(). */
     configASSERT( pxEnd );
 
-    if( xWantedSize > 0 )
+    /* The alignment must be a power of two.  Every block is aligned to at
+     * least portBYTE_ALIGNMENT. */
+    configASSERT( ( xAlignment & ( xAlignment - 1U ) ) == 0U );
+
+    if( xAlignment < ( size_t ) portBYTE_ALIGNMENT )
     {
-        /* The wanted size must be increased so it can contain a BlockLink_t
-         * structure in addition to the requested amount of bytes. */
-        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        xAlignment = ( size_t ) portBYTE_ALIGNMENT;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xWantedSize = prvGetWantedBlockSize( xWantedSize );
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+    {
+        /* Small requests that need no more than the default alignment, and can
+         * be placed in any region, are rounded up to the block size of their
+         * size class, so any cached block of a size class can satisfy any such
+         * request of that size class. */
+        if( ( xWantedSize > 0 ) && ( xAlignment == ( size_t ) portBYTE_ALIGNMENT ) && ( uxRegionFlags == 0U ) )
         {
-            xWantedSize += xHeapStructSize;
+            uxSizeClass = prvGetRequestSizeClass( xWantedSize );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-            /* Ensure that blocks are always aligned to the required number
-             * of bytes. */
-            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
-            {
-                /* Byte alignment required. */
-                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+        if( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES )
+        {
+            xWantedSize = heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass );
+            pvReturn = prvTakeFromCache( uxSizeClass );
 
-                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
-                {
-                    xWantedSize += xAdditionalRequiredSize;
-                }
-                else
-                {
-                    xWantedSize = 0;
-                }
+            if( pvReturn != NULL )
+            {
+                traceMALLOC( pvReturn, heapALLOCATED_BLOCK_SIZE( pvReturn ) );
             }
             else
             {
@@ -256,117 +611,111 @@ void * pvPortMalloc( size_t xWantedSize )
         }
         else
         {
-            xWantedSize = 0;
+            mtCOVERAGE_TEST_MARKER();
         }
     }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
+    #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
 
-    vTaskSuspendAll();
+    if( pvReturn == NULL )
     {
-        /* Check the block size we are trying to allocate is not so large that the
-         * top bit is set.  The top bit of the block size member of the BlockLink_t
-         * structure is used to determine who owns the block - the application or
-         * the kernel, so it must be free. */
-        if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+        vTaskSuspendAll();
         {
-            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+            #if ( configHEAP_INSTRUMENTATION == 1 )
             {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
-                heapVALIDATE_BLOCK_POINTER( pxBlock );
+                ulLockedTime = configHEAP_INSTRUMENTATION_GET_TIME();
+            }
+            #endif
+
+            pvReturn = prvAllocateBlock( xWantedSize, xAlignment, uxRegionFlags );
 
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
+            #if ( heapUSE_PER_CORE_CACHE == 1 )
+            {
+                /* Blocks held in the per-core caches are not free heap space,
+                 * so they may be all that stops the request being satisfied.
+                 * If so, return the blocks of every cache to the heap, where
+                 * they coalesce with their free neighbours, and try once
+                 * more. */
+                if( ( pvReturn == NULL ) && ( prvFlushCaches() > 0U ) )
                 {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
-                    heapVALIDATE_BLOCK_POINTER( pxBlock );
+                    pvReturn = prvAllocateBlock( xWantedSize, xAlignment, uxRegionFlags );
                 }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
+                else
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock ) ) + xHeapStructSize );
-                    heapVALIDATE_BLOCK_POINTER( pvReturn );
-
-                    /* This block is being returned for use so must be taken out
-                     * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-                    /* If the block is larger than required it can be split into
-                     * two. */
-                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
-
-                    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
-                    {
-                        /* This block is to be split into two.  Create a new
-                         * block following the number of bytes requested. The void
-                         * cast is used to prevent byte alignment warnings from the
-                         * compiler. */
-                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
 
-                        /* Calculate the sizes of two blocks split from the
-                         * single block. */
-                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
+            if( pvReturn != NULL )
+            {
+                xNumberOfSuccessfulAllocations++;
+                traceMALLOC( pvReturn, heapALLOCATED_BLOCK_SIZE( pvReturn ) );
+            }
+            else
+            {
+                traceMALLOC( pvReturn, 0U );
+            }
 
-                        /* Insert the new block into the list of free blocks. */
-                        pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
-                        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
-                    }
-                    else
+            #if ( heapUSE_PER_CORE_CACHE == 1 )
+            {
+                /* The cache of the calling core had no block of this size class -
+                 * take more while the heap is locked so the next allocations of
+                 * this size class on this core do not need to lock the heap. */
+                if( ( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) && ( pvReturn != NULL ) )
+                {
+                    for( uxNumberOfRefillBlocks = 0; uxNumberOfRefillBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT; uxNumberOfRefillBlocks++ )
                     {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                        pvRefillBlocks[ uxNumberOfRefillBlocks ] = prvAllocateBlock( xWantedSize, xAlignment, uxRegionFlags );
 
-                    xFreeBytesRemaining -= pxBlock->xBlockSize;
-
-                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
-                    {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
+                        if( pvRefillBlocks[ uxNumberOfRefillBlocks ] == NULL )
+                        {
+                            break;
+                        }
                     }
-
-                    xAllocatedBlockSize = pxBlock->xBlockSize;
-
-                    /* The block is being returned - it is allocated and owned
-                     * by the application and has no "next" block. */
-                    heapALLOCATE_BLOCK( pxBlock );
-                    pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
-                    xNumberOfSuccessfulAllocations++;
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
-            else
+            #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+            #if ( configHEAP_INSTRUMENTATION == 1 )
             {
-                mtCOVERAGE_TEST_MARKER();
+                ulLockedTime = configHEAP_INSTRUMENTATION_GET_TIME() - ulLockedTime;
+                xHeapWasLocked = pdTRUE;
             }
+            #endif
         }
-        else
+        ( void ) xTaskResumeAll();
+
+        #if ( heapUSE_PER_CORE_CACHE == 1 )
         {
-            mtCOVERAGE_TEST_MARKER();
+            if( uxNumberOfRefillBlocks > 0U )
+            {
+                prvAddToCache( uxSizeClass, pvRefillBlocks, uxNumberOfRefillBlocks, pdFALSE );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
+        #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
 
-        traceMALLOC( pvReturn, xAllocatedBlockSize );
-
-        /* Prevent compiler warnings when trace macros are not used. */
-        ( void ) xAllocatedBlockSize;
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+    {
+        prvRecordAllocation( pvKey, xRequestedSize, pvReturn, xHeapWasLocked, ulLockedTime );
     }
-    ( void ) xTaskResumeAll();
+    #else
+    {
+        ( void ) pvKey;
+    }
+    #endif
 
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
@@ -381,7 +730,7 @@ void * pvPortMalloc( size_t xWantedSize )
     }
     #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
 
-    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( xAlignment - 1U ) ) == 0 );
     return pvReturn;
 }
 /*-----------------------------------------------------------*/
@@ -390,6 +739,11 @@ void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
+    BaseType_t xReturnToHeap = pdTRUE;
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxSizeClass;
+    #endif
 
     if( pv != NULL )
     {
@@ -422,15 +776,43 @@ void vPortFree( void * pv )
                 }
                 #endif
 
-                vTaskSuspendAll();
+                #if ( heapUSE_PER_CORE_CACHE == 1 )
                 {
-                    /* Add this block to the list of free blocks. */
-                    xFreeBytesRemaining += pxLink->xBlockSize;
-                    traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
-                    xNumberOfSuccessfulFrees++;
+                    uxSizeClass = prvGetBlockSizeClass( pxLink->xBlockSize );
+
+                    if( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES )
+                    {
+                        /* Small blocks are held, still marked as allocated, in
+                         * the cache of the calling core instead of being
+                         * returned to the heap. */
+                        traceFREE( pv, pxLink->xBlockSize );
+                        heapALLOCATE_BLOCK( pxLink );
+                        prvAddToCache( uxSizeClass, &pv, 1U, pdTRUE );
+                        xReturnToHeap = pdFALSE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
+                if( xReturnToHeap != pdFALSE )
+                {
+                    vTaskSuspendAll();
+                    {
+                        /* Add this block to the list of free blocks. */
+                        xFreeBytesRemaining += pxLink->xBlockSize;
+                        traceFREE( pv, pxLink->xBlockSize );
+                        prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                        xNumberOfSuccessfulFrees++;
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
-                ( void ) xTaskResumeAll();
             }
             else
             {
@@ -470,7 +852,7 @@ void * pvPortCalloc( size_t xNum,
 
     if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
     {
-        pv = pvPortMalloc( xNum * xSize );
+        pv = prvMallocAligned( xNum * xSize, ( size_t ) portBYTE_ALIGNMENT, ( UBaseType_t ) 0U, heapGET_INSTRUMENTATION_KEY() );
 
         if( pv != NULL )
         {
@@ -482,78 +864,938 @@ void * pvPortCalloc( size_t xNum,
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+void * pvPortRealloc( void * pv,
+                      size_t xWantedSize )
 {
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+    BlockLink_t * pxNextBlock;
     BlockLink_t * pxIterator;
-    uint8_t * puc;
+    BlockLink_t * pxNewBlockLink;
+    size_t xBlockSize;
+    size_t xNewBlockSize;
+    void * pvReturn = NULL;
 
-    /* Iterate through the list until a block is found that has a higher address
-     * than the block being inserted. */
-    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxBlockToInsert; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+    if( pv == NULL )
     {
-        /* Nothing to do here, just iterate to the right position. */
+        pvReturn = prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, ( UBaseType_t ) 0U, heapGET_INSTRUMENTATION_KEY() );
     }
-
-    if( pxIterator != &xStart )
+    else if( xWantedSize == 0 )
     {
-        heapVALIDATE_BLOCK_POINTER( pxIterator );
+        vPortFree( pv );
     }
+    else
+    {
+        /* The memory being resized will have an BlockLink_t structure
+         * immediately before it. */
+        puc -= xHeapStructSize;
 
-    /* Do the block being inserted, and the block it is being inserted after
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxIterator;
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxLink );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == heapPROTECT_BLOCK_POINTER( NULL ) );
+
+        xBlockSize = pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+        xNewBlockSize = prvGetWantedBlockSize( xWantedSize );
+
+        if( ( xNewBlockSize > 0 ) && ( heapBLOCK_SIZE_IS_VALID( xNewBlockSize ) != 0 ) )
+        {
+            vTaskSuspendAll();
+            {
+                if( xNewBlockSize > xBlockSize )
+                {
+                    /* The block can grow in place if the block that follows it
+                     * in memory is in the list of free blocks and is large
+                     * enough.  The list is in address order, so iterate until
+                     * a block at or above the following block is found. */
+                    pxNextBlock = ( void * ) ( puc + xBlockSize );
+
+                    /* The block may be the last one in the heap, in which
+                     * case it is followed by pxEnd, which is outside the
+                     * range checked by heapVALIDATE_BLOCK_POINTER(). */
+                    if( pxNextBlock != pxEnd )
+                    {
+                        heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxNextBlock; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+                    {
+                        /* Nothing to do here, just iterate to the right position. */
+                    }
+
+                    if( ( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) == pxNextBlock ) &&
+                        ( pxNextBlock != pxEnd ) &&
+                        ( ( xNewBlockSize - xBlockSize ) <= pxNextBlock->xBlockSize ) )
+                    {
+                        prvRemoveFromFreeList( prvGetRegion( pxNextBlock ), pxNextBlock );
+                        xFreeBytesRemaining -= pxNextBlock->xBlockSize;
+                        xBlockSize += pxNextBlock->xBlockSize;
+                        pvReturn = pv;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The block is shrinking so can always stay in place. */
+                    pvReturn = pv;
+                }
+
+                if( pvReturn != NULL )
+                {
+                    traceFREE( pv, pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK );
+
+                    /* Return the end of the block to the list of free blocks
+                     * if it is large enough to form a block of its own. */
+                    if( ( xBlockSize - xNewBlockSize ) > heapMINIMUM_BLOCK_SIZE )
+                    {
+                        pxNewBlockLink = ( void * ) ( puc + xNewBlockSize );
+                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                        pxNewBlockLink->xBlockSize = xBlockSize - xNewBlockSize;
+                        xBlockSize = xNewBlockSize;
+
+                        #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                        {
+                            ( void ) memset( ( ( uint8_t * ) pxNewBlockLink ) + xHeapStructSize, 0, pxNewBlockLink->xBlockSize - xHeapStructSize );
+                        }
+                        #endif
+
+                        xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+                        prvInsertBlockIntoFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    pxLink->xBlockSize = xBlockSize;
+                    heapALLOCATE_BLOCK( pxLink );
+                    traceMALLOC( pv, xBlockSize );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pvReturn == NULL )
+        {
+            /* The block could not be resized in place, so move it to a new
+             * block.  Like pvPortMalloc(), this places no constraint on the
+             * region the new block is in.  The new block is larger than the
+             * old one, so all the memory of the old block can be copied. */
+            pvReturn = prvMallocAligned( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, ( UBaseType_t ) 0U, heapGET_INSTRUMENTATION_KEY() );
+
+            if( pvReturn != NULL )
+            {
+                ( void ) memcpy( pvReturn, pv, xBlockSize - xHeapStructSize );
+                vPortFree( pv );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxIterator;
+    BlockLink_t * pxNextBlock;
+    RegionLink_t * pxRegion;
+    uint8_t * puc;
+
+    pxRegion = prvGetRegion( pxBlockToInsert );
+
+    /* Iterate through the list until a block is found that has a higher address
+     * than the block being inserted. */
+    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxBlockToInsert; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+    {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    if( pxIterator != &xStart )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxIterator );
+    }
+
+    pxNextBlock = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock );
+
+    /* Do the block being inserted, and the block it is being inserted after
+     * make a contiguous block of memory?  If so the block before grows, so it
+     * must be moved to the list of free blocks of its new size. */
+    puc = ( uint8_t * ) pxIterator;
+
+    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    {
+        prvRemoveFromBin( pxRegion, pxIterator );
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+    else
+    {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+        heapFREE_BLOCK_LINKS( pxBlockToInsert )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxIterator );
+        heapFREE_BLOCK_LINKS( pxNextBlock )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+        pxIterator->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+     * make a contiguous block of memory?  The end marker of a region is never
+     * merged with the block before it. */
+    puc = ( uint8_t * ) pxBlockToInsert;
+
+    if( ( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxNextBlock ) &&
+        ( pxNextBlock != pxRegion->pxRegionEnd ) )
+    {
+        /* Form one big block from the two blocks. */
+        prvRemoveFromFreeList( pxRegion, pxNextBlock );
+        pxBlockToInsert->xBlockSize += pxNextBlock->xBlockSize;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvAddToBin( pxRegion, pxBlockToInsert );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateBlock( size_t xWantedSize,
+                                size_t xAlignment,
+                                UBaseType_t uxRegionFlags ) /* PRIVILEGED_FUNCTION */
+{
+    RegionLink_t * pxRegion;
+    BlockLink_t * pxBlock = NULL;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+    void * pvReturn = NULL;
+    size_t xPadding;
+
+    /* Check the block size we are trying to allocate is not so large that the
+     * top bit is set.  The top bit of the block size member of the BlockLink_t
+     * structure is used to determine who owns the block - the application or
+     * the kernel, so it must be free. */
+    if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+    {
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            /* Search the regions that have all the requested flags, starting
+             * from the region with the lowest address, until one that has a
+             * free block of adequate size, once any padding needed to align it
+             * is skipped, is found. */
+            for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+            {
+                if( ( pxRegion->uxFlags & uxRegionFlags ) == uxRegionFlags )
+                {
+                    pxBlock = prvFindFreeBlock( pxRegion, xWantedSize, xAlignment );
+
+                    if( pxBlock != NULL )
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( pxBlock != NULL )
+            {
+                heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+                /* This block is being returned for use so must be taken out
+                 * of the list of free blocks. */
+                xPadding = prvGetAlignmentPadding( pxBlock, xAlignment );
+                pxPreviousBlock = heapPROTECT_BLOCK_POINTER( heapFREE_BLOCK_LINKS( pxBlock )->pxPreviousFreeBlock );
+                prvRemoveFromFreeList( pxRegion, pxBlock );
+
+                if( xPadding > 0U )
+                {
+                    /* Return the padding at the start of the block to the list
+                     * of free blocks as a block of its own, and allocate from
+                     * the aligned block that follows it. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xPadding );
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xPadding;
+                    pxBlock->xBlockSize = xPadding;
+                    prvAddToFreeList( pxRegion, pxBlock, pxPreviousBlock );
+                    pxPreviousBlock = pxBlock;
+                    pxBlock = pxNewBlockLink;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Return the memory space pointed to - jumping over the
+                 * BlockLink_t structure at its start. */
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                heapVALIDATE_BLOCK_POINTER( pvReturn );
+
+                /* If the block is larger than required it can be split into
+                 * two. */
+                configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+                if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                {
+                    /* This block is to be split into two.  Create a new
+                     * block following the number of bytes requested. The void
+                     * cast is used to prevent byte alignment warnings from the
+                     * compiler. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                    /* Calculate the sizes of two blocks split from the
+                     * single block. */
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    /* Insert the new block into the list of free blocks. */
+                    prvAddToFreeList( pxRegion, pxNewBlockLink, pxPreviousBlock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block is being returned - it is allocated and owned
+                 * by the application and has no "next" block. */
+                heapALLOCATE_BLOCK( pxBlock );
+                pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindFreeBlock( const RegionLink_t * pxRegion,
+                                       size_t xWantedSize,
+                                       size_t xAlignment ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock = NULL;
+    size_t xSearchSize = xWantedSize;
+    size_t xBin, xFirstFitBin, xBinMap, xPadding;
+
+    /* The padding skipped to align a block to more than portBYTE_ALIGNMENT
+     * bytes is always less than xAlignment + heapMINIMUM_BLOCK_SIZE bytes, so a
+     * block that much larger than xWantedSize is large enough wherever it
+     * starts. */
+    if( xAlignment > ( size_t ) portBYTE_ALIGNMENT )
+    {
+        if( heapADD_WILL_OVERFLOW( xSearchSize, xAlignment + heapMINIMUM_BLOCK_SIZE ) == 0 )
+        {
+            xSearchSize += xAlignment + heapMINIMUM_BLOCK_SIZE;
+        }
+        else
+        {
+            xSearchSize = heapSIZE_MAX;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Every block in the lists above the list that holds blocks of
+     * xSearchSize bytes is large enough, as is every block in that list if
+     * xSearchSize is a power of two.  The first block of the first such list
+     * that is not empty is used, so no list is searched. */
+    xFirstFitBin = prvGetBinIndex( xSearchSize );
+
+    if( ( xSearchSize & ( xSearchSize - 1U ) ) != 0U )
+    {
+        xFirstFitBin++;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xFirstFitBin < heapNUMBER_OF_BINS )
+    {
+        xBinMap = pxRegion->xBinMap & ( heapSIZE_MAX << xFirstFitBin );
+
+        if( xBinMap != ( size_t ) 0U )
+        {
+            /* xBinMap & ( ~xBinMap + 1 ) isolates the lowest set bit. */
+            xBin = prvGetBinIndex( xBinMap & ( ~xBinMap + 1U ) );
+            pxBlock = heapPROTECT_BLOCK_POINTER( pxRegion->pxBins[ xBin ] );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        xFirstFitBin = heapNUMBER_OF_BINS;
+    }
+
+    /* Blocks in the lists below xFirstFitBin may or may not be large enough.
+     * Only the first block of each list is checked, so the time taken is
+     * bounded by the number of lists rather than by the number of free blocks,
+     * at the cost of missing a large enough block that is not at the start of
+     * its list. */
+    for( xBin = prvGetBinIndex( xWantedSize ); ( pxBlock == NULL ) && ( xBin < xFirstFitBin ); xBin++ )
+    {
+        pxBlock = heapPROTECT_BLOCK_POINTER( pxRegion->pxBins[ xBin ] );
+
+        if( pxBlock != NULL )
+        {
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            xPadding = prvGetAlignmentPadding( pxBlock, xAlignment );
+
+            if( ( pxBlock->xBlockSize < xWantedSize ) || ( ( pxBlock->xBlockSize - xWantedSize ) < xPadding ) )
+            {
+                pxBlock = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetBinIndex( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+{
+    size_t xBin = 0;
+
+    /* Find the most significant bit set in the block size. */
+    while( xBlockSize > 1U )
+    {
+        xBlockSize >>= 1;
+        xBin++;
+    }
+
+    return xBin;
+}
+/*-----------------------------------------------------------*/
+
+static RegionLink_t * prvGetRegion( const BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    RegionLink_t * pxRegion = pxFirstRegion;
+
+    /* The regions are in address order, and every block in a region is below
+     * the end marker of the region. */
+    while( ( pxRegion != NULL ) && ( ( uint8_t * ) pxBlock > ( uint8_t * ) pxRegion->pxRegionEnd ) )
+    {
+        pxRegion = pxRegion->pxNextRegion;
+    }
+
+    configASSERT( pxRegion != NULL );
+
+    return pxRegion;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddToBin( RegionLink_t * pxRegion,
+                         BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    FreeBlockLinks_t * pxLinks = heapFREE_BLOCK_LINKS( pxBlock );
+    BlockLink_t * pxFirstBlock;
+    size_t xBin;
+
+    xBin = prvGetBinIndex( pxBlock->xBlockSize );
+    pxFirstBlock = heapPROTECT_BLOCK_POINTER( pxRegion->pxBins[ xBin ] );
+
+    /* Blocks are added to the front of the list. */
+    pxLinks->pxNextBinBlock = pxRegion->pxBins[ xBin ];
+    pxLinks->pxPreviousBinBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+    if( pxFirstBlock != NULL )
+    {
+        heapFREE_BLOCK_LINKS( pxFirstBlock )->pxPreviousBinBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxRegion->pxBins[ xBin ] = heapPROTECT_BLOCK_POINTER( pxBlock );
+    pxRegion->xBinMap |= ( ( size_t ) 1 ) << xBin;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFromBin( RegionLink_t * pxRegion,
+                              BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    FreeBlockLinks_t * pxLinks = heapFREE_BLOCK_LINKS( pxBlock );
+    BlockLink_t * pxNextBlock = heapPROTECT_BLOCK_POINTER( pxLinks->pxNextBinBlock );
+    BlockLink_t * pxPreviousBlock = heapPROTECT_BLOCK_POINTER( pxLinks->pxPreviousBinBlock );
+    size_t xBin;
+
+    if( pxPreviousBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxPreviousBlock );
+        heapFREE_BLOCK_LINKS( pxPreviousBlock )->pxNextBinBlock = pxLinks->pxNextBinBlock;
+    }
+    else
+    {
+        /* The block is at the front of the list. */
+        xBin = prvGetBinIndex( pxBlock->xBlockSize );
+        configASSERT( heapPROTECT_BLOCK_POINTER( pxRegion->pxBins[ xBin ] ) == pxBlock );
+        pxRegion->pxBins[ xBin ] = pxLinks->pxNextBinBlock;
+
+        if( pxNextBlock == NULL )
+        {
+            pxRegion->xBinMap &= ~( ( ( size_t ) 1 ) << xBin );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    if( pxNextBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+        heapFREE_BLOCK_LINKS( pxNextBlock )->pxPreviousBinBlock = pxLinks->pxPreviousBinBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddToFreeList( RegionLink_t * pxRegion,
+                              BlockLink_t * pxBlock,
+                              BlockLink_t * pxPreviousBlock ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxNextBlock = heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock );
+
+    pxBlock->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
+    heapFREE_BLOCK_LINKS( pxBlock )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxPreviousBlock );
+    heapFREE_BLOCK_LINKS( pxNextBlock )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+    pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+
+    prvAddToBin( pxRegion, pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFromFreeList( RegionLink_t * pxRegion,
+                                   BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxPreviousBlock = heapPROTECT_BLOCK_POINTER( heapFREE_BLOCK_LINKS( pxBlock )->pxPreviousFreeBlock );
+    BlockLink_t * pxNextBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+
+    /* Every free block is followed by another free block or by an end marker,
+     * both of which have room for a FreeBlockLinks_t structure. */
+    configASSERT( pxNextBlock != NULL );
+
+    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    heapFREE_BLOCK_LINKS( pxNextBlock )->pxPreviousFreeBlock = heapFREE_BLOCK_LINKS( pxBlock )->pxPreviousFreeBlock;
+
+    prvRemoveFromBin( pxRegion, pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetWantedBlockSize( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    size_t xAdditionalRequiredSize;
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain a BlockLink_t
+         * structure in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
-    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+            /* The block must be able to hold a FreeBlockLinks_t structure
+             * once it is freed. */
+            if( ( xWantedSize > 0 ) && ( xWantedSize < heapMINIMUM_BLOCK_SIZE ) )
+            {
+                xWantedSize = heapMINIMUM_BLOCK_SIZE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
     {
-        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
-        pxBlockToInsert = pxIterator;
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xWantedSize;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetAlignmentPadding( const BlockLink_t * pxBlock,
+                                      size_t xAlignment ) /* PRIVILEGED_FUNCTION */
+{
+    portPOINTER_SIZE_TYPE uxAddress;
+    size_t xPadding = 0;
+
+    /* Every block is already aligned to portBYTE_ALIGNMENT. */
+    if( xAlignment > ( size_t ) portBYTE_ALIGNMENT )
+    {
+        uxAddress = ( ( portPOINTER_SIZE_TYPE ) pxBlock ) + ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+        xPadding = ( size_t ) ( ( ( portPOINTER_SIZE_TYPE ) xAlignment ) - ( uxAddress & ( ( portPOINTER_SIZE_TYPE ) xAlignment - 1U ) ) );
+        xPadding &= ( xAlignment - 1U );
+
+        /* The bytes skipped at the start of the block remain free as a block
+         * of their own, so must be large enough to form a block. */
+        while( ( xPadding > 0U ) && ( xPadding < heapMINIMUM_BLOCK_SIZE ) )
+        {
+            xPadding += xAlignment;
+        }
     }
     else
     {
         mtCOVERAGE_TEST_MARKER();
     }
 
-    /* Do the block being inserted, and the block it is being inserted before
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxBlockToInsert;
+    return xPadding;
+}
+/*-----------------------------------------------------------*/
 
-    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+#if ( heapUSE_PER_CORE_CACHE == 1 )
+
+    static UBaseType_t prvGetRequestSizeClass( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxSizeClass = 0;
+
+        /* Find the smallest size class that holds blocks large enough. */
+        while( ( uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) &&
+               ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass ) < xWantedSize ) )
+        {
+            uxSizeClass++;
+        }
+
+        return uxSizeClass;
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvGetBlockSizeClass( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
     {
-        if( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) != pxEnd )
+        UBaseType_t uxSizeClass = prvGetRequestSizeClass( xBlockSize );
+
+        /* A block is only split if the remainder is large enough to form a
+         * block of its own, so a block allocated for a size class can be up to
+         * heapMINIMUM_BLOCK_SIZE bytes larger than the block size of the size
+         * class. */
+        if( ( uxSizeClass == ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES ) ||
+            ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass ) > xBlockSize ) )
         {
-            /* Form one big block from the two blocks. */
-            pxBlockToInsert->xBlockSize += heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock )->xBlockSize;
-            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock )->pxNextFreeBlock;
+            if( ( uxSizeClass > 0U ) &&
+                ( xBlockSize <= ( heapCACHE_CLASS_BLOCK_SIZE( uxSizeClass - 1U ) + heapMINIMUM_BLOCK_SIZE ) ) )
+            {
+                uxSizeClass--;
+            }
+            else
+            {
+                uxSizeClass = ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES;
+            }
         }
         else
         {
-            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+            mtCOVERAGE_TEST_MARKER();
         }
+
+        return uxSizeClass;
     }
-    else
+/*-----------------------------------------------------------*/
+
+    static void * prvTakeFromCache( UBaseType_t uxSizeClass ) /* PRIVILEGED_FUNCTION */
     {
-        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvReturn = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* The cache is accessed from a critical section that masks interrupts
+         * and holds the ISR lock, instead of the heap being locked.  Masking
+         * interrupts stops the calling task being preempted by another task
+         * using the same cache, or moving to another core.  The ISR lock stops
+         * prvFlushCaches() emptying the cache on another core at the same
+         * time. */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxCache = &( xHeapCaches[ portGET_CORE_ID() ] );
+
+            if( pxCache->uxNumberOfBlocks[ uxSizeClass ] > 0U )
+            {
+                pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                pvReturn = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                pxCache->xNumberOfAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( pvReturn != NULL )
+        {
+            /* This casting is to keep the compiler from issuing warnings. */
+            pxLink = ( void * ) ( ( ( uint8_t * ) pvReturn ) - xHeapStructSize );
+
+            configASSERT( pxLink->pxNextFreeBlock == heapCACHED_BLOCK_MARKER );
+            pxLink->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
     }
+/*-----------------------------------------------------------*/
 
-    /* If the block being inserted plugged a gap, so was merged with the block
-     * before and the block after, then it's pxNextFreeBlock pointer will have
-     * already been set, and should not be set here as that would make it point
-     * to itself. */
-    if( pxIterator != pxBlockToInsert )
+    static void prvAddToCache( UBaseType_t uxSizeClass,
+                               void * const * ppvBlocks,
+                               UBaseType_t uxNumberOfBlocks,
+                               BaseType_t xIsFree ) /* PRIVILEGED_FUNCTION */
     {
-        pxIterator->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvDrainedBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfDrainedBlocks = 0;
+        UBaseType_t uxBlock;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* Draining heapCACHE_TRANSFER_COUNT blocks from a full cache leaves
+         * room for all the blocks being added. */
+        configASSERT( uxNumberOfBlocks <= ( UBaseType_t ) heapCACHE_TRANSFER_COUNT );
+
+        for( uxBlock = 0; uxBlock < uxNumberOfBlocks; uxBlock++ )
+        {
+            /* This casting is to keep the compiler from issuing warnings. */
+            pxLink = ( void * ) ( ( ( uint8_t * ) ppvBlocks[ uxBlock ] ) - xHeapStructSize );
+            pxLink->pxNextFreeBlock = heapCACHED_BLOCK_MARKER;
+        }
+
+        /* See the comment in prvTakeFromCache(). */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxCache = &( xHeapCaches[ portGET_CORE_ID() ] );
+
+            if( xIsFree != pdFALSE )
+            {
+                pxCache->xNumberOfFrees += ( size_t ) uxNumberOfBlocks;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            for( uxBlock = 0; uxBlock < uxNumberOfBlocks; uxBlock++ )
+            {
+                if( pxCache->uxNumberOfBlocks[ uxSizeClass ] == ( UBaseType_t ) configHEAP_PER_CORE_CACHE_LENGTH )
+                {
+                    while( uxNumberOfDrainedBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT )
+                    {
+                        pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                        pvDrainedBlocks[ uxNumberOfDrainedBlocks ] = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                        uxNumberOfDrainedBlocks++;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ] = ppvBlocks[ uxBlock ];
+                pxCache->uxNumberOfBlocks[ uxSizeClass ]++;
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        if( uxNumberOfDrainedBlocks > 0U )
+        {
+            /* Return the drained blocks to the heap while it is locked once. */
+            vTaskSuspendAll();
+            {
+                for( uxBlock = 0; uxBlock < uxNumberOfDrainedBlocks; uxBlock++ )
+                {
+                    /* This casting is to keep the compiler from issuing warnings. */
+                    pxLink = ( void * ) ( ( ( uint8_t * ) pvDrainedBlocks[ uxBlock ] ) - xHeapStructSize );
+
+                    heapFREE_BLOCK( pxLink );
+                    xFreeBytesRemaining += pxLink->xBlockSize;
+                    prvInsertBlockIntoFreeList( pxLink );
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
-    else
+/*-----------------------------------------------------------*/
+
+    static size_t prvFlushCaches( void ) /* PRIVILEGED_FUNCTION */
     {
-        mtCOVERAGE_TEST_MARKER();
+        HeapCache_t * pxCache;
+        BlockLink_t * pxLink;
+        void * pvFlushedBlocks[ heapCACHE_TRANSFER_COUNT ];
+        UBaseType_t uxNumberOfTakenBlocks;
+        UBaseType_t uxCore;
+        UBaseType_t uxSizeClass;
+        UBaseType_t uxBlock;
+        size_t xNumberOfFlushedBlocks = 0;
+        UBaseType_t uxSavedInterruptStatus;
+
+        for( uxCore = 0; uxCore < ( UBaseType_t ) configNUMBER_OF_CORES; uxCore++ )
+        {
+            pxCache = &( xHeapCaches[ uxCore ] );
+
+            for( uxSizeClass = 0; uxSizeClass < ( UBaseType_t ) configHEAP_PER_CORE_CACHE_SIZE_CLASSES; uxSizeClass++ )
+            {
+                do
+                {
+                    uxNumberOfTakenBlocks = 0;
+
+                    /* The ISR lock is only held while up to
+                     * heapCACHE_TRANSFER_COUNT blocks are taken from the cache,
+                     * so the time for which interrupts are masked does not
+                     * depend on how many blocks are cached.  The caller has
+                     * locked the heap, so the blocks are returned to the heap
+                     * once the ISR lock is released. */
+                    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+                    {
+                        while( ( pxCache->uxNumberOfBlocks[ uxSizeClass ] > 0U ) &&
+                               ( uxNumberOfTakenBlocks < ( UBaseType_t ) heapCACHE_TRANSFER_COUNT ) )
+                        {
+                            pxCache->uxNumberOfBlocks[ uxSizeClass ]--;
+                            pvFlushedBlocks[ uxNumberOfTakenBlocks ] = pxCache->pvBlocks[ uxSizeClass ][ pxCache->uxNumberOfBlocks[ uxSizeClass ] ];
+                            uxNumberOfTakenBlocks++;
+                        }
+                    }
+                    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+                    for( uxBlock = 0; uxBlock < uxNumberOfTakenBlocks; uxBlock++ )
+                    {
+                        /* This casting is to keep the compiler from issuing warnings. */
+                        pxLink = ( void * ) ( ( ( uint8_t * ) pvFlushedBlocks[ uxBlock ] ) - xHeapStructSize );
+
+                        configASSERT( pxLink->pxNextFreeBlock == heapCACHED_BLOCK_MARKER );
+                        heapFREE_BLOCK( pxLink );
+                        xFreeBytesRemaining += pxLink->xBlockSize;
+                        prvInsertBlockIntoFreeList( pxLink );
+                    }
+
+                    xNumberOfFlushedBlocks += ( size_t ) uxNumberOfTakenBlocks;
+                } while( uxNumberOfTakenBlocks == ( UBaseType_t ) heapCACHE_TRANSFER_COUNT );
+            }
+        }
+
+        return xNumberOfFlushedBlocks;
     }
-}
 /*-----------------------------------------------------------*/
 
+#endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
+
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVILEGED_FUNCTION */
+{
+    vPortDefineHeapRegionsWithFlags( pxHeapRegions, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegionsWithFlags( const HeapRegion_t * const pxHeapRegions,
+                                      const UBaseType_t * const puxRegionFlags ) /* PRIVILEGED_FUNCTION */
 {
     BlockLink_t * pxFirstFreeBlockInRegion = NULL;
     BlockLink_t * pxPreviousFreeBlock;
+    RegionLink_t * pxRegion;
+    RegionLink_t * pxPreviousRegion = NULL;
+    size_t xBin;
     portPOINTER_SIZE_TYPE xAlignedHeap;
     size_t xTotalRegionSize, xTotalHeapSize = 0;
     BaseType_t xDefinedRegions = 0;
@@ -589,12 +1831,16 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVI
 
         xAlignedHeap = xAddress;
 
+        /* The region must have room for its RegionLink_t structure, a free
+         * block and its end marker. */
+        configASSERT( xTotalRegionSize > ( xRegionStructSize + ( heapMINIMUM_BLOCK_SIZE << 1 ) ) );
+
         /* Set xStart if it has not already been set. */
         if( xDefinedRegions == 0 )
         {
             /* xStart is used to hold a pointer to the first item in the list of
              *  free blocks.  The void cast is used to prevent compiler warnings. */
-            xStart.pxNextFreeBlock = ( BlockLink_t * ) heapPROTECT_BLOCK_POINTER( xAlignedHeap );
+            xStart.pxNextFreeBlock = ( BlockLink_t * ) heapPROTECT_BLOCK_POINTER( xAlignedHeap + ( portPOINTER_SIZE_TYPE ) xRegionStructSize );
             xStart.xBlockSize = ( size_t ) 0;
         }
         else
@@ -622,28 +1868,61 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVI
         pxPreviousFreeBlock = pxEnd;
 
         /* pxEnd is used to mark the end of the list of free blocks and is
-         * inserted at the end of the region space. */
+         * inserted at the end of the region space.  Like a free block, it has
+         * room for a FreeBlockLinks_t structure. */
         xAddress = xAlignedHeap + ( portPOINTER_SIZE_TYPE ) xTotalRegionSize;
-        xAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+        xAddress -= ( portPOINTER_SIZE_TYPE ) heapMINIMUM_BLOCK_SIZE;
         xAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
         pxEnd = ( BlockLink_t * ) xAddress;
         pxEnd->xBlockSize = 0;
         pxEnd->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
 
+        /* The region starts with its RegionLink_t structure, which is added
+         * to the end of the list of regions. */
+        pxRegion = ( RegionLink_t * ) xAlignedHeap;
+        pxRegion->pxNextRegion = NULL;
+        pxRegion->pxRegionEnd = pxEnd;
+        pxRegion->uxFlags = ( puxRegionFlags != NULL ) ? puxRegionFlags[ xDefinedRegions ] : ( UBaseType_t ) 0U;
+        pxRegion->xBinMap = ( size_t ) 0U;
+
+        for( xBin = 0; xBin < heapNUMBER_OF_BINS; xBin++ )
+        {
+            pxRegion->pxBins[ xBin ] = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+
+        if( pxPreviousRegion != NULL )
+        {
+            pxPreviousRegion->pxNextRegion = pxRegion;
+        }
+        else
+        {
+            pxFirstRegion = pxRegion;
+        }
+
+        pxPreviousRegion = pxRegion;
+
         /* To start with there is a single free block in this region that is
          * sized to take up the entire heap region minus the space taken by the
-         * free block structure. */
-        pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
+         * region and free block structures. */
+        pxFirstFreeBlockInRegion = ( BlockLink_t * ) ( xAlignedHeap + ( portPOINTER_SIZE_TYPE ) xRegionStructSize );
         pxFirstFreeBlockInRegion->xBlockSize = ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlockInRegion );
         pxFirstFreeBlockInRegion->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+        heapFREE_BLOCK_LINKS( pxEnd )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxFirstFreeBlockInRegion );
 
         /* If this is not the first region that makes up the entire heap space
          * then link the previous region to this region. */
         if( pxPreviousFreeBlock != NULL )
         {
             pxPreviousFreeBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxFirstFreeBlockInRegion );
+            heapFREE_BLOCK_LINKS( pxFirstFreeBlockInRegion )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxPreviousFreeBlock );
+        }
+        else
+        {
+            heapFREE_BLOCK_LINKS( pxFirstFreeBlockInRegion )->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( &xStart );
         }
 
+        prvAddToBin( pxRegion, pxFirstFreeBlockInRegion );
+
         xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
 
         #if ( configENABLE_HEAP_PROTECTOR == 1 )
@@ -674,6 +1953,10 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
     BlockLink_t * pxBlock;
     size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
 
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        UBaseType_t uxCore;
+    #endif
+
     vTaskSuspendAll();
     {
         pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
@@ -721,12 +2004,204 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
         pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
         pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
         pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+
+        #if ( heapUSE_PER_CORE_CACHE == 1 )
+        {
+            /* The critical section holds the ISR lock, so no core is using
+             * its cache. */
+            for( uxCore = 0; uxCore < ( UBaseType_t ) configNUMBER_OF_CORES; uxCore++ )
+            {
+                pxHeapStats->xNumberOfSuccessfulAllocations += xHeapCaches[ uxCore ].xNumberOfAllocations;
+                pxHeapStats->xNumberOfSuccessfulFrees += xHeapCaches[ uxCore ].xNumberOfFrees;
+            }
+        }
+        #endif /* if ( heapUSE_PER_CORE_CACHE == 1 ) */
         pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+
+        heapISR_POOL_GET_STATS( pxHeapStats );
     }
     taskEXIT_CRITICAL();
 }
 /*-----------------------------------------------------------*/
 
+#if ( configHEAP_INSTRUMENTATION == 1 )
+
+    static void prvRecordAllocation( void * pvKey,
+                                     size_t xWantedSize,
+                                     const void * pvReturn,
+                                     BaseType_t xHeapWasLocked,
+                                     uint32_t ulLockedTime ) /* PRIVILEGED_FUNCTION */
+    {
+        size_t xCounter = 0;
+
+        taskENTER_CRITICAL();
+        {
+            if( xHeapWasLocked != pdFALSE )
+            {
+                if( ulLockedTime < ulMinimumAllocationTime )
+                {
+                    ulMinimumAllocationTime = ulLockedTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ulLockedTime > ulMaximumAllocationTime )
+                {
+                    ulMaximumAllocationTime = ulLockedTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Halve the total time and the number of allocations it was
+                 * measured over, rather than let the total overflow, so the
+                 * average remains valid. */
+                if( ulTotalAllocationTime > ( heapUINT32_MAX - ulLockedTime ) )
+                {
+                    ulTotalAllocationTime /= 2U;
+                    xNumberOfTimedAllocations /= 2U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                ulTotalAllocationTime += ulLockedTime;
+                xNumberOfTimedAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Find the counter for this key, or claim an unused one if this is
+             * the first allocation made with the key. */
+            while( ( xCounter < xNumberOfAllocationCounters ) && ( xAllocationCounters[ xCounter ].pvKey != pvKey ) )
+            {
+                xCounter++;
+            }
+
+            if( ( xCounter == xNumberOfAllocationCounters ) && ( xCounter < ( size_t ) configHEAP_INSTRUMENTATION_NUMBER_OF_KEYS ) )
+            {
+                ( void ) memset( &( xAllocationCounters[ xCounter ] ), 0, sizeof( HeapAllocationCounter_t ) );
+                xAllocationCounters[ xCounter ].pvKey = pvKey;
+                xNumberOfAllocationCounters++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xCounter == xNumberOfAllocationCounters )
+            {
+                xNumberOfUntrackedAllocations++;
+            }
+            else if( pvReturn != NULL )
+            {
+                xAllocationCounters[ xCounter ].xNumberOfAllocations++;
+                xAllocationCounters[ xCounter ].xBytesAllocated += xWantedSize;
+            }
+            else
+            {
+                xAllocationCounters[ xCounter ].xNumberOfFailedAllocations++;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortGetHeapInstrumentation( HeapInstrumentation_t * pxHeapInstrumentation )
+    {
+        BlockLink_t * pxBlock;
+        size_t xBucket;
+        size_t xSize;
+
+        ( void ) memset( pxHeapInstrumentation->xFreeBlockHistogram, 0, sizeof( pxHeapInstrumentation->xFreeBlockHistogram ) );
+
+        vTaskSuspendAll();
+        {
+            pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+
+            /* pxBlock will be NULL if the heap has not been initialised.  The
+             * heap is initialised automatically when the first allocation is
+             * made. */
+            if( pxBlock != NULL )
+            {
+                while( pxBlock != pxEnd )
+                {
+                    /* Entry n of the histogram counts blocks whose size has its
+                     * most significant bit at heapHISTOGRAM_FIRST_BUCKET_SHIFT + n. */
+                    xBucket = 0;
+                    xSize = pxBlock->xBlockSize >> ( heapHISTOGRAM_FIRST_BUCKET_SHIFT + 1U );
+
+                    while( ( xSize > 0U ) && ( xBucket < ( ( size_t ) configHEAP_INSTRUMENTATION_HISTOGRAM_BUCKETS - 1U ) ) )
+                    {
+                        xSize >>= 1;
+                        xBucket++;
+                    }
+
+                    /* Skip the zero sized block at the end of each heap region,
+                     * which only links to the next region. */
+                    if( pxBlock->xBlockSize != 0 )
+                    {
+                        pxHeapInstrumentation->xFreeBlockHistogram[ xBucket ]++;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* Move to the next block in the chain until the last block
+                     * is reached. */
+                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        taskENTER_CRITICAL();
+        {
+            if( xNumberOfTimedAllocations > 0U )
+            {
+                pxHeapInstrumentation->ulMinimumAllocationTime = ulMinimumAllocationTime;
+                pxHeapInstrumentation->ulAverageAllocationTime = ulTotalAllocationTime / ( uint32_t ) xNumberOfTimedAllocations;
+            }
+            else
+            {
+                pxHeapInstrumentation->ulMinimumAllocationTime = 0U;
+                pxHeapInstrumentation->ulAverageAllocationTime = 0U;
+            }
+
+            pxHeapInstrumentation->ulMaximumAllocationTime = ulMaximumAllocationTime;
+            pxHeapInstrumentation->xNumberOfTimedAllocations = xNumberOfTimedAllocations;
+            pxHeapInstrumentation->xNumberOfUntrackedAllocations = xNumberOfUntrackedAllocations;
+            pxHeapInstrumentation->xNumberOfAllocationCounters = xNumberOfAllocationCounters;
+            ( void ) memcpy( pxHeapInstrumentation->xAllocationCounters, xAllocationCounters, sizeof( xAllocationCounters ) );
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortResetHeapInstrumentation( void )
+    {
+        taskENTER_CRITICAL();
+        {
+            xNumberOfAllocationCounters = ( size_t ) 0U;
+            xNumberOfUntrackedAllocations = ( size_t ) 0U;
+            xNumberOfTimedAllocations = ( size_t ) 0U;
+            ulMinimumAllocationTime = heapUINT32_MAX;
+            ulMaximumAllocationTime = 0U;
+            ulTotalAllocationTime = 0U;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configHEAP_INSTRUMENTATION == 1 ) */
+
 /*
  * Reset the state in this file. This state is normally initialized at start up.
  * This function must be called by the application before restarting the
@@ -735,6 +2210,7 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 void vPortHeapResetState( void )
 {
     pxEnd = NULL;
+    pxFirstRegion = NULL;
 
     xFreeBytesRemaining = ( size_t ) 0U;
     xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
@@ -745,5 +2221,20 @@ void vPortHeapResetState( void )
         pucHeapHighAddress = NULL;
         pucHeapLowAddress = NULL;
     #endif /* #if ( configENABLE_HEAP_PROTECTOR == 1 ) */
+
+    #if ( heapUSE_PER_CORE_CACHE == 1 )
+        ( void ) memset( xHeapCaches, 0, sizeof( xHeapCaches ) );
+    #endif
+
+    #if ( configHEAP_INSTRUMENTATION == 1 )
+        xNumberOfAllocationCounters = ( size_t ) 0U;
+        xNumberOfUntrackedAllocations = ( size_t ) 0U;
+        xNumberOfTimedAllocations = ( size_t ) 0U;
+        ulMinimumAllocationTime = heapUINT32_MAX;
+        ulMaximumAllocationTime = 0U;
+        ulTotalAllocationTime = 0U;
+    #endif
+
+    heapISR_POOL_RESET_STATE();
 }
 /*-----------------------------------------------------------*/
@@ -0,0 +1,1036 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that executes in
+ * constant time, regardless of the number of free blocks, using a Two-Level
+ * Segregated Fit (TLSF) allocator.  Like heap_5.c the heap can be defined across
+ * multiple non-contiguous blocks of memory, and adjacent free blocks are
+ * combined as soon as they are freed.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ *
+ * Free blocks are held in a two dimensional array of lists.  The first level
+ * index is the power of two below the size of the block, and the second level
+ * index divides each power of two into 2 ^ configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2
+ * equally sized ranges.  A bitmap records which lists are not empty, so a list
+ * that holds a block large enough to satisfy a request is found with two bit
+ * scans rather than by walking the blocks.  Each block also records the block
+ * that precedes it in memory, so a block being freed is combined with both its
+ * neighbours without searching.
+ *
+ * As a request is rounded up to the start of the next second level range, a
+ * request can fail when the only block that is large enough is less than
+ * 1 / ( 2 ^ configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 ) larger than the request.
+ *
+ * Usage notes:
+ *
+ * vPortDefineHeapRegions() ***must*** be called before pvPortMalloc(), exactly
+ * as when heap_5.c is used.  pvPortMalloc() will be called if any task objects
+ * (tasks, queues, event groups, etc.) are created, therefore
+ * vPortDefineHeapRegions() ***must*** be called before any other objects are
+ * defined.
+ *
+ * vPortDefineHeapRegions() takes a single parameter.  The parameter is an array
+ * of HeapRegion_t structures, terminated using a NULL zero sized region
+ * definition.  See heap_5.c for an example.
+ *
+ * configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 sets the number of second level
+ * ranges per power of two, and so how closely the size of the block used
+ * matches the size of the block requested.  It defaults to 4 (16 ranges).
+ * configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 sets the number of first level indexes, so
+ * each heap region must be smaller than 2 ^ configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2
+ * bytes.  It defaults to one less than the number of bits in a size_t.  The
+ * array of list heads holds 2 ^ configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 pointers
+ * for each first level index, so reducing either value reduces the RAM used by
+ * the allocator.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* pvPortMallocFromISR() and vPortFreeFromISR() are implemented by the pool of
+ * fixed size blocks that heap_4.c, heap_5.c and heap_6.c share. */
+#include "heap_isr_pool.h"
+
+#ifndef configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2
+    #define configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2    4
+#endif
+
+#if ( ( configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 < 1 ) || ( configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 > 5 ) )
+    #error configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 must be between 1 and 5
+#endif
+
+#ifndef configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2
+    #define configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2    ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1U )
+#endif
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )     ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )          ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* Check if the subtraction operation ( a - b ) will result in underflow. */
+#define heapSUBTRACT_WILL_UNDERFLOW( a, b )    ( ( a ) < ( b ) )
+
+/* MSB of the xBlockSize member of an BlockLink_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * an BlockLink_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_SIZE_IS_VALID( xBlockSize )    ( ( ( xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) == 0 )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+
+/* Block sizes are always a multiple of portBYTE_ALIGNMENT, so the blocks smaller
+ * than heapSMALL_BLOCK_SIZE are held in first level list 0, with one second
+ * level list for each possible size. */
+#if portBYTE_ALIGNMENT == 32
+    #define heapBYTE_ALIGNMENT_LOG2    ( 5U )
+#elif portBYTE_ALIGNMENT == 16
+    #define heapBYTE_ALIGNMENT_LOG2    ( 4U )
+#elif portBYTE_ALIGNMENT == 8
+    #define heapBYTE_ALIGNMENT_LOG2    ( 3U )
+#elif portBYTE_ALIGNMENT == 4
+    #define heapBYTE_ALIGNMENT_LOG2    ( 2U )
+#elif portBYTE_ALIGNMENT == 2
+    #define heapBYTE_ALIGNMENT_LOG2    ( 1U )
+#else
+    #define heapBYTE_ALIGNMENT_LOG2    ( 0U )
+#endif
+
+#define heapSECOND_LEVEL_INDEX_LOG2      ( ( UBaseType_t ) configHEAP_TLSF_SECOND_LEVEL_INDEX_LOG2 )
+#define heapSECOND_LEVEL_INDEX_COUNT     ( ( UBaseType_t ) 1U << heapSECOND_LEVEL_INDEX_LOG2 )
+#define heapFIRST_LEVEL_INDEX_SHIFT      ( heapSECOND_LEVEL_INDEX_LOG2 + heapBYTE_ALIGNMENT_LOG2 )
+#define heapFIRST_LEVEL_INDEX_COUNT      ( ( configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 - heapFIRST_LEVEL_INDEX_SHIFT ) + 1U )
+#define heapSMALL_BLOCK_SIZE             ( ( size_t ) 1U << heapFIRST_LEVEL_INDEX_SHIFT )
+#define heapMAXIMUM_BLOCK_SIZE           ( ( ( size_t ) 1U << ( configHEAP_TLSF_MAX_BLOCK_SIZE_LOG2 ) ) - 1U )
+
+/* Setting configENABLE_HEAP_PROTECTOR to 1 enables heap block pointers
+ * protection using an application supplied canary value to catch heap
+ * corruption should a heap buffer overflow occur.
+ */
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+
+/* Macro to load/store BlockLink_t pointers to memory. By XORing the
+ * pointers with a random canary value, heap overflows will result
+ * in randomly unpredictable pointer values which will be caught by
+ * heapVALIDATE_BLOCK_POINTER assert. */
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( ( BlockLink_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxBlock ) ) ^ xHeapCanary ) )
+
+/* Assert that a heap block pointer is within the heap bounds.
+ * Setting configVALIDATE_HEAP_BLOCK_POINTER to 1 enables customized heap block pointers
+ * protection on heap_6. */
+    #ifndef configVALIDATE_HEAP_BLOCK_POINTER
+        #define heapVALIDATE_BLOCK_POINTER( pxBlock )                           \
+            configASSERT( ( pucHeapHighAddress != NULL ) &&                     \
+                          ( pucHeapLowAddress != NULL ) &&                      \
+                          ( ( uint8_t * ) ( pxBlock ) >= pucHeapLowAddress ) && \
+                          ( ( uint8_t * ) ( pxBlock ) < pucHeapHighAddress ) )
+    #else /* ifndef configVALIDATE_HEAP_BLOCK_POINTER */
+        #define heapVALIDATE_BLOCK_POINTER( pxBlock )                           \
+            configVALIDATE_HEAP_BLOCK_POINTER( pxBlock )
+    #endif /* configVALIDATE_HEAP_BLOCK_POINTER */
+
+#else /* if ( configENABLE_HEAP_PROTECTOR == 1 ) */
+
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( pxBlock )
+
+    #define heapVALIDATE_BLOCK_POINTER( pxBlock )
+
+#endif /* configENABLE_HEAP_PROTECTOR */
+
+/*-----------------------------------------------------------*/
+
+/* Define the structure placed at the start of each block.  Only the first two
+ * members are present in an allocated block - the free list pointers overlay
+ * the start of the memory returned to the application, so are only valid while
+ * the block is free. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxPreviousPhysicalBlock; /**< The block immediately before this one in memory, or NULL for the first block in a region. */
+    size_t xBlockSize;                             /**< The size of the block, including this structure. */
+    struct A_BLOCK_LINK * pxNextFreeBlock;         /**< The next block in the same free list. */
+    struct A_BLOCK_LINK * pxPreviousFreeBlock;     /**< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Calculate the first and second level indexes of the free list that holds
+ * blocks of size xBlockSize.
+ */
+static void prvMapBlockSizeToIndexes( size_t xBlockSize,
+                                      UBaseType_t * puxFirstLevelIndex,
+                                      UBaseType_t * puxSecondLevelIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return a free block that is at least xWantedSize bytes, or NULL if no such
+ * block can be found without searching a list.  The indexes of the list that
+ * holds the block are returned in *puxFirstLevelIndex and *puxSecondLevelIndex.
+ */
+static BlockLink_t * prvFindSuitableBlock( size_t xWantedSize,
+                                           UBaseType_t * puxFirstLevelIndex,
+                                           UBaseType_t * puxSecondLevelIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a free block to the head of the free list that holds blocks of its size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove a free block from the free list that holds blocks of its size.
+ */
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove,
+                                        UBaseType_t uxFirstLevelIndex,
+                                        UBaseType_t uxSecondLevelIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Merge a block that is being freed with the block in front of it and/or the
+ * block behind it if those blocks are also free.  Returns the merged block.
+ */
+static BlockLink_t * prvMergeWithFreeNeighbours( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the index of the most significant set bit in xValue, which must not
+ * be zero.
+ */
+static UBaseType_t prvFindLastSetBit( size_t xValue ) PRIVILEGED_FUNCTION;
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
+
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+
+/**
+ * @brief Application provided function to get a random value to be used as canary.
+ *
+ * @param pxHeapCanary [out] Output parameter to return the canary value.
+ */
+    extern void vApplicationGetRandomHeapCanary( portPOINTER_SIZE_TYPE * pxHeapCanary );
+#endif /* configENABLE_HEAP_PROTECTOR */
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+ * block must by correctly byte aligned. */
+static const size_t xHeapStructSize = ( offsetof( BlockLink_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Block sizes must not get too small - a free block must be able to hold the
+ * free list pointers. */
+static const size_t xHeapMinimumBlockSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The heads of the free lists, and bitmaps that record which of the lists are
+ * not empty.  Bit n of xFirstLevelBitmap is set if any bit is set in
+ * xSecondLevelBitmaps[ n ], and bit m of xSecondLevelBitmaps[ n ] is set if
+ * pxFreeLists[ n ][ m ] is not empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapFIRST_LEVEL_INDEX_COUNT ][ heapSECOND_LEVEL_INDEX_COUNT ];
+PRIVILEGED_DATA static size_t xFirstLevelBitmap = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xSecondLevelBitmaps[ heapFIRST_LEVEL_INDEX_COUNT ];
+
+/* Set once vPortDefineHeapRegions() has been called. */
+PRIVILEGED_DATA static BaseType_t xHeapRegionsDefined = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+
+/* Canary value for protecting internal heap pointers. */
+    PRIVILEGED_DATA static portPOINTER_SIZE_TYPE xHeapCanary;
+
+/* Highest and lowest heap addresses used for heap block bounds checking. */
+    PRIVILEGED_DATA static uint8_t * pucHeapHighAddress = NULL;
+    PRIVILEGED_DATA static uint8_t * pucHeapLowAddress = NULL;
+
+#endif /* configENABLE_HEAP_PROTECTOR */
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxNewBlockLink;
+    BlockLink_t * pxNextPhysicalBlock;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    size_t xAllocatedBlockSize = 0;
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    /* The heap must be initialised before the first call to
+     * pvPortMalloc(). */
+    configASSERT( xHeapRegionsDefined != pdFALSE );
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain a BlockLink_t
+         * structure in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The block must be able to hold the free list pointers once it
+             * is freed. */
+            if( ( xWantedSize > 0 ) && ( xWantedSize < xHeapMinimumBlockSize ) )
+            {
+                xWantedSize = xHeapMinimumBlockSize;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    vTaskSuspendAll();
+    {
+        /* Check the block size we are trying to allocate is not so large that the
+         * top bit is set.  The top bit of the block size member of the BlockLink_t
+         * structure is used to determine who owns the block - the application or
+         * the kernel, so it must be free. */
+        if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+        {
+            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+            {
+                pxBlock = prvFindSuitableBlock( xWantedSize, &uxFirstLevelIndex, &uxSecondLevelIndex );
+
+                if( pxBlock != NULL )
+                {
+                    /* This block is being returned for use so must be taken out
+                     * of the list of free blocks. */
+                    prvRemoveBlockFromFreeList( pxBlock, uxFirstLevelIndex, uxSecondLevelIndex );
+
+                    /* If the block is larger than required it can be split into
+                     * two. */
+                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+                    if( ( pxBlock->xBlockSize - xWantedSize ) >= xHeapMinimumBlockSize )
+                    {
+                        /* This block is to be split into two.  Create a new
+                         * block following the number of bytes requested. The void
+                         * cast is used to prevent byte alignment warnings from the
+                         * compiler. */
+                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                        /* Calculate the sizes of two blocks split from the
+                         * single block. */
+                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                        pxBlock->xBlockSize = xWantedSize;
+
+                        /* The new block lies between the block being returned
+                         * and the block that followed it in memory. */
+                        pxNextPhysicalBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlockLink ) + pxNewBlockLink->xBlockSize );
+                        pxNewBlockLink->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+                        pxNextPhysicalBlock->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+
+                        /* Insert the new block into the list of free blocks.  The
+                         * block that follows it in memory is allocated, as free
+                         * blocks are always merged with their neighbours, so it
+                         * does not need to be merged. */
+                        prvInsertBlockIntoFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xAllocatedBlockSize = pxBlock->xBlockSize;
+
+                    /* Return the memory space pointed to - jumping over the
+                     * BlockLink_t structure at its start.  The block is
+                     * allocated and owned by the application. */
+                    heapALLOCATE_BLOCK( pxBlock );
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                    heapVALIDATE_BLOCK_POINTER( pvReturn );
+                    xNumberOfSuccessfulAllocations++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xAllocatedBlockSize );
+
+        /* Prevent compiler warnings when trace macros are not used. */
+        ( void ) xAllocatedBlockSize;
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have an BlockLink_t structure immediately
+         * before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxLink );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+
+        if( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 )
+        {
+            /* The block is being returned to the heap - it is no longer
+             * allocated. */
+            heapFREE_BLOCK( pxLink );
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                /* Check for underflow as this can occur if xBlockSize is
+                 * overwritten in a heap block. */
+                if( heapSUBTRACT_WILL_UNDERFLOW( pxLink->xBlockSize, xHeapStructSize ) == 0 )
+                {
+                    ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+                }
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                /* Add this block to the list of free blocks. */
+                xFreeBytesRemaining += pxLink->xBlockSize;
+                traceFREE( pv, pxLink->xBlockSize );
+                prvInsertBlockIntoFreeList( prvMergeWithFreeNeighbours( pxLink ) );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void xPortResetHeapMinimumEverFreeHeapSize( void )
+{
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSetBit( size_t xValue ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxBit = 0U;
+    UBaseType_t uxShift;
+
+    /* A binary search, so the number of iterations only depends on the width of
+     * size_t. */
+    for( uxShift = ( UBaseType_t ) ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) >> 1 ); uxShift > 0U; uxShift >>= 1 )
+    {
+        if( ( xValue >> uxShift ) != ( size_t ) 0U )
+        {
+            xValue >>= uxShift;
+            uxBit += uxShift;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapBlockSizeToIndexes( size_t xBlockSize,
+                                      UBaseType_t * puxFirstLevelIndex,
+                                      UBaseType_t * puxSecondLevelIndex ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxMostSignificantBit;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        /* Small blocks are held in first level list 0, with one second level
+         * list per block size. */
+        *puxFirstLevelIndex = 0U;
+        *puxSecondLevelIndex = ( UBaseType_t ) ( xBlockSize >> heapBYTE_ALIGNMENT_LOG2 );
+    }
+    else
+    {
+        /* The first level index is set by the most significant bit of the
+         * block size, and the second level index by the bits below it. */
+        uxMostSignificantBit = prvFindLastSetBit( xBlockSize );
+        *puxFirstLevelIndex = ( UBaseType_t ) ( ( uxMostSignificantBit - heapFIRST_LEVEL_INDEX_SHIFT ) + 1U );
+        *puxSecondLevelIndex = ( UBaseType_t ) ( ( xBlockSize >> ( uxMostSignificantBit - heapSECOND_LEVEL_INDEX_LOG2 ) ) & ( ( size_t ) heapSECOND_LEVEL_INDEX_COUNT - 1U ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindSuitableBlock( size_t xWantedSize,
+                                           UBaseType_t * puxFirstLevelIndex,
+                                           UBaseType_t * puxSecondLevelIndex ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock = NULL;
+    size_t xFirstLevelMap, xSecondLevelMap = ( size_t ) 0U;
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    /* Round the size up to the start of the next second level range, so any
+     * block in the list found is large enough and the list does not need to be
+     * searched. */
+    if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xWantedSize += ( ( size_t ) 1U << ( prvFindLastSetBit( xWantedSize ) - heapSECOND_LEVEL_INDEX_LOG2 ) ) - 1U;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvMapBlockSizeToIndexes( xWantedSize, &uxFirstLevelIndex, &uxSecondLevelIndex );
+
+    if( uxFirstLevelIndex < ( UBaseType_t ) heapFIRST_LEVEL_INDEX_COUNT )
+    {
+        /* Look for a non-empty list in the same first level range that holds
+         * blocks at least as large as the rounded size. */
+        xSecondLevelMap = xSecondLevelBitmaps[ uxFirstLevelIndex ] & ( heapSIZE_MAX << uxSecondLevelIndex );
+
+        if( xSecondLevelMap == ( size_t ) 0U )
+        {
+            /* There is no such list, so use the smallest block in the next
+             * non-empty first level range. */
+            if( ( uxFirstLevelIndex + 1U ) < ( UBaseType_t ) heapFIRST_LEVEL_INDEX_COUNT )
+            {
+                xFirstLevelMap = xFirstLevelBitmap & ( heapSIZE_MAX << ( uxFirstLevelIndex + 1U ) );
+
+                if( xFirstLevelMap != ( size_t ) 0U )
+                {
+                    uxFirstLevelIndex = prvFindLastSetBit( xFirstLevelMap & ( ~xFirstLevelMap + 1U ) );
+                    xSecondLevelMap = xSecondLevelBitmaps[ uxFirstLevelIndex ];
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xSecondLevelMap != ( size_t ) 0U )
+        {
+            uxSecondLevelIndex = prvFindLastSetBit( xSecondLevelMap & ( ~xSecondLevelMap + 1U ) );
+            pxBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] );
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            configASSERT( pxBlock != NULL );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    *puxFirstLevelIndex = uxFirstLevelIndex;
+    *puxSecondLevelIndex = uxSecondLevelIndex;
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstBlock;
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    prvMapBlockSizeToIndexes( pxBlockToInsert->xBlockSize, &uxFirstLevelIndex, &uxSecondLevelIndex );
+    configASSERT( uxFirstLevelIndex < ( UBaseType_t ) heapFIRST_LEVEL_INDEX_COUNT );
+
+    pxFirstBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] );
+
+    pxBlockToInsert->pxNextFreeBlock = pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ];
+    pxBlockToInsert->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+    if( pxFirstBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxFirstBlock );
+        pxFirstBlock->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+
+    /* Record that neither the list nor its first level range are empty. */
+    xFirstLevelBitmap |= ( ( size_t ) 1U << uxFirstLevelIndex );
+    xSecondLevelBitmaps[ uxFirstLevelIndex ] |= ( ( size_t ) 1U << uxSecondLevelIndex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove,
+                                        UBaseType_t uxFirstLevelIndex,
+                                        UBaseType_t uxSecondLevelIndex ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxNextBlock = heapPROTECT_BLOCK_POINTER( pxBlockToRemove->pxNextFreeBlock );
+    BlockLink_t * pxPreviousBlock = heapPROTECT_BLOCK_POINTER( pxBlockToRemove->pxPreviousFreeBlock );
+
+    if( pxNextBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+        pxNextBlock->pxPreviousFreeBlock = pxBlockToRemove->pxPreviousFreeBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxPreviousBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxPreviousBlock );
+        pxPreviousBlock->pxNextFreeBlock = pxBlockToRemove->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block is at the head of its list. */
+        configASSERT( heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] ) == pxBlockToRemove );
+        pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] = pxBlockToRemove->pxNextFreeBlock;
+
+        if( pxNextBlock == NULL )
+        {
+            /* The list is now empty. */
+            xSecondLevelBitmaps[ uxFirstLevelIndex ] &= ~( ( size_t ) 1U << uxSecondLevelIndex );
+
+            if( xSecondLevelBitmaps[ uxFirstLevelIndex ] == ( size_t ) 0U )
+            {
+                xFirstLevelBitmap &= ~( ( size_t ) 1U << uxFirstLevelIndex );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvMergeWithFreeNeighbours( BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxNeighbour;
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    /* Is the block behind this block in memory free?  The last block in each
+     * region is a zero sized block that is marked as allocated, so there is
+     * always a block behind a block that can be freed. */
+    pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+
+    if( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 )
+    {
+        /* Form one big block from the two blocks. */
+        prvMapBlockSizeToIndexes( pxNeighbour->xBlockSize, &uxFirstLevelIndex, &uxSecondLevelIndex );
+        prvRemoveBlockFromFreeList( pxNeighbour, uxFirstLevelIndex, uxSecondLevelIndex );
+        pxBlock->xBlockSize += pxNeighbour->xBlockSize;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Is the block in front of this block in memory free? */
+    pxNeighbour = heapPROTECT_BLOCK_POINTER( pxBlock->pxPreviousPhysicalBlock );
+
+    if( pxNeighbour != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxNeighbour );
+
+        if( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 )
+        {
+            /* Form one big block from the two blocks. */
+            prvMapBlockSizeToIndexes( pxNeighbour->xBlockSize, &uxFirstLevelIndex, &uxSecondLevelIndex );
+            prvRemoveBlockFromFreeList( pxNeighbour, uxFirstLevelIndex, uxSecondLevelIndex );
+            pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+            pxBlock = pxNeighbour;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* The block now in front of the block that follows the merged block in
+     * memory is the merged block. */
+    pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+    pxNeighbour->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstFreeBlockInRegion;
+    BlockLink_t * pxEndOfRegion;
+    portPOINTER_SIZE_TYPE xAlignedHeap;
+    size_t xTotalRegionSize, xTotalHeapSize = 0;
+    BaseType_t xDefinedRegions = 0;
+    portPOINTER_SIZE_TYPE xAddress;
+    const HeapRegion_t * pxHeapRegion;
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    /* Can only call once! */
+    configASSERT( xHeapRegionsDefined == pdFALSE );
+
+    /* The bitmaps must have one bit per list. */
+    configASSERT( ( size_t ) heapFIRST_LEVEL_INDEX_COUNT <= ( sizeof( size_t ) * heapBITS_PER_BYTE ) );
+    configASSERT( ( size_t ) heapSECOND_LEVEL_INDEX_COUNT <= ( sizeof( size_t ) * heapBITS_PER_BYTE ) );
+
+    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+    {
+        vApplicationGetRandomHeapCanary( &( xHeapCanary ) );
+    }
+    #endif
+
+    /* All the free lists start empty. */
+    for( uxFirstLevelIndex = 0U; uxFirstLevelIndex < ( UBaseType_t ) heapFIRST_LEVEL_INDEX_COUNT; uxFirstLevelIndex++ )
+    {
+        for( uxSecondLevelIndex = 0U; uxSecondLevelIndex < heapSECOND_LEVEL_INDEX_COUNT; uxSecondLevelIndex++ )
+        {
+            pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+
+        xSecondLevelBitmaps[ uxFirstLevelIndex ] = ( size_t ) 0U;
+    }
+
+    xFirstLevelBitmap = ( size_t ) 0U;
+
+    pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+    while( pxHeapRegion->xSizeInBytes > 0 )
+    {
+        xTotalRegionSize = pxHeapRegion->xSizeInBytes;
+
+        /* Ensure the heap region starts on a correctly aligned boundary. */
+        xAddress = ( portPOINTER_SIZE_TYPE ) pxHeapRegion->pucStartAddress;
+
+        if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+        {
+            xAddress += ( portBYTE_ALIGNMENT - 1 );
+            xAddress &= ~( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK;
+
+            /* Adjust the size for the bytes lost to alignment. */
+            xTotalRegionSize -= ( size_t ) ( xAddress - ( portPOINTER_SIZE_TYPE ) pxHeapRegion->pucStartAddress );
+        }
+
+        xAlignedHeap = xAddress;
+
+        /* A zero sized block that is marked as allocated is placed at the end
+         * of the region, so blocks are never merged across the end of a
+         * region. */
+        xAddress = xAlignedHeap + ( portPOINTER_SIZE_TYPE ) xTotalRegionSize;
+        xAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+        xAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+        pxEndOfRegion = ( BlockLink_t * ) xAddress;
+
+        /* To start with there is a single free block in this region that is
+         * sized to take up the entire heap region minus the space taken by the
+         * block at the end of the region. */
+        pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
+        pxFirstFreeBlockInRegion->xBlockSize = ( size_t ) ( xAddress - xAlignedHeap );
+        pxFirstFreeBlockInRegion->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+        /* Check the region is large enough to hold a block, and is not too
+         * large to be mapped onto a free list. */
+        configASSERT( pxFirstFreeBlockInRegion->xBlockSize >= xHeapMinimumBlockSize );
+        configASSERT( pxFirstFreeBlockInRegion->xBlockSize <= heapMAXIMUM_BLOCK_SIZE );
+
+        pxEndOfRegion->xBlockSize = 0;
+        heapALLOCATE_BLOCK( pxEndOfRegion );
+        pxEndOfRegion->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxFirstFreeBlockInRegion );
+
+        #if ( configENABLE_HEAP_PROTECTOR == 1 )
+        {
+            if( ( pucHeapLowAddress == NULL ) ||
+                ( ( uint8_t * ) xAlignedHeap < pucHeapLowAddress ) )
+            {
+                pucHeapLowAddress = ( uint8_t * ) xAlignedHeap;
+            }
+
+            if( ( pucHeapHighAddress == NULL ) ||
+                ( ( uint8_t * ) pxEndOfRegion > pucHeapHighAddress ) )
+            {
+                pucHeapHighAddress = ( uint8_t * ) pxEndOfRegion;
+            }
+        }
+        #endif /* configENABLE_HEAP_PROTECTOR */
+
+        prvInsertBlockIntoFreeList( pxFirstFreeBlockInRegion );
+
+        xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
+
+        /* Move onto the next HeapRegion_t structure. */
+        xDefinedRegions++;
+        pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+    }
+
+    xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+    xFreeBytesRemaining = xTotalHeapSize;
+
+    /* Check something was actually defined before it is accessed. */
+    configASSERT( xTotalHeapSize );
+
+    xHeapRegionsDefined = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockLink_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    UBaseType_t uxFirstLevelIndex, uxSecondLevelIndex;
+
+    vTaskSuspendAll();
+    {
+        /* The free lists are only valid once the heap regions have been
+         * defined. */
+        if( xHeapRegionsDefined != pdFALSE )
+        {
+            for( uxFirstLevelIndex = 0U; uxFirstLevelIndex < ( UBaseType_t ) heapFIRST_LEVEL_INDEX_COUNT; uxFirstLevelIndex++ )
+            {
+                for( uxSecondLevelIndex = 0U; uxSecondLevelIndex < heapSECOND_LEVEL_INDEX_COUNT; uxSecondLevelIndex++ )
+                {
+                    pxBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevelIndex ][ uxSecondLevelIndex ] );
+
+                    while( pxBlock != NULL )
+                    {
+                        heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+                        /* Increment the number of blocks and record the largest
+                         * and smallest blocks seen so far. */
+                        xBlocks++;
+
+                        if( pxBlock->xBlockSize > xMaxSize )
+                        {
+                            xMaxSize = pxBlock->xBlockSize;
+                        }
+
+                        if( pxBlock->xBlockSize < xMinSize )
+                        {
+                            xMinSize = pxBlock->xBlockSize;
+                        }
+
+                        pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+
+        heapISR_POOL_GET_STATS( pxHeapStats );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    xHeapRegionsDefined = pdFALSE;
+    xFirstLevelBitmap = ( size_t ) 0U;
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+        pucHeapHighAddress = NULL;
+        pucHeapLowAddress = NULL;
+    #endif /* #if ( configENABLE_HEAP_PROTECTOR == 1 ) */
+
+    heapISR_POOL_RESET_STATE();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,219 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * The pool of fixed size blocks behind pvPortMallocFromISR() and
+ * vPortFreeFromISR().  The pool does not depend on how the heap itself is
+ * managed, so heap_4.c, heap_5.c and heap_6.c all include this file to provide
+ * the same implementation.  It must only be included from a heap source file,
+ * after FreeRTOS.h, task.h and string.h.
+ */
+
+#ifndef HEAP_ISR_POOL_H
+#define HEAP_ISR_POOL_H
+
+#ifndef configISR_HEAP_NUMBER_OF_BLOCKS
+    #define configISR_HEAP_NUMBER_OF_BLOCKS    0
+#endif
+
+#ifndef configISR_HEAP_BLOCK_SIZE
+    #define configISR_HEAP_BLOCK_SIZE    0
+#endif
+
+#if ( ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 ) && ( configISR_HEAP_BLOCK_SIZE <= 0 ) )
+    #error configISR_HEAP_BLOCK_SIZE must be set to use pvPortMallocFromISR()
+#endif
+
+#if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 )
+
+/* The size of the blocks used by pvPortMallocFromISR(), rounded up so every
+ * block is correctly aligned and can hold a pointer to the next free block. */
+    #define heapISR_BLOCK_SIZE                                                                                           \
+    ( ( ( ( ( ( size_t ) configISR_HEAP_BLOCK_SIZE ) > sizeof( void * ) ) ? ( ( size_t ) configISR_HEAP_BLOCK_SIZE ) : \
+          sizeof( void * ) ) + ( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The first correctly aligned byte of ucISRHeap. */
+    #define heapISR_HEAP_START                                                                            \
+    ( ( uint8_t * ) ( ( ( ( portPOINTER_SIZE_TYPE ) ucISRHeap ) + ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) & \
+                      ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) )
+
+/* A free block holds a pointer to the next free block in its first bytes. */
+    #define heapISR_BLOCK_LINK( pv )    ( *( ( void ** ) ( pv ) ) )
+
+/* The pool of fixed size blocks used by pvPortMallocFromISR() and
+ * vPortFreeFromISR(), which is separate from the heap so can be accessed with
+ * interrupts masked instead of with the scheduler suspended.  Blocks that have
+ * been freed are held in a singly linked list.  Blocks that have never been
+ * allocated are taken in order from the end of the pool, so the pool does not
+ * need initialising and every operation takes a constant time. */
+    PRIVILEGED_DATA static uint8_t ucISRHeap[ ( configISR_HEAP_NUMBER_OF_BLOCKS * heapISR_BLOCK_SIZE ) + portBYTE_ALIGNMENT ];
+    PRIVILEGED_DATA static void * pvISRFreeBlocks = NULL;
+    PRIVILEGED_DATA static size_t xISRBlocksNeverAllocated = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS;
+    PRIVILEGED_DATA static size_t xISRFreeBlocksRemaining = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS;
+    PRIVILEGED_DATA static size_t xISRMinimumEverFreeBlocksRemaining = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS;
+    PRIVILEGED_DATA static size_t xNumberOfSuccessfulISRAllocations = ( size_t ) 0U;
+    PRIVILEGED_DATA static size_t xNumberOfSuccessfulISRFrees = ( size_t ) 0U;
+
+#endif /* if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 ) */
+
+/* Copy the ISR pool counters into pxHeapStats, for use by
+ * vPortGetHeapStats(). */
+#if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 )
+    #define heapISR_POOL_GET_STATS( pxHeapStats )                                               \
+    do {                                                                                        \
+        ( pxHeapStats )->xNumberOfFreeISRBlocks = xISRFreeBlocksRemaining;                      \
+        ( pxHeapStats )->xMinimumEverFreeISRBlocks = xISRMinimumEverFreeBlocksRemaining;        \
+        ( pxHeapStats )->xNumberOfSuccessfulISRAllocations = xNumberOfSuccessfulISRAllocations; \
+        ( pxHeapStats )->xNumberOfSuccessfulISRFrees = xNumberOfSuccessfulISRFrees;             \
+    } while( 0 )
+#else
+    #define heapISR_POOL_GET_STATS( pxHeapStats )                           \
+    do {                                                                    \
+        ( pxHeapStats )->xNumberOfFreeISRBlocks = ( size_t ) 0U;            \
+        ( pxHeapStats )->xMinimumEverFreeISRBlocks = ( size_t ) 0U;         \
+        ( pxHeapStats )->xNumberOfSuccessfulISRAllocations = ( size_t ) 0U; \
+        ( pxHeapStats )->xNumberOfSuccessfulISRFrees = ( size_t ) 0U;       \
+    } while( 0 )
+#endif /* if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 ) */
+
+/* Return the ISR pool to its start up state, for use by
+ * vPortHeapResetState(). */
+#if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 )
+    #define heapISR_POOL_RESET_STATE()                                                   \
+    do {                                                                                 \
+        pvISRFreeBlocks = NULL;                                                          \
+        xISRBlocksNeverAllocated = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS;           \
+        xISRFreeBlocksRemaining = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS;            \
+        xISRMinimumEverFreeBlocksRemaining = ( size_t ) configISR_HEAP_NUMBER_OF_BLOCKS; \
+        xNumberOfSuccessfulISRAllocations = ( size_t ) 0U;                               \
+        xNumberOfSuccessfulISRFrees = ( size_t ) 0U;                                     \
+    } while( 0 )
+#else
+    #define heapISR_POOL_RESET_STATE()
+#endif /* if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 )
+
+    void * pvPortMallocFromISR( size_t xWantedSize )
+    {
+        void * pvReturn = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= heapISR_BLOCK_SIZE ) )
+        {
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                if( pvISRFreeBlocks != NULL )
+                {
+                    pvReturn = pvISRFreeBlocks;
+
+                    /* MISRA Ref 11.5.6 [Object pool link] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pvISRFreeBlocks = heapISR_BLOCK_LINK( pvReturn );
+                }
+                else if( xISRBlocksNeverAllocated > ( size_t ) 0U )
+                {
+                    xISRBlocksNeverAllocated--;
+                    pvReturn = &( heapISR_HEAP_START[ xISRBlocksNeverAllocated * heapISR_BLOCK_SIZE ] );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( pvReturn != NULL )
+                {
+                    xISRFreeBlocksRemaining--;
+                    xNumberOfSuccessfulISRAllocations++;
+
+                    if( xISRFreeBlocksRemaining < xISRMinimumEverFreeBlocksRemaining )
+                    {
+                        xISRMinimumEverFreeBlocksRemaining = xISRFreeBlocksRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortFreeFromISR( void * pv )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( pv != NULL )
+        {
+            /* The block must have been allocated by pvPortMallocFromISR(). */
+            configASSERT( ( ( uint8_t * ) pv >= heapISR_HEAP_START ) &&
+                          ( ( uint8_t * ) pv < &( heapISR_HEAP_START[ configISR_HEAP_NUMBER_OF_BLOCKS * heapISR_BLOCK_SIZE ] ) ) );
+            configASSERT( ( ( ( size_t ) ( ( uint8_t * ) pv - heapISR_HEAP_START ) ) % heapISR_BLOCK_SIZE ) == ( size_t ) 0U );
+
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( pv, 0, heapISR_BLOCK_SIZE );
+            }
+            #endif
+
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                /* MISRA Ref 11.5.6 [Object pool link] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                heapISR_BLOCK_LINK( pv ) = pvISRFreeBlocks;
+                pvISRFreeBlocks = pv;
+                xISRFreeBlocksRemaining++;
+                xNumberOfSuccessfulISRFrees++;
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( configISR_HEAP_NUMBER_OF_BLOCKS > 0 ) */
+
+#endif /* HEAP_ISR_POOL_H */
@@ -53,18 +53,90 @@
 * suppress SIGUSR1 to prevent debugger interference. This can be
 * done by adding the following line to ~/.lldbinit:
 * `process handle SIGUSR1 -n true -p false -s false`
+*
+* When configPOSIX_USE_UCONTEXT is set to 1 (Linux only) all tasks
+* instead run on the single host thread that started the scheduler.
+* Each task gets a ucontext_t that executes on the task's own FreeRTOS
+* stack, and a task switch is a swapcontext() call rather than a
+* condition variable handshake between two host threads, which removes
+* the host kernel wakeup from every switch.  Task stacks are then real
+* C stacks, so stack sizes must be large enough for the host C library
+* and for the tick signal handler, which runs on the stack of the
+* interrupted task.  Debuggers see one thread whose backtrace is that
+* of the running task.
+*
+* When configNUMBER_OF_CORES is greater than 1 each simulated core is
+* the thread of the task that is running on it, so up to
+* configNUMBER_OF_CORES task threads run at the same time.  The task
+* and ISR locks are spinlocks owned by a core, interrupts are masked
+* per thread, and a core is asked to yield by sending SIG_YIELD to the
+* thread of the task it is running.  The tick is delivered to core 0,
+* and xTaskIncrementTick() requests time slicing on the other cores.
+* vTaskEndScheduler() is only supported with a single core, as the
+* other cores keep scheduling tasks until they are stopped.
+*
+* When configPOSIX_VIRTUAL_TIME is set to 1 the tick count is decoupled
+* from wall clock time, so runs are repeatable.  Idle periods are skipped by
+* stepping the tick count straight to the next unblock time from the
+* tickless idle hook, and the tick is only taken while the idle task runs.
+* Code that other tasks run takes no simulated time, so a task that waits
+* for the tick count to change without blocking waits forever, and tasks of
+* equal priority that never block are not time sliced.  An idle period
+* shorter than configEXPECTED_IDLE_TIME_BEFORE_SLEEP still lasts its wall
+* clock time, and a timer thread that is held up skips the periods it
+* missed rather than catching them up, so it still ends after exactly one
+* tick.  Simulated interrupts raised at a fixed rate by host threads are not
+* repeatable.
+*
+* The tick is one of portMAX_INTERRUPTS simulated interrupts.  Raising an
+* interrupt sets its bit in ulPendingInterrupts and signals the thread of
+* the running task, whose signal handler calls the handlers of the pending
+* interrupts highest priority first.  Interrupts at or below
+* configMAX_SYSCALL_INTERRUPT_PRIORITY share SIGALRM with the tick, so are
+* masked by critical sections and do not nest.  Interrupts above it use
+* SIG_HIGH_INTERRUPT, which critical sections leave unblocked, so they can
+* interrupt both tasks and the handlers of lower priority interrupts.
+*
+* To make timing measurements repeatable the threads that run tasks, and
+* the timer threads, can be pinned to host CPUs with
+* configPOSIX_TASK_CPU_AFFINITY and configPOSIX_TIMER_CPU_AFFINITY, and
+* run under SCHED_FIFO with all memory locked by setting
+* configPOSIX_USE_SCHED_FIFO to 1, which usually needs CAP_SYS_NICE and
+* CAP_IPC_LOCK.  In ucontext mode the thread that starts the scheduler
+* keeps its affinity and policy after the scheduler ends.
+*
+* When configPOSIX_SCHEDULE_LOG is set to 1 (ucontext mode only) a run can
+* be recorded with vPortRecordSchedule() and replayed with
+* vPortReplaySchedule().  Ticks and interrupts at or below
+* configMAX_SYSCALL_INTERRUPT_PRIORITY are then only taken at interrupt
+* windows, the points at which a task other than the idle task enables
+* interrupts, or at any time while the idle task runs with the scheduler
+* running.  A task that runs for configPOSIX_SCHEDULE_LOG_FORCE_TICKS ticks
+* without passing a window is interrupted wherever it is, so tasks that
+* never call the FreeRTOS API are still time sliced.  The log records the
+* window each group of interrupts was taken at and the task selected by
+* each context switch.  A replay ignores the interrupts that arrive and takes
+* the logged ones at the same windows, aborting if a different task is
+* selected.  Interrupts forced on a task are taken at the first tick after
+* the window it last passed, or when it next masks interrupts if that comes
+* first, which need not be the point in its code where they were recorded,
+* so data that tasks share without a critical section can differ.
+* Interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY are not logged, and
+* the idle hook must not change anything that other tasks can see.
 *----------------------------------------------------------*/
 #ifdef __linux__
     #define _GNU_SOURCE
 #endif
-#include "portmacro.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <limits.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/times.h>
 #include <time.h>
@@ -75,17 +147,138 @@
 #include "task.h"
 #include "timers.h"
 #include "utils/wait_for_event.h"
+
+#ifndef configPOSIX_USE_UCONTEXT
+    #define configPOSIX_USE_UCONTEXT    0
+#endif
+
+#if ( configPOSIX_USE_UCONTEXT == 1 )
+    #ifndef __linux__
+        #error configPOSIX_USE_UCONTEXT is only supported on Linux hosts.
+    #endif
+    #include <ucontext.h>
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configPOSIX_USE_UCONTEXT cannot be used when configNUMBER_OF_CORES is greater than 1.
+    #endif
+#endif
+
+#ifndef configPOSIX_VIRTUAL_TIME
+    #define configPOSIX_VIRTUAL_TIME    0
+#endif
+
+#if ( configPOSIX_VIRTUAL_TIME == 1 )
+    #if ( configUSE_TICKLESS_IDLE != 1 )
+        #error configPOSIX_VIRTUAL_TIME requires configUSE_TICKLESS_IDLE to be set to 1.
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configPOSIX_VIRTUAL_TIME cannot be used when configNUMBER_OF_CORES is greater than 1.
+    #endif
+
+    #if ( INCLUDE_xTaskGetIdleTaskHandle != 1 )
+        #error configPOSIX_VIRTUAL_TIME requires INCLUDE_xTaskGetIdleTaskHandle to be set to 1.
+    #endif
+#endif
+
+/* Host CPUs, as a bit mask, that the threads which run tasks are restricted
+ * to, or 0 to leave them unpinned. */
+#ifndef configPOSIX_TASK_CPU_AFFINITY
+    #define configPOSIX_TASK_CPU_AFFINITY    0
+#endif
+
+/* Host CPUs, as a bit mask, that the tick timer thread and the threads that
+ * raise simulated interrupts at a fixed rate are restricted to, or 0 to leave
+ * them unpinned. */
+#ifndef configPOSIX_TIMER_CPU_AFFINITY
+    #define configPOSIX_TIMER_CPU_AFFINITY    0
+#endif
+
+#if ( ( configPOSIX_TASK_CPU_AFFINITY != 0 ) || ( configPOSIX_TIMER_CPU_AFFINITY != 0 ) )
+    #ifndef __linux__
+        #error configPOSIX_TASK_CPU_AFFINITY and configPOSIX_TIMER_CPU_AFFINITY are only supported on Linux hosts.
+    #endif
+#endif
+
+#ifndef configPOSIX_USE_SCHED_FIFO
+    #define configPOSIX_USE_SCHED_FIFO    0
+#endif
+
+/* The SCHED_FIFO priority of the threads that run tasks.  The timer threads
+ * run one priority higher so they can interrupt a task that never blocks. */
+#ifndef configPOSIX_SCHED_FIFO_PRIORITY
+    #define configPOSIX_SCHED_FIFO_PRIORITY    10
+#endif
+
+#ifndef configPOSIX_SCHEDULE_LOG
+    #define configPOSIX_SCHEDULE_LOG    0
+#endif
+
+/* While a schedule is recorded, the number of ticks a task other than the idle
+ * task can run for without passing an interrupt window before the ticks and
+ * interrupts that have arrived are taken wherever it is. */
+#ifndef configPOSIX_SCHEDULE_LOG_FORCE_TICKS
+    #define configPOSIX_SCHEDULE_LOG_FORCE_TICKS    10
+#endif
+
+#if ( configPOSIX_SCHEDULE_LOG == 1 )
+    #if ( configPOSIX_USE_UCONTEXT != 1 )
+        #error configPOSIX_SCHEDULE_LOG requires configPOSIX_USE_UCONTEXT to be set to 1.
+    #endif
+
+    #if ( configPOSIX_VIRTUAL_TIME == 1 )
+        #error configPOSIX_SCHEDULE_LOG cannot be used when configPOSIX_VIRTUAL_TIME is set to 1.
+    #endif
+
+    #if ( INCLUDE_xTaskGetIdleTaskHandle != 1 )
+        #error configPOSIX_SCHEDULE_LOG requires INCLUDE_xTaskGetIdleTaskHandle to be set to 1.
+    #endif
+
+    #if ( ( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 ) )
+        #error configPOSIX_SCHEDULE_LOG requires INCLUDE_xTaskGetSchedulerState to be set to 1.
+    #endif
+
+    #if ( configPOSIX_SCHEDULE_LOG_FORCE_TICKS < 1 )
+        #error configPOSIX_SCHEDULE_LOG_FORCE_TICKS must be at least 1.
+    #endif
+#endif
+
+/* Simulated interrupts of any priority can call the FreeRTOS API unless a
+ * lower limit is set. */
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+    #define configMAX_SYSCALL_INTERRUPT_PRIORITY    portMAX_INTERRUPT_PRIORITY
+#endif
 /*-----------------------------------------------------------*/
 
-#define SIG_RESUME    SIGUSR1
+#define SIG_RESUME            SIGUSR1
+#define SIG_YIELD             SIGUSR2
+#define SIG_HIGH_INTERRUPT    SIGURG
+
+/* Alignment of the Thread_t stored at the top of each task's stack. ucontext_t
+ * contains floating point state that must be 16 byte aligned on some hosts. */
+#define portTHREAD_ALIGNMENT    ( ( uintptr_t ) 16 )
 
 typedef struct THREAD
 {
-    pthread_t pthread;
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+        ucontext_t xContext;
+    #else
+        pthread_t pthread;
+        struct event * ev;
+    #endif
     TaskFunction_t pxCode;
     void * pvParams;
     BaseType_t xDying;
-    struct event * ev;
+    #if ( configPOSIX_SCHEDULE_LOG == 1 )
+        /* Identifies the task in the schedule log.  Tasks are numbered in
+         * the order they are created. */
+        uint32_t ulThreadNumber;
+    #endif
+    #if ( configNUMBER_OF_CORES > 1 )
+        /* The core the task was last scheduled on, written by the thread
+         * that switches to it. */
+        volatile BaseType_t xCoreID;
+    #endif
 } Thread_t;
 
 /*
@@ -99,6 +292,13 @@ static inline Thread_t * prvGetThreadFromTask( TaskHandle_t xTask )
     return ( Thread_t * ) ( pxTopOfStack + 1 );
 }
 
+#if ( configNUMBER_OF_CORES > 1 )
+    static inline Thread_t * prvGetThreadFromCore( BaseType_t xCoreID )
+    {
+        return prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( xCoreID ) );
+    }
+#endif
+
 /*-----------------------------------------------------------*/
 
 static pthread_once_t hSigSetupThread = PTHREAD_ONCE_INIT;
@@ -106,22 +306,177 @@ static pthread_once_t hThreadKeyOnce = PTHREAD_ONCE_INIT;
 static sigset_t xAllSignals;
 static sigset_t xSchedulerOriginalSignalMask;
 static pthread_t hMainThread = ( pthread_t ) NULL;
-static volatile BaseType_t uxCriticalNesting;
+#if ( configNUMBER_OF_CORES == 1 )
+    static volatile BaseType_t uxCriticalNesting;
+#endif
 static BaseType_t xSchedulerEnd = pdFALSE;
 static pthread_t hTimerTickThread;
 static bool xTimerTickThreadShouldRun;
 static uint64_t prvStartTimeNs;
+
+/* Tick periods counted by the timer thread that the tick handler has not yet
+ * passed to xTaskIncrementTick().  Signals do not queue, so the count rather
+ * than the number of SIGALRMs delivered decides how many ticks are processed. */
+static volatile uint32_t ulPendingTicks = 0;
 static pthread_key_t xThreadKey = 0;
+
+typedef struct SIMULATED_INTERRUPT
+{
+    uint32_t ( * pvHandler )( void );
+    volatile UBaseType_t uxPriority;
+
+    /* Incremented each time the rate changes, which stops the host thread
+     * raising the interrupt at the previous rate. */
+    volatile uint32_t ulRateGeneration;
+} SimulatedInterrupt_t;
+
+static SimulatedInterrupt_t xInterrupts[ portMAX_INTERRUPTS ];
+
+/* Passed to the host thread that raises an interrupt at a fixed rate. */
+typedef struct INTERRUPT_RATE
+{
+    uint32_t ulInterruptNumber;
+    uint32_t ulRateGeneration;
+    uint32_t ulRateHz;
+} InterruptRate_t;
+
+/* One bit per simulated interrupt, set when it is raised and cleared just
+ * before its handler is called. */
+static volatile uint32_t ulPendingInterrupts = 0;
+
+/* The interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+static volatile uint32_t ulHighPriorityInterrupts = 0;
+
+/* The simulated interrupt being handled by the calling thread, or -1. */
+static __thread BaseType_t xInterruptInService = -1;
+
+#if ( configNUMBER_OF_CORES > 1 )
+    /* The Thread_t of the task that owns the calling host thread. */
+    static __thread Thread_t * pxThisThread = NULL;
+
+    typedef struct PORT_SPINLOCK
+    {
+        volatile BaseType_t xOwnerCore; /* -1 when the lock is free. */
+        UBaseType_t uxRecursionCount;
+    } PortSpinlock_t;
+
+    /* Indexed by portTASK_LOCK and portISR_LOCK. */
+    static PortSpinlock_t xLocks[ 2 ] = { { -1, 0 }, { -1, 0 } };
+#endif
+
+#if ( configPOSIX_USE_UCONTEXT == 1 )
+    /* The context of xPortStartScheduler(), which vPortEndScheduler() returns
+     * to. */
+    static ucontext_t xSchedulerContext;
+
+    /* Every task runs on the same host thread, so interrupts are masked by this
+     * flag rather than with pthread_sigmask(), which keeps critical sections free
+     * of system calls.  A SIGALRM that arrives while it is set is noted in
+     * xInterruptPending and raised again when interrupts are enabled. */
+    static volatile BaseType_t xInterruptsMasked = pdFALSE;
+    static volatile BaseType_t xInterruptPending = pdFALSE;
+
+    /* Interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY can nest inside
+     * the tick handler, so they run on this stack rather than adding to the
+     * stack every task needs.  Their handlers never switch context, so the
+     * stack is never in use by more than one of them. */
+    static uint8_t ucHighInterruptStack[ 65536 ] __attribute__( ( aligned( 16 ) ) );
+#endif
+
+#if ( configPOSIX_SCHEDULE_LOG == 1 )
+    #define portSCHEDULE_LOG_OFF       0
+    #define portSCHEDULE_LOG_RECORD    1
+    #define portSCHEDULE_LOG_REPLAY    2
+
+    /* The log starts with portSCHEDULE_LOG_MAGIC followed by records made of
+     * variable length values, 7 bits per byte, least significant first.  The
+     * low bits of the first value of a record are its type. */
+    #define portSCHEDULE_LOG_MAGIC          "FRTOSSL1"
+    #define portSCHEDULE_LOG_MAGIC_LENGTH   ( sizeof( portSCHEDULE_LOG_MAGIC ) - 1U )
+    #define portLOG_RECORD_TYPE_BITS        2U
+    #define portLOG_RECORD_TYPE_MASK        ( ( 1U << portLOG_RECORD_TYPE_BITS ) - 1U )
+
+    /* The number of the task selected by vTaskSwitchContext(). */
+    #define portLOG_RECORD_SWITCH    0U
+
+    /* Interrupts taken at an interrupt window of a task other than the idle
+     * task, followed by the number of ticks and the interrupt bits. */
+    #define portLOG_RECORD_INTERRUPT    1U
+
+    /* As portLOG_RECORD_INTERRUPT, but taken while the idle task was running
+     * with the scheduler running. */
+    #define portLOG_RECORD_IDLE_INTERRUPT    2U
+
+    /* As portLOG_RECORD_INTERRUPT, but taken between the interrupt window and
+     * the next one, as the task ran for configPOSIX_SCHEDULE_LOG_FORCE_TICKS
+     * ticks without passing another window. */
+    #define portLOG_RECORD_FORCED_INTERRUPT    3U
+
+    typedef struct SCHEDULE_LOG_RECORD
+    {
+        uint32_t ulType;
+        uint64_t ullValue; /* The task number, or the interrupt window. */
+        uint32_t ulTicks;
+        uint32_t ulInterrupts;
+    } ScheduleLogRecord_t;
+
+    static BaseType_t xScheduleLogMode = portSCHEDULE_LOG_OFF;
+    static int iScheduleLogFile = -1;
+
+    /* When recording, the bytes not yet written to the log.  When replaying,
+     * the bytes read from the log, of which xScheduleLogRead are used. */
+    static uint8_t ucScheduleLogBuffer[ 65536 ];
+    static size_t xScheduleLogLength = 0;
+    static size_t xScheduleLogRead = 0;
+
+    /* The interrupt windows passed by tasks other than the idle task, which
+     * are the points that interrupts are taken at, and the window of the last
+     * interrupt record, which the next is stored relative to. */
+    static uint64_t ullInterruptWindows = 0;
+    static uint64_t ullLastLoggedWindow = 0;
+
+    /* When replaying, the record that comes next. */
+    static ScheduleLogRecord_t xNextRecord;
+
+    /* Ticks and interrupts that have arrived but not yet been placed in the
+     * schedule, and so are not in ulPendingTicks and ulPendingInterrupts. */
+    static volatile uint32_t ulArrivedTicks = 0;
+    static volatile uint32_t ulArrivedInterrupts = 0;
+
+    static uint32_t ulNextThreadNumber = 0;
+#endif
 /*-----------------------------------------------------------*/
 
 static void prvSetupSignalsAndSchedulerPolicy( void );
 static void prvSetupTimerInterrupt( void );
-static void * prvWaitForStart( void * pvParams );
+static BaseType_t prvProcessPendingTicks( void );
+static void prvRaiseInterrupt( uint32_t ulInterruptNumber );
+static BaseType_t prvDispatchInterrupts( uint32_t ulInterruptMask );
+static void * prvInterruptRateThread( void * pvParams );
+#if ( configPOSIX_SCHEDULE_LOG == 1 )
+    static BaseType_t prvIsIdleTaskRunning( void );
+    static BaseType_t prvScheduleInterrupts( uint32_t ulType );
+    static void prvTakeForcedInterrupts( void );
+    static void prvInterruptWindow( void );
+    static void prvLogSwitch( void );
+    static void prvCloseScheduleLog( void );
+#endif
+#if ( configPOSIX_USE_UCONTEXT == 1 )
+    static void prvTaskEntry( void );
+#else
+    static void * prvWaitForStart( void * pvParams );
+#endif
 static void prvSwitchThread( Thread_t * xThreadToResume,
                              Thread_t * xThreadToSuspend );
-static void prvSuspendSelf( Thread_t * thread );
-static void prvResumeThread( Thread_t * xThreadId );
+#if ( configPOSIX_USE_UCONTEXT == 0 )
+    static void prvSuspendSelf( Thread_t * thread );
+    static void prvResumeThread( Thread_t * xThreadId );
+#endif
 static void vPortSystemTickHandler( int sig );
+static void prvHighPriorityInterruptHandler( int sig );
+#if ( configNUMBER_OF_CORES > 1 )
+    static void prvYieldHandler( int sig );
+#endif
 static void vPortStartFirstTask( void );
 static void prvPortYieldFromISR( void );
 static void prvThreadKeyDestructor( void * pvData );
@@ -203,6 +558,110 @@ static void prvPortSetCurrentThreadName( char * pxThreadName )
 }
 /*-----------------------------------------------------------*/
 
+#ifdef __linux__
+
+    static void prvGetCpuSet( uint64_t ullCpuMask,
+                              cpu_set_t * pxCpus )
+    {
+        size_t xCpu;
+        const long lHostCpus = sysconf( _SC_NPROCESSORS_CONF );
+
+        CPU_ZERO( pxCpus );
+
+        for( xCpu = 0; xCpu < 64U; xCpu++ )
+        {
+            if( ( ullCpuMask & ( ( uint64_t ) 1U << xCpu ) ) != 0U )
+            {
+                /* A thread that is pinned to a CPU the host does not have
+                 * would only fail to be created, with no indication of why. */
+                if( ( lHostCpus > 0 ) && ( xCpu >= ( size_t ) lHostCpus ) )
+                {
+                    fprintf( stderr, "CPU affinity mask 0x%llx includes CPU %zu, but the host has %ld\n",
+                             ( unsigned long long ) ullCpuMask, xCpu, lHostCpus );
+                    prvFatalError( "prvGetCpuSet", EINVAL );
+                }
+
+                CPU_SET( xCpu, pxCpus );
+            }
+        }
+    }
+
+#endif /* __linux__ */
+/*-----------------------------------------------------------*/
+
+/*
+ * Initialises the attributes of a thread that is to run on the host CPUs in
+ * ullCpuMask (all of them if it is 0) at SCHED_FIFO priority iFifoPriority
+ * when configPOSIX_USE_SCHED_FIFO is 1.  The attributes are set at creation
+ * so a new thread never waits behind its creator at the creator's priority.
+ */
+static void prvInitThreadAttributes( pthread_attr_t * pxAttributes,
+                                     uint64_t ullCpuMask,
+                                     int iFifoPriority )
+{
+    int iRet;
+
+    pthread_attr_init( pxAttributes );
+
+    #ifdef __linux__
+    {
+        cpu_set_t xCpus;
+
+        if( ullCpuMask != 0U )
+        {
+            prvGetCpuSet( ullCpuMask, &xCpus );
+            iRet = pthread_attr_setaffinity_np( pxAttributes, sizeof( xCpus ), &xCpus );
+
+            if( iRet != 0 )
+            {
+                prvFatalError( "pthread_attr_setaffinity_np", iRet );
+            }
+        }
+    }
+    #else
+    {
+        ( void ) ullCpuMask;
+    }
+    #endif /* __linux__ */
+
+    #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+    {
+        struct sched_param xParam;
+
+        memset( &xParam, 0, sizeof( xParam ) );
+        xParam.sched_priority = iFifoPriority;
+
+        iRet = pthread_attr_setinheritsched( pxAttributes, PTHREAD_EXPLICIT_SCHED );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_attr_setinheritsched", iRet );
+        }
+
+        iRet = pthread_attr_setschedpolicy( pxAttributes, SCHED_FIFO );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_attr_setschedpolicy", iRet );
+        }
+
+        iRet = pthread_attr_setschedparam( pxAttributes, &xParam );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_attr_setschedparam", iRet );
+        }
+    }
+    #else
+    {
+        ( void ) iFifoPriority;
+    }
+    #endif /* configPOSIX_USE_SCHED_FIFO */
+
+    ( void ) iRet;
+}
+/*-----------------------------------------------------------*/
+
 /*
  * See header file for description.
  */
@@ -212,16 +671,23 @@ StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
                                      void * pvParameters )
 {
     Thread_t * thread;
-    pthread_attr_t xThreadAttributes;
     size_t ulStackSize;
-    int iRet;
+
+    #if ( configPOSIX_USE_UCONTEXT == 0 )
+        pthread_attr_t xThreadAttributes;
+        int iRet;
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        UBaseType_t uxSavedInterruptStatus;
+    #endif
 
     ( void ) pthread_once( &hSigSetupThread, prvSetupSignalsAndSchedulerPolicy );
 
     /*
      * Store the additional thread data at the start of the stack.
      */
-    thread = ( Thread_t * ) ( pxTopOfStack + 1 ) - 1;
+    thread = ( Thread_t * ) ( ( ( uintptr_t ) ( pxTopOfStack + 1 ) - sizeof( Thread_t ) ) & ~( portTHREAD_ALIGNMENT - 1 ) );
     pxTopOfStack = ( StackType_t * ) thread - 1;
 
     /* Ensure that there is enough space to store Thread_t on the stack. */
@@ -232,21 +698,62 @@ StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
     thread->pvParams = pvParameters;
     thread->xDying = pdFALSE;
 
-    pthread_attr_init( &xThreadAttributes );
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        /* The task runs directly on the FreeRTOS stack below Thread_t. */
+        if( getcontext( &thread->xContext ) == -1 )
+        {
+            prvFatalError( "getcontext", errno );
+        }
 
-    thread->ev = event_create();
+        #if ( configPOSIX_SCHEDULE_LOG == 1 )
+        {
+            thread->ulThreadNumber = ulNextThreadNumber++;
+        }
+        #endif
 
-    vPortEnterCritical();
+        thread->xContext.uc_stack.ss_sp = pxEndOfStack;
+        thread->xContext.uc_stack.ss_size = ( size_t ) ( ( uint8_t * ) thread - ( uint8_t * ) pxEndOfStack );
+        thread->xContext.uc_link = NULL;
 
-    iRet = pthread_create( &thread->pthread, &xThreadAttributes,
-                           prvWaitForStart, thread );
+        /* Signals are never blocked outside of the tick handler.  The task
+         * starts with interrupts masked, as it would when resumed from a
+         * context switch, and enables them in prvTaskEntry(). */
+        sigemptyset( &thread->xContext.uc_sigmask );
 
-    if( iRet != 0 )
-    {
-        prvFatalError( "pthread_create", iRet );
+        makecontext( &thread->xContext, prvTaskEntry, 0 );
     }
+    #else /* configPOSIX_USE_UCONTEXT */
+    {
+        prvInitThreadAttributes( &xThreadAttributes, configPOSIX_TASK_CPU_AFFINITY, configPOSIX_SCHED_FIFO_PRIORITY );
+
+        thread->ev = event_create();
+
+        /* The new thread inherits the signal mask of this one, so it starts
+         * with interrupts disabled. */
+        #if ( configNUMBER_OF_CORES == 1 )
+            vPortEnterCritical();
+        #else
+            uxSavedInterruptStatus = xPortSetInterruptMask();
+        #endif
+
+        iRet = pthread_create( &thread->pthread, &xThreadAttributes,
+                               prvWaitForStart, thread );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_create", iRet );
+        }
 
-    vPortExitCritical();
+        pthread_attr_destroy( &xThreadAttributes );
+
+        #if ( configNUMBER_OF_CORES == 1 )
+            vPortExitCritical();
+        #else
+            vPortClearInterruptMask( uxSavedInterruptStatus );
+        #endif
+    }
+    #endif /* configPOSIX_USE_UCONTEXT */
 
     return pxTopOfStack;
 }
@@ -254,10 +761,34 @@ StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
 
 void vPortStartFirstTask( void )
 {
-    Thread_t * pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    Thread_t * pxFirstThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( 0 ) );
 
     /* Start the first task. */
-    prvResumeThread( pxFirstThread );
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        /* Returns when vPortEndScheduler() resumes xSchedulerContext. */
+        if( swapcontext( &xSchedulerContext, &pxFirstThread->xContext ) == -1 )
+        {
+            prvFatalError( "swapcontext", errno );
+        }
+    }
+    #elif ( configNUMBER_OF_CORES == 1 )
+    {
+        prvResumeThread( pxFirstThread );
+    }
+    #else
+    {
+        BaseType_t xCoreID;
+
+        /* Start the first task of every core. */
+        for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+        {
+            pxFirstThread = prvGetThreadFromCore( xCoreID );
+            pxFirstThread->xCoreID = xCoreID;
+            prvResumeThread( pxFirstThread );
+        }
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -266,33 +797,115 @@ void vPortStartFirstTask( void )
  */
 BaseType_t xPortStartScheduler( void )
 {
-    int iSignal;
-    sigset_t xSignals;
+    #if ( configPOSIX_USE_UCONTEXT == 0 )
+        int iSignal;
+        sigset_t xSignals;
+    #endif
 
     hMainThread = pthread_self();
     prvPortSetCurrentThreadName( "Scheduler" );
 
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        stack_t xHighInterruptStack;
+
+        /* All tasks run on this thread. */
+        prvMarkAsFreeRTOSThread();
+
+        /* vTaskStartScheduler() disabled interrupts before this thread was
+         * marked, so that had no effect.  They must be disabled before the
+         * first task starts, as the SIGALRM that is unblocked part of the way
+         * through loading its context would otherwise switch tasks on the
+         * scheduler's stack, saving that as the context of the first task in
+         * place of prvTaskEntry().  The tick is then handled when
+         * prvTaskEntry() enables interrupts. */
+        vPortDisableInterrupts();
+
+        xHighInterruptStack.ss_sp = ucHighInterruptStack;
+        xHighInterruptStack.ss_size = sizeof( ucHighInterruptStack );
+        xHighInterruptStack.ss_flags = 0;
+
+        if( sigaltstack( &xHighInterruptStack, NULL ) == -1 )
+        {
+            prvFatalError( "sigaltstack", errno );
+        }
+
+        #if ( configPOSIX_TASK_CPU_AFFINITY != 0 )
+        {
+            cpu_set_t xCpus;
+            int iRet;
+
+            prvGetCpuSet( configPOSIX_TASK_CPU_AFFINITY, &xCpus );
+            iRet = pthread_setaffinity_np( hMainThread, sizeof( xCpus ), &xCpus );
+
+            if( iRet != 0 )
+            {
+                prvFatalError( "pthread_setaffinity_np", iRet );
+            }
+        }
+        #endif
+
+        #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+        {
+            struct sched_param xParam;
+            int iRet;
+
+            memset( &xParam, 0, sizeof( xParam ) );
+            xParam.sched_priority = configPOSIX_SCHED_FIFO_PRIORITY;
+            iRet = pthread_setschedparam( hMainThread, SCHED_FIFO, &xParam );
+
+            if( iRet != 0 )
+            {
+                prvFatalError( "pthread_setschedparam", iRet );
+            }
+        }
+        #endif
+    }
+    #endif
+
+    #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+    {
+        /* Page faults would add the latency that SCHED_FIFO is used to
+         * avoid.  This includes the stack of every task thread created
+         * from now on. */
+        if( mlockall( MCL_CURRENT | MCL_FUTURE ) == -1 )
+        {
+            prvFatalError( "mlockall", errno );
+        }
+    }
+    #endif
+
     /* Start the timer that generates the tick ISR(SIGALRM).
      * Interrupts are disabled here already. */
     prvSetupTimerInterrupt();
 
-    /*
-     * Block SIG_RESUME before starting any tasks so the main thread can sigwait on it.
-     * To sigwait on an unblocked signal is undefined.
-     * https://pubs.opengroup.org/onlinepubs/009604499/functions/sigwait.html
-     */
-    sigemptyset( &xSignals );
-    sigaddset( &xSignals, SIG_RESUME );
-    ( void ) pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        /* Start the first task.  This returns when vPortEndScheduler() is
+         * called. */
+        vPortStartFirstTask();
+    }
+    #else /* configPOSIX_USE_UCONTEXT */
+    {
+        /*
+         * Block SIG_RESUME before starting any tasks so the main thread can sigwait on it.
+         * To sigwait on an unblocked signal is undefined.
+         * https://pubs.opengroup.org/onlinepubs/009604499/functions/sigwait.html
+         */
+        sigemptyset( &xSignals );
+        sigaddset( &xSignals, SIG_RESUME );
+        ( void ) pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
 
-    /* Start the first task. */
-    vPortStartFirstTask();
+        /* Start the first task. */
+        vPortStartFirstTask();
 
-    /* Wait until signaled by vPortEndScheduler(). */
-    while( xSchedulerEnd != pdTRUE )
-    {
-        sigwait( &xSignals, &iSignal );
+        /* Wait until signaled by vPortEndScheduler(). */
+        while( xSchedulerEnd != pdTRUE )
+        {
+            sigwait( &xSignals, &iSignal );
+        }
     }
+    #endif /* configPOSIX_USE_UCONTEXT */
 
     /*
      * clear out the variable that is used to end the scheduler, otherwise
@@ -315,6 +928,29 @@ BaseType_t xPortStartScheduler( void )
     /* Restore original signal mask. */
     ( void ) pthread_sigmask( SIG_SETMASK, &xSchedulerOriginalSignalMask, NULL );
 
+    #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+    {
+        ( void ) munlockall();
+    }
+    #endif
+
+    #if ( configPOSIX_SCHEDULE_LOG == 1 )
+    {
+        prvCloseScheduleLog();
+    }
+    #endif
+
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        stack_t xDisabledStack;
+
+        xDisabledStack.ss_sp = NULL;
+        xDisabledStack.ss_size = 0;
+        xDisabledStack.ss_flags = SS_DISABLE;
+        ( void ) sigaltstack( &xDisabledStack, NULL );
+    }
+    #endif
+
     prvDestroyThreadKey();
 
     return 0;
@@ -323,54 +959,73 @@ BaseType_t xPortStartScheduler( void )
 
 void vPortEndScheduler( void )
 {
-    Thread_t * pxCurrentThread;
-    BaseType_t xIsFreeRTOSThread;
+    #if ( configPOSIX_USE_UCONTEXT == 0 )
+        Thread_t * pxCurrentThread;
+        BaseType_t xIsFreeRTOSThread;
+    #endif
 
     /* Stop the timer tick thread. */
     xTimerTickThreadShouldRun = false;
     pthread_join( hTimerTickThread, NULL );
 
-    /* Check whether the current thread is a FreeRTOS thread.
-     * This has to happen before the scheduler is signaled to exit
-     * its loop to prevent data races on the thread key. */
-    xIsFreeRTOSThread = prvIsFreeRTOSThread();
-
-    /* Signal the scheduler to exit its loop. */
-    xSchedulerEnd = pdTRUE;
-    ( void ) pthread_kill( hMainThread, SIG_RESUME );
-
-    /* Waiting to be deleted here. */
-    if( xIsFreeRTOSThread == pdTRUE )
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
     {
-        pxCurrentThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
-        event_wait( pxCurrentThread->ev );
+        /* All tasks share the scheduler's host thread, so this must be
+         * called from a task.  Return to xPortStartScheduler(). */
+        configASSERT( prvIsFreeRTOSThread() == pdTRUE );
+
+        ( void ) setcontext( &xSchedulerContext );
+        prvFatalError( "setcontext", errno );
     }
+    #else /* configPOSIX_USE_UCONTEXT */
+    {
+        /* Check whether the current thread is a FreeRTOS thread.
+         * This has to happen before the scheduler is signaled to exit
+         * its loop to prevent data races on the thread key. */
+        xIsFreeRTOSThread = prvIsFreeRTOSThread();
+
+        /* Signal the scheduler to exit its loop. */
+        xSchedulerEnd = pdTRUE;
+        ( void ) pthread_kill( hMainThread, SIG_RESUME );
 
-    pthread_testcancel();
+        /* Waiting to be deleted here. */
+        if( xIsFreeRTOSThread == pdTRUE )
+        {
+            pxCurrentThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+            event_wait( pxCurrentThread->ev );
+        }
+
+        pthread_testcancel();
+    }
+    #endif /* configPOSIX_USE_UCONTEXT */
 }
 /*-----------------------------------------------------------*/
 
-void vPortEnterCritical( void )
-{
-    if( uxCriticalNesting == 0 )
+#if ( configNUMBER_OF_CORES == 1 )
+
+    void vPortEnterCritical( void )
     {
-        vPortDisableInterrupts();
-    }
+        if( uxCriticalNesting == 0 )
+        {
+            vPortDisableInterrupts();
+        }
 
-    uxCriticalNesting++;
-}
+        uxCriticalNesting++;
+    }
 /*-----------------------------------------------------------*/
 
-void vPortExitCritical( void )
-{
-    uxCriticalNesting--;
-
-    /* If we have reached 0 then re-enable the interrupts. */
-    if( uxCriticalNesting == 0 )
+    void vPortExitCritical( void )
     {
-        vPortEnableInterrupts();
+        uxCriticalNesting--;
+
+        /* If we have reached 0 then re-enable the interrupts. */
+        if( uxCriticalNesting == 0 )
+        {
+            vPortEnableInterrupts();
+        }
     }
-}
+
+#endif /* configNUMBER_OF_CORES == 1 */
 /*-----------------------------------------------------------*/
 
 static void prvPortYieldFromISR( void )
@@ -378,136 +1033,1288 @@ static void prvPortYieldFromISR( void )
     Thread_t * xThreadToSuspend;
     Thread_t * xThreadToResume;
 
-    xThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    #if ( configNUMBER_OF_CORES == 1 )
+    {
+        xThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
-    vTaskSwitchContext();
+        #if ( configPOSIX_SCHEDULE_LOG == 1 )
+        {
+            /* When recorded, interrupts that arrived while the idle task was
+             * running could be taken before it yielded. */
+            if( ( xScheduleLogMode == portSCHEDULE_LOG_REPLAY ) && ( prvIsIdleTaskRunning() == pdTRUE ) )
+            {
+                while( prvScheduleInterrupts( portLOG_RECORD_IDLE_INTERRUPT ) == pdTRUE )
+                {
+                    ( void ) prvDispatchInterrupts( ~ulHighPriorityInterrupts );
+                }
+            }
+        }
+        #endif
 
-    xThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+        vTaskSwitchContext();
+
+        #if ( configPOSIX_SCHEDULE_LOG == 1 )
+        {
+            prvLogSwitch();
+        }
+        #endif
+
+        xThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    }
+    #else
+    {
+        const BaseType_t xCoreID = xPortGetCoreID();
+
+        xThreadToSuspend = prvGetThreadFromCore( xCoreID );
+
+        vTaskSwitchContext( xCoreID );
+
+        /* The task switched in may still be finishing its own switch on the
+         * thread of another core, but does not read its core ID until it
+         * has been resumed. */
+        xThreadToResume = prvGetThreadFromCore( xCoreID );
+        xThreadToResume->xCoreID = xCoreID;
+    }
+    #endif
 
     prvSwitchThread( xThreadToResume, xThreadToSuspend );
 }
 /*-----------------------------------------------------------*/
 
-void vPortYield( void )
-{
-    /* This must never be called from outside of a FreeRTOS-owned thread, or
-     * the thread could get stuck in a suspended state. */
-    configASSERT( prvIsFreeRTOSThread() == pdTRUE );
+void vPortYield( void )
+{
+    /* This must never be called from outside of a FreeRTOS-owned thread, or
+     * the thread could get stuck in a suspended state. */
+    configASSERT( prvIsFreeRTOSThread() == pdTRUE );
+
+    #if ( configNUMBER_OF_CORES == 1 )
+    {
+        vPortEnterCritical();
+
+        prvPortYieldFromISR();
+
+        vPortExitCritical();
+    }
+    #else
+    {
+        /* The kernel only yields outside of critical sections, but possibly
+         * with interrupts already masked. */
+        UBaseType_t uxSavedInterruptStatus = xPortSetInterruptMask();
+
+        prvPortYieldFromISR();
+
+        vPortClearInterruptMask( uxSavedInterruptStatus );
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    if( prvIsFreeRTOSThread() == pdTRUE )
+    {
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
+        {
+            #if ( configPOSIX_SCHEDULE_LOG == 1 )
+                const BaseType_t xWereMasked = xInterruptsMasked;
+            #endif
+
+            xInterruptsMasked = pdTRUE;
+            portMEMORY_BARRIER();
+
+            #if ( configPOSIX_SCHEDULE_LOG == 1 )
+            {
+                if( ( xScheduleLogMode == portSCHEDULE_LOG_REPLAY ) && ( xWereMasked == pdFALSE ) )
+                {
+                    prvTakeForcedInterrupts();
+                }
+            }
+            #endif
+        }
+        #else
+        {
+            pthread_sigmask( SIG_BLOCK, &xAllSignals, NULL );
+        }
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    if( prvIsFreeRTOSThread() == pdTRUE )
+    {
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
+        {
+            #if ( configPOSIX_SCHEDULE_LOG == 1 )
+            {
+                if( xScheduleLogMode != portSCHEDULE_LOG_OFF )
+                {
+                    prvInterruptWindow();
+                }
+            }
+            #endif
+
+            portMEMORY_BARRIER();
+            xInterruptsMasked = pdFALSE;
+
+            /* A SIGALRM that arrives after xInterruptsMasked is cleared is
+             * handled immediately, so only one deferred before it needs to be
+             * raised again. */
+            if( xInterruptPending == pdTRUE )
+            {
+                pthread_kill( pthread_self(), SIGALRM );
+            }
+        }
+        #else
+        {
+            pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+        }
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t xPortSetInterruptMask( void )
+{
+    /* FromISR functions can also be called from tasks, which must not be
+     * interrupted by a simulated interrupt that calls the FreeRTOS API.
+     * Returns pdTRUE if those interrupts were already masked. */
+    UBaseType_t uxMask = ( UBaseType_t ) pdTRUE;
+
+    /* Interrupts are always masked inside the handlers of simulated
+     * interrupts (signal handlers). */
+    if( ( xInterruptInService < 0 ) && ( prvIsFreeRTOSThread() == pdTRUE ) )
+    {
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
+        {
+            uxMask = ( UBaseType_t ) xInterruptsMasked;
+            xInterruptsMasked = pdTRUE;
+            portMEMORY_BARRIER();
+
+            #if ( configPOSIX_SCHEDULE_LOG == 1 )
+            {
+                if( ( xScheduleLogMode == portSCHEDULE_LOG_REPLAY ) && ( uxMask == ( UBaseType_t ) pdFALSE ) )
+                {
+                    prvTakeForcedInterrupts();
+                }
+            }
+            #endif
+        }
+        #else
+        {
+            sigset_t xPreviousSignals;
+
+            pthread_sigmask( SIG_BLOCK, &xAllSignals, &xPreviousSignals );
+
+            if( sigismember( &xPreviousSignals, SIGALRM ) == 0 )
+            {
+                uxMask = ( UBaseType_t ) pdFALSE;
+            }
+        }
+        #endif
+    }
+
+    return uxMask;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+    /* Only enable interrupts if they were enabled when the matching
+     * xPortSetInterruptMask() was called. */
+    if( uxMask == ( UBaseType_t ) pdFALSE )
+    {
+        vPortEnableInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+    BaseType_t xPortGetCoreID( void )
+    {
+        BaseType_t xCoreID = 0;
+
+        /* Threads not owned by a task, such as the one that starts the
+         * scheduler, report core 0. */
+        if( pxThisThread != NULL )
+        {
+            xCoreID = pxThisThread->xCoreID;
+        }
+
+        return xCoreID;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortYieldCore( BaseType_t xCoreID )
+    {
+        /* Called with both kernel locks held, so the task running on the core
+         * cannot change.  If its thread is still suspended the signal stays
+         * pending until it is resumed. */
+        ( void ) pthread_kill( prvGetThreadFromCore( xCoreID )->pthread, SIG_YIELD );
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortRecursiveLock( BaseType_t xCoreID,
+                             UBaseType_t uxLockNum,
+                             BaseType_t xAcquire )
+    {
+        PortSpinlock_t * pxLock = &( xLocks[ uxLockNum ] );
+        BaseType_t xFree;
+
+        if( xAcquire == pdTRUE )
+        {
+            /* Only this core can store its own ID in xOwnerCore. */
+            if( __atomic_load_n( &( pxLock->xOwnerCore ), __ATOMIC_RELAXED ) == xCoreID )
+            {
+                pxLock->uxRecursionCount++;
+            }
+            else
+            {
+                for( ; ; )
+                {
+                    xFree = -1;
+
+                    if( __atomic_compare_exchange_n( &( pxLock->xOwnerCore ), &xFree, xCoreID, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+                    {
+                        break;
+                    }
+
+                    /* The owner may be a host thread that is not currently
+                     * scheduled, so give it the chance to run. */
+                    ( void ) sched_yield();
+                }
+
+                configASSERT( pxLock->uxRecursionCount == 0 );
+                pxLock->uxRecursionCount = 1;
+            }
+        }
+        else
+        {
+            configASSERT( pxLock->xOwnerCore == xCoreID );
+            configASSERT( pxLock->uxRecursionCount != 0 );
+
+            pxLock->uxRecursionCount--;
+
+            if( pxLock->uxRecursionCount == 0 )
+            {
+                __atomic_store_n( &( pxLock->xOwnerCore ), -1, __ATOMIC_RELEASE );
+            }
+        }
+    }
+
+#endif /* configNUMBER_OF_CORES > 1 */
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec t;
+
+    clock_gettime( CLOCK_MONOTONIC, &t );
+
+    return ( uint64_t ) t.tv_sec * ( uint64_t ) 1000000000UL + ( uint64_t ) t.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the absolute time at which the given period of a timer that runs
+ * at ullRateHz from ullStartNs ends.  Deadlines are calculated from the start
+ * time rather than by adding a period to the last deadline so rounding errors
+ * do not accumulate.
+ */
+static uint64_t prvGetDeadlineNs( uint64_t ullStartNs,
+                                  uint64_t ullPeriod,
+                                  uint64_t ullRateHz )
+{
+    const uint64_t ullNsPerSecond = ( uint64_t ) 1000000000UL;
+
+    return ullStartNs + ( ( ullPeriod / ullRateHz ) * ullNsPerSecond ) +
+           ( ( ( ullPeriod % ullRateHz ) * ullNsPerSecond ) / ullRateHz );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSleepUntil( uint64_t ullDeadlineNs )
+{
+    struct timespec xTime;
+
+    #ifdef __APPLE__
+    {
+        /* macOS has no clock_nanosleep(). */
+        uint64_t ullNowNs = prvGetTimeNs();
+
+        if( ullDeadlineNs > ullNowNs )
+        {
+            xTime.tv_sec = ( time_t ) ( ( ullDeadlineNs - ullNowNs ) / 1000000000UL );
+            xTime.tv_nsec = ( long ) ( ( ullDeadlineNs - ullNowNs ) % 1000000000UL );
+
+            while( nanosleep( &xTime, &xTime ) == -1 )
+            {
+            }
+        }
+    }
+    #else
+    {
+        xTime.tv_sec = ( time_t ) ( ullDeadlineNs / 1000000000UL );
+        xTime.tv_nsec = ( long ) ( ullDeadlineNs % 1000000000UL );
+
+        while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xTime, NULL ) == EINTR )
+        {
+        }
+    }
+    #endif /* __APPLE__ */
+}
+/*-----------------------------------------------------------*/
+
+static void * prvTimerTickHandler( void * arg )
+{
+    uint64_t ullTick = 0;
+    uint32_t ulElapsedTicks;
+    uint64_t ullNowNs;
+    volatile uint32_t * pulTicks = &ulPendingTicks;
+
+    ( void ) arg;
+
+    prvMarkAsFreeRTOSThread();
+
+    prvPortSetCurrentThreadName( "Scheduler timer" );
+
+    while( xTimerTickThreadShouldRun )
+    {
+        ullTick++;
+        prvSleepUntil( prvGetDeadlineNs( prvStartTimeNs, ullTick, configTICK_RATE_HZ ) );
+
+        /* If this thread was held up for longer than a tick period then the
+         * ticks that were missed are caught up by the next tick interrupt
+         * rather than lost.  In virtual time the missed periods are skipped
+         * instead, so a busy host slows simulated time down rather than
+         * delivering a burst of ticks. */
+        ullNowNs = prvGetTimeNs();
+        ulElapsedTicks = 1;
+
+        while( prvGetDeadlineNs( prvStartTimeNs, ullTick + 1, configTICK_RATE_HZ ) <= ullNowNs )
+        {
+            ullTick++;
+
+            #if ( configPOSIX_VIRTUAL_TIME == 0 )
+            {
+                ulElapsedTicks++;
+            }
+            #endif
+        }
+
+        #if ( configPOSIX_SCHEDULE_LOG == 1 )
+        {
+            if( xScheduleLogMode != portSCHEDULE_LOG_OFF )
+            {
+                pulTicks = &ulArrivedTicks;
+            }
+        }
+        #endif
+
+        ( void ) __atomic_add_fetch( pulTicks, ulElapsedTicks, __ATOMIC_RELAXED );
+
+        /*
+         * signal to the active task to cause tick handling or
+         * preemption (if enabled)
+         */
+        prvRaiseInterrupt( portINTERRUPT_TICK );
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRaiseInterrupt( uint32_t ulInterruptNumber )
+{
+    const uint32_t ulInterruptBit = ( uint32_t ) 1UL << ulInterruptNumber;
+    int iSignal = SIGALRM;
+    volatile uint32_t * pulPending = &ulPendingInterrupts;
+
+    #if ( configPOSIX_SCHEDULE_LOG == 1 )
+    {
+        /* Interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY cannot
+         * change the schedule, so are not logged. */
+        if( ( xScheduleLogMode != portSCHEDULE_LOG_OFF ) && ( ( ulHighPriorityInterrupts & ulInterruptBit ) == 0U ) )
+        {
+            pulPending = &ulArrivedInterrupts;
+        }
+    }
+    #endif
+
+    ( void ) __atomic_or_fetch( pulPending, ulInterruptBit, __ATOMIC_RELAXED );
+
+    if( ( ulHighPriorityInterrupts & ulInterruptBit ) != 0U )
+    {
+        iSignal = SIG_HIGH_INTERRUPT;
+    }
+
+    /* Before the scheduler starts, and after it ends, the interrupt is left
+     * pending. */
+    if( xTimerTickThreadShouldRun == true )
+    {
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
+        {
+            pthread_kill( hMainThread, iSignal );
+        }
+        #else
+        {
+            /* Interrupts are taken by core 0. */
+            Thread_t * thread = prvGetThreadFromTask( xTaskGetCurrentTaskHandleForCore( 0 ) );
+            pthread_kill( thread->pthread, iSignal );
+        }
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+    configASSERT( ( ulInterruptNumber >= portINTERRUPT_APPLICATION_DEFINED_START ) && ( ulInterruptNumber < portMAX_INTERRUPTS ) );
+
+    prvRaiseInterrupt( ulInterruptNumber );
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                               uint32_t ( * pvHandler )( void ) )
+{
+    configASSERT( ( ulInterruptNumber >= portINTERRUPT_APPLICATION_DEFINED_START ) && ( ulInterruptNumber < portMAX_INTERRUPTS ) );
+
+    xInterrupts[ ulInterruptNumber ].pvHandler = pvHandler;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber,
+                                UBaseType_t uxPriority )
+{
+    const uint32_t ulInterruptBit = ( uint32_t ) 1UL << ulInterruptNumber;
+
+    configASSERT( ( ulInterruptNumber >= portINTERRUPT_APPLICATION_DEFINED_START ) && ( ulInterruptNumber < portMAX_INTERRUPTS ) );
+    configASSERT( uxPriority <= portMAX_INTERRUPT_PRIORITY );
+
+    xInterrupts[ ulInterruptNumber ].uxPriority = uxPriority;
+
+    if( uxPriority > ( UBaseType_t ) configMAX_SYSCALL_INTERRUPT_PRIORITY )
+    {
+        ( void ) __atomic_or_fetch( &ulHighPriorityInterrupts, ulInterruptBit, __ATOMIC_RELAXED );
+    }
+    else
+    {
+        ( void ) __atomic_and_fetch( &ulHighPriorityInterrupts, ~ulInterruptBit, __ATOMIC_RELAXED );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptRate( uint32_t ulInterruptNumber,
+                            uint32_t ulRateHz )
+{
+    uint32_t ulGeneration;
+    InterruptRate_t * pxRate;
+    pthread_t hThread;
+    pthread_attr_t xThreadAttributes;
+    int iRet;
+
+    configASSERT( ( ulInterruptNumber >= portINTERRUPT_APPLICATION_DEFINED_START ) && ( ulInterruptNumber < portMAX_INTERRUPTS ) );
+
+    /* Stops any thread raising the interrupt at the previous rate. */
+    ulGeneration = __atomic_add_fetch( &( xInterrupts[ ulInterruptNumber ].ulRateGeneration ), 1U, __ATOMIC_RELAXED );
+
+    if( ulRateHz > 0U )
+    {
+        /* Freed by the thread. */
+        pxRate = malloc( sizeof( InterruptRate_t ) );
+
+        if( pxRate == NULL )
+        {
+            prvFatalError( "malloc", ENOMEM );
+        }
+
+        pxRate->ulInterruptNumber = ulInterruptNumber;
+        pxRate->ulRateGeneration = ulGeneration;
+        pxRate->ulRateHz = ulRateHz;
+
+        prvInitThreadAttributes( &xThreadAttributes, configPOSIX_TIMER_CPU_AFFINITY, configPOSIX_SCHED_FIFO_PRIORITY + 1 );
+        pthread_attr_setdetachstate( &xThreadAttributes, PTHREAD_CREATE_DETACHED );
+
+        iRet = pthread_create( &hThread, &xThreadAttributes, prvInterruptRateThread, pxRate );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_create", iRet );
+        }
+
+        pthread_attr_destroy( &xThreadAttributes );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void * prvInterruptRateThread( void * pvParams )
+{
+    const InterruptRate_t xRate = *( ( InterruptRate_t * ) pvParams );
+    const SimulatedInterrupt_t * pxInterrupt = &( xInterrupts[ xRate.ulInterruptNumber ] );
+    const uint64_t ullStartNs = prvGetTimeNs();
+    uint64_t ullPeriod = 0;
+    sigset_t xSignals;
+
+    free( pvParams );
+
+    /* This is a host thread, not a FreeRTOS task, so must not handle the
+     * simulated interrupts itself. */
+    sigfillset( &xSignals );
+    ( void ) pthread_sigmask( SIG_SETMASK, &xSignals, NULL );
+
+    prvPortSetCurrentThreadName( "Interrupt rate" );
+
+    while( pxInterrupt->ulRateGeneration == xRate.ulRateGeneration )
+    {
+        ullPeriod++;
+        prvSleepUntil( prvGetDeadlineNs( ullStartNs, ullPeriod, xRate.ulRateHz ) );
+
+        if( pxInterrupt->ulRateGeneration == xRate.ulRateGeneration )
+        {
+            prvRaiseInterrupt( xRate.ulInterruptNumber );
+        }
+
+        /* An interrupt that is raised again before it is handled is only
+         * handled once, so periods that were missed are skipped. */
+        while( prvGetDeadlineNs( ullStartNs, ullPeriod + 1, xRate.ulRateHz ) <= prvGetTimeNs() )
+        {
+            ullPeriod++;
+        }
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Setup the systick timer to generate the tick interrupts at the required
+ * frequency.
+ */
+void prvSetupTimerInterrupt( void )
+{
+    pthread_attr_t xThreadAttributes;
+    int iRet;
+
+    prvStartTimeNs = prvGetTimeNs();
+    ulPendingTicks = 0;
+
+    /* The timer thread runs above the task threads so that it can interrupt
+     * a task that never blocks. */
+    prvInitThreadAttributes( &xThreadAttributes, configPOSIX_TIMER_CPU_AFFINITY, configPOSIX_SCHED_FIFO_PRIORITY + 1 );
+
+    xTimerTickThreadShouldRun = true;
+    iRet = pthread_create( &hTimerTickThread, &xThreadAttributes, prvTimerTickHandler, NULL );
+
+    if( iRet != 0 )
+    {
+        prvFatalError( "pthread_create", iRet );
+    }
+
+    pthread_attr_destroy( &xThreadAttributes );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Passes every tick counted by the timer thread since the last call to the
+ * kernel, returning pdTRUE if any of them requires a context switch.  This is
+ * the same catch up that xTaskCatchUpTicks() performs, which cannot be used
+ * here as it must be called from a task.
+ */
+static BaseType_t prvProcessPendingTicks( void )
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+    uint32_t ulTicks = __atomic_exchange_n( &ulPendingTicks, 0, __ATOMIC_RELAXED );
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* The tick must hold the ISR lock while it updates the delayed
+         * lists. */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    #endif
+
+    while( ulTicks > 0U )
+    {
+        if( xTaskIncrementTick() != pdFALSE )
+        {
+            xSwitchRequired = pdTRUE;
+        }
+
+        ulTicks--;
+    }
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    #endif
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Calls the handlers of the pending interrupts in ulInterruptMask, highest
+ * priority first, until none are pending.  Returns pdTRUE if any of them
+ * requires a context switch.
+ */
+static BaseType_t prvDispatchInterrupts( uint32_t ulInterruptMask )
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+    const BaseType_t xInterruptInterrupted = xInterruptInService;
+    uint32_t ulPending;
+    uint32_t ulInterruptNumber;
+    uint32_t ulHighest;
+
+    for( ; ; )
+    {
+        ulPending = __atomic_load_n( &ulPendingInterrupts, __ATOMIC_RELAXED ) & ulInterruptMask;
+
+        if( ulPending == 0U )
+        {
+            break;
+        }
+
+        /* Equal priorities are handled lowest number first, so the tick
+         * comes before the application defined interrupts of priority 0. */
+        ulHighest = ( uint32_t ) __builtin_ctz( ulPending );
+
+        for( ulInterruptNumber = ulHighest + 1U; ulInterruptNumber < portMAX_INTERRUPTS; ulInterruptNumber++ )
+        {
+            if( ( ( ulPending & ( ( uint32_t ) 1UL << ulInterruptNumber ) ) != 0U ) &&
+                ( xInterrupts[ ulInterruptNumber ].uxPriority > xInterrupts[ ulHighest ].uxPriority ) )
+            {
+                ulHighest = ulInterruptNumber;
+            }
+        }
+
+        ( void ) __atomic_and_fetch( &ulPendingInterrupts, ~( ( uint32_t ) 1UL << ulHighest ), __ATOMIC_RELAXED );
+
+        xInterruptInService = ( BaseType_t ) ulHighest;
+
+        if( ulHighest == portINTERRUPT_TICK )
+        {
+            if( prvProcessPendingTicks() != pdFALSE )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+        else if( xInterrupts[ ulHighest ].pvHandler != NULL )
+        {
+            if( xInterrupts[ ulHighest ].pvHandler() != 0U )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xInterruptInService = xInterruptInterrupted;
+    }
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_SCHEDULE_LOG == 1 )
+
+    static void prvFlushScheduleLog( void )
+    {
+        size_t xWritten = 0;
+        ssize_t xRet;
+
+        while( xWritten < xScheduleLogLength )
+        {
+            xRet = write( iScheduleLogFile, &( ucScheduleLogBuffer[ xWritten ] ), xScheduleLogLength - xWritten );
+
+            if( xRet >= 0 )
+            {
+                xWritten += ( size_t ) xRet;
+            }
+            else if( errno != EINTR )
+            {
+                prvFatalError( "write", errno );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        xScheduleLogLength = 0;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLogValue( uint64_t ullValue )
+    {
+        /* A 64-bit value takes at most 10 bytes. */
+        if( xScheduleLogLength > ( sizeof( ucScheduleLogBuffer ) - 10U ) )
+        {
+            prvFlushScheduleLog();
+        }
+
+        while( ullValue >= 0x80U )
+        {
+            ucScheduleLogBuffer[ xScheduleLogLength++ ] = ( uint8_t ) ( ( ullValue & 0x7FU ) | 0x80U );
+            ullValue >>= 7;
+        }
+
+        ucScheduleLogBuffer[ xScheduleLogLength++ ] = ( uint8_t ) ullValue;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReadLogByte( uint8_t * pucByte )
+    {
+        ssize_t xRet;
+
+        if( xScheduleLogRead == xScheduleLogLength )
+        {
+            do
+            {
+                xRet = read( iScheduleLogFile, ucScheduleLogBuffer, sizeof( ucScheduleLogBuffer ) );
+            } while( ( xRet == -1 ) && ( errno == EINTR ) );
+
+            if( xRet == -1 )
+            {
+                prvFatalError( "read", errno );
+            }
+
+            if( xRet == 0 )
+            {
+                return pdFALSE;
+            }
+
+            xScheduleLogLength = ( size_t ) xRet;
+            xScheduleLogRead = 0;
+        }
+
+        *pucByte = ucScheduleLogBuffer[ xScheduleLogRead++ ];
+
+        return pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReadLogValue( uint64_t * pullValue )
+    {
+        uint32_t ulShift = 0;
+        uint8_t ucByte;
+
+        *pullValue = 0;
+
+        do
+        {
+            if( ( ulShift >= 64U ) || ( prvReadLogByte( &ucByte ) == pdFALSE ) )
+            {
+                return pdFALSE;
+            }
+
+            *pullValue |= ( uint64_t ) ( ucByte & 0x7FU ) << ulShift;
+            ulShift += 7U;
+        } while( ( ucByte & 0x80U ) != 0U );
+
+        return pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    /*
+     * Reads the next record into xNextRecord.  At the end of the log the
+     * replay stops and interrupts are taken as they arrive again.
+     */
+    static void prvReadLogRecord( void )
+    {
+        uint64_t ullValue;
+        uint64_t ullTicks = 0;
+        uint64_t ullInterrupts = 0;
+        BaseType_t xComplete;
+
+        xComplete = prvReadLogValue( &ullValue );
+
+        if( ( xComplete == pdTRUE ) && ( ( ullValue & portLOG_RECORD_TYPE_MASK ) != portLOG_RECORD_SWITCH ) )
+        {
+            if( ( prvReadLogValue( &ullTicks ) == pdFALSE ) || ( prvReadLogValue( &ullInterrupts ) == pdFALSE ) )
+            {
+                xComplete = pdFALSE;
+            }
+        }
+
+        if( xComplete == pdTRUE )
+        {
+            xNextRecord.ulType = ( uint32_t ) ( ullValue & portLOG_RECORD_TYPE_MASK );
+            xNextRecord.ullValue = ullValue >> portLOG_RECORD_TYPE_BITS;
+            xNextRecord.ulTicks = ( uint32_t ) ullTicks;
+            xNextRecord.ulInterrupts = ( uint32_t ) ullInterrupts;
+
+            if( xNextRecord.ulType != portLOG_RECORD_SWITCH )
+            {
+                xNextRecord.ullValue += ullLastLoggedWindow;
+                ullLastLoggedWindow = xNextRecord.ullValue;
+            }
+        }
+        else
+        {
+            fprintf( stderr, "Schedule replay finished at interrupt window %llu\n", ( unsigned long long ) ullInterruptWindows );
+            prvCloseScheduleLog();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvScheduleDiverged( void ) __attribute__( ( __noreturn__ ) );
+
+    static void prvScheduleDiverged( void )
+    {
+        fprintf( stderr, "Schedule replay diverged from the log at interrupt window %llu\n", ( unsigned long long ) ullInterruptWindows );
+        abort();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvOpenScheduleLog( const char * pcFileName,
+                                    BaseType_t xMode )
+    {
+        static BaseType_t xFlushRegistered = pdFALSE;
+        uint8_t ucMagic[ portSCHEDULE_LOG_MAGIC_LENGTH ];
+        size_t x;
+
+        configASSERT( xScheduleLogMode == portSCHEDULE_LOG_OFF );
 
-    vPortEnterCritical();
+        xScheduleLogLength = 0;
+        xScheduleLogRead = 0;
+        ullInterruptWindows = 0;
+        ullLastLoggedWindow = 0;
 
-    prvPortYieldFromISR();
+        if( xMode == portSCHEDULE_LOG_RECORD )
+        {
+            iScheduleLogFile = open( pcFileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
 
-    vPortExitCritical();
-}
+            if( iScheduleLogFile == -1 )
+            {
+                prvFatalError( "open", errno );
+            }
+
+            memcpy( ucScheduleLogBuffer, portSCHEDULE_LOG_MAGIC, portSCHEDULE_LOG_MAGIC_LENGTH );
+            xScheduleLogLength = portSCHEDULE_LOG_MAGIC_LENGTH;
+
+            /* Tasks may end the program without ending the scheduler. */
+            if( xFlushRegistered == pdFALSE )
+            {
+                ( void ) atexit( prvCloseScheduleLog );
+                xFlushRegistered = pdTRUE;
+            }
+
+            xScheduleLogMode = xMode;
+        }
+        else
+        {
+            iScheduleLogFile = open( pcFileName, O_RDONLY | O_CLOEXEC );
+
+            if( iScheduleLogFile == -1 )
+            {
+                prvFatalError( "open", errno );
+            }
+
+            for( x = 0; x < portSCHEDULE_LOG_MAGIC_LENGTH; x++ )
+            {
+                if( prvReadLogByte( &( ucMagic[ x ] ) ) == pdFALSE )
+                {
+                    break;
+                }
+            }
+
+            if( ( x != portSCHEDULE_LOG_MAGIC_LENGTH ) || ( memcmp( ucMagic, portSCHEDULE_LOG_MAGIC, portSCHEDULE_LOG_MAGIC_LENGTH ) != 0 ) )
+            {
+                fprintf( stderr, "%s is not a schedule log\n", pcFileName );
+                abort();
+            }
+
+            xScheduleLogMode = xMode;
+            prvReadLogRecord();
+        }
+    }
 /*-----------------------------------------------------------*/
 
-void vPortDisableInterrupts( void )
-{
-    if( prvIsFreeRTOSThread() == pdTRUE )
+    static void prvCloseScheduleLog( void )
     {
-        pthread_sigmask( SIG_BLOCK, &xAllSignals, NULL );
+        if( xScheduleLogMode == portSCHEDULE_LOG_RECORD )
+        {
+            prvFlushScheduleLog();
+        }
+
+        if( xScheduleLogMode != portSCHEDULE_LOG_OFF )
+        {
+            xScheduleLogMode = portSCHEDULE_LOG_OFF;
+            ( void ) close( iScheduleLogFile );
+            iScheduleLogFile = -1;
+        }
     }
-}
 /*-----------------------------------------------------------*/
 
-void vPortEnableInterrupts( void )
-{
-    if( prvIsFreeRTOSThread() == pdTRUE )
+    void vPortRecordSchedule( const char * pcFileName )
     {
-        pthread_sigmask( SIG_UNBLOCK, &xAllSignals, NULL );
+        prvOpenScheduleLog( pcFileName, portSCHEDULE_LOG_RECORD );
     }
-}
 /*-----------------------------------------------------------*/
 
-UBaseType_t xPortSetInterruptMask( void )
-{
-    /* Interrupts are always disabled inside ISRs (signals
-     * handlers). */
-    return ( UBaseType_t ) 0;
-}
+    void vPortReplaySchedule( const char * pcFileName )
+    {
+        prvOpenScheduleLog( pcFileName, portSCHEDULE_LOG_REPLAY );
+    }
 /*-----------------------------------------------------------*/
 
-void vPortClearInterruptMask( UBaseType_t uxMask )
-{
-    ( void ) uxMask;
-}
+    /*
+     * Returns pdTRUE if the idle task is running with the scheduler running.
+     * Only the timing of the idle task varies between runs, and it does
+     * nothing that another task can see, so interrupts can be taken at any
+     * point while it runs.
+     */
+    static BaseType_t prvIsIdleTaskRunning( void )
+    {
+        BaseType_t xRunning = pdFALSE;
+
+        if( ( xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandle() ) &&
+            ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) )
+        {
+            xRunning = pdTRUE;
+        }
+
+        return xRunning;
+    }
 /*-----------------------------------------------------------*/
 
-static uint64_t prvGetTimeNs( void )
-{
-    struct timespec t;
+    /*
+     * Moves the ticks and interrupts that are to be taken now into
+     * ulPendingTicks and ulPendingInterrupts, returning pdTRUE if there are
+     * any.  When recording these are the ones that have arrived, which are
+     * logged against the current interrupt window as a record of type ulType.
+     * A portLOG_RECORD_FORCED_INTERRUPT record is only made once
+     * configPOSIX_SCHEDULE_LOG_FORCE_TICKS ticks have arrived.  When
+     * replaying they are the ones logged against the window with that type.
+     * Called with interrupts masked.
+     */
+    static BaseType_t prvScheduleInterrupts( uint32_t ulType )
+    {
+        BaseType_t xScheduled = pdFALSE;
+        uint32_t ulTicks = 0;
+        uint32_t ulInterrupts = 0;
 
-    clock_gettime( CLOCK_MONOTONIC, &t );
+        if( xScheduleLogMode == portSCHEDULE_LOG_RECORD )
+        {
+            if( ( ulType != portLOG_RECORD_FORCED_INTERRUPT ) ||
+                ( __atomic_load_n( &ulArrivedTicks, __ATOMIC_RELAXED ) >= ( uint32_t ) configPOSIX_SCHEDULE_LOG_FORCE_TICKS ) )
+            {
+                ulInterrupts = __atomic_exchange_n( &ulArrivedInterrupts, 0, __ATOMIC_RELAXED );
+                ulTicks = __atomic_exchange_n( &ulArrivedTicks, 0, __ATOMIC_RELAXED );
+            }
+
+            if( ( ulInterrupts != 0U ) || ( ulTicks != 0U ) )
+            {
+                prvLogValue( ( ( ullInterruptWindows - ullLastLoggedWindow ) << portLOG_RECORD_TYPE_BITS ) | ulType );
+                prvLogValue( ulTicks );
+                prvLogValue( ulInterrupts );
+                ullLastLoggedWindow = ullInterruptWindows;
+                xScheduled = pdTRUE;
+            }
+        }
+        else if( xScheduleLogMode == portSCHEDULE_LOG_REPLAY )
+        {
+            if( ( xNextRecord.ulType == ulType ) && ( xNextRecord.ullValue == ullInterruptWindows ) )
+            {
+                ulInterrupts = xNextRecord.ulInterrupts;
+                ulTicks = xNextRecord.ulTicks;
+                xScheduled = pdTRUE;
+                prvReadLogRecord();
+            }
+            else if( ( ulType == portLOG_RECORD_INTERRUPT ) &&
+                     ( ( xNextRecord.ulType == portLOG_RECORD_INTERRUPT ) || ( xNextRecord.ulType == portLOG_RECORD_FORCED_INTERRUPT ) ) &&
+                     ( xNextRecord.ullValue < ullInterruptWindows ) )
+            {
+                prvScheduleDiverged();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-    return ( uint64_t ) t.tv_sec * ( uint64_t ) 1000000000UL + ( uint64_t ) t.tv_nsec;
-}
+        if( xScheduled == pdTRUE )
+        {
+            ( void ) __atomic_add_fetch( &ulPendingTicks, ulTicks, __ATOMIC_RELAXED );
+            ( void ) __atomic_or_fetch( &ulPendingInterrupts, ulInterrupts, __ATOMIC_RELAXED );
+        }
+
+        return xScheduled;
+    }
+/*-----------------------------------------------------------*/
+
+    /*
+     * Called when a task enables interrupts, before they are unmasked.
+     * Interrupts are only taken at these windows, which a task passes at the
+     * same points of its execution in every run, so that the log can place
+     * them exactly.  The idle task's windows are not counted.
+     */
+    static void prvInterruptWindow( void )
+    {
+        BaseType_t xScheduled;
+
+        if( xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandle() )
+        {
+            xScheduled = ( prvIsIdleTaskRunning() == pdTRUE ) ? prvScheduleInterrupts( portLOG_RECORD_IDLE_INTERRUPT ) : pdFALSE;
+        }
+        else
+        {
+            ullInterruptWindows++;
+            xScheduled = prvScheduleInterrupts( portLOG_RECORD_INTERRUPT );
+        }
+
+        /* Taken by the tick handler once interrupts are unmasked. */
+        if( xScheduled == pdTRUE )
+        {
+            xInterruptPending = pdTRUE;
+        }
+    }
 /*-----------------------------------------------------------*/
 
-/* commented as part of the code below in vPortSystemTickHandler,
- * to adjust timing according to full demo requirements */
-/* static uint64_t prvTickCount; */
+    /*
+     * Called, when replaying, as a task masks interrupts that were enabled.
+     * Interrupts that were forced on the task since its last window were
+     * taken before it masked interrupts again when recorded, so if no tick
+     * has arrived to take them yet they are taken now, calling their handlers
+     * and switching context as the tick handler would.  Called with
+     * interrupts masked.
+     */
+    static void prvTakeForcedInterrupts( void )
+    {
+        Thread_t * pxThreadToSuspend;
+        Thread_t * pxThreadToResume;
+
+        if( ( xTaskGetCurrentTaskHandle() != xTaskGetIdleTaskHandle() ) &&
+            ( prvScheduleInterrupts( portLOG_RECORD_FORCED_INTERRUPT ) == pdTRUE ) )
+        {
+            pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
-static void * prvTimerTickHandler( void * arg )
-{
-    ( void ) arg;
+            uxCriticalNesting++;
 
-    prvMarkAsFreeRTOSThread();
+            if( prvDispatchInterrupts( ~ulHighPriorityInterrupts ) != pdFALSE )
+            {
+                vTaskSwitchContext();
+                prvLogSwitch();
 
-    prvPortSetCurrentThreadName( "Scheduler timer" );
+                pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
 
-    while( xTimerTickThreadShouldRun )
+                prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+            }
+
+            uxCriticalNesting--;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    /*
+     * Logs the task selected by vTaskSwitchContext(), or when replaying
+     * checks it is the one that was logged.
+     */
+    static void prvLogSwitch( void )
     {
-        /*
-         * signal to the active task to cause tick handling or
-         * preemption (if enabled)
-         */
-        Thread_t * thread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
-        pthread_kill( thread->pthread, SIGALRM );
-        usleep( portTICK_RATE_MICROSECONDS );
+        const uint32_t ulThreadNumber = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() )->ulThreadNumber;
+
+        if( xScheduleLogMode == portSCHEDULE_LOG_RECORD )
+        {
+            prvLogValue( ( ( uint64_t ) ulThreadNumber << portLOG_RECORD_TYPE_BITS ) | portLOG_RECORD_SWITCH );
+        }
+        else if( xScheduleLogMode == portSCHEDULE_LOG_REPLAY )
+        {
+            if( ( xNextRecord.ulType != portLOG_RECORD_SWITCH ) || ( xNextRecord.ullValue != ulThreadNumber ) )
+            {
+                prvScheduleDiverged();
+            }
+
+            prvReadLogRecord();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
 
-    return NULL;
-}
+#endif /* configPOSIX_SCHEDULE_LOG == 1 */
 /*-----------------------------------------------------------*/
 
-/*
- * Setup the systick timer to generate the tick interrupts at the required
- * frequency.
- */
-void prvSetupTimerInterrupt( void )
-{
-    xTimerTickThreadShouldRun = true;
-    pthread_create( &hTimerTickThread, NULL, prvTimerTickHandler, NULL );
+#ifdef configASSERT
 
-    prvStartTimeNs = prvGetTimeNs();
-}
+    void vPortValidateInterruptPriority( void )
+    {
+        /* Interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY are not masked
+         * by critical sections, so must not call the FreeRTOS API. */
+        if( xInterruptInService >= 0 )
+        {
+            configASSERT( xInterrupts[ xInterruptInService ].uxPriority <= ( UBaseType_t ) configMAX_SYSCALL_INTERRUPT_PRIORITY );
+        }
+    }
+
+#endif /* configASSERT */
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_VIRTUAL_TIME == 1 )
+
+    /*
+     * Called by the idle task, with the scheduler suspended, when no task can
+     * run for at least xExpectedIdleTime ticks.  Nothing can happen until then
+     * other than an interrupt, so rather than sleeping the tick count is stepped
+     * straight to the time the next task unblocks.
+     */
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* A tick that the timer thread has counted but the tick handler
+             * has not yet processed would be applied after the step, so the
+             * step waits until it has been processed.  When every task is
+             * blocked indefinitely there is no time to step to. */
+            if( ( eTaskConfirmSleepModeStatus() == eStandardSleep ) && ( ulPendingTicks == 0U ) )
+            {
+                vTaskStepTick( xExpectedIdleTime );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configPOSIX_VIRTUAL_TIME == 1 */
 /*-----------------------------------------------------------*/
 
+/*
+ * Handles the tick and the other simulated interrupts at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ */
 static void vPortSystemTickHandler( int sig )
 {
     if( prvIsFreeRTOSThread() == pdTRUE )
     {
-        Thread_t * pxThreadToSuspend;
-        Thread_t * pxThreadToResume;
+        const uint32_t ulInterruptMask = ~ulHighPriorityInterrupts;
 
         ( void ) sig;
 
-        uxCriticalNesting++; /* Signals are blocked in this signal handler. */
-
-        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
-
-        if( xTaskIncrementTick() != pdFALSE )
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
         {
-            /* Select Next Task. */
-            vTaskSwitchContext();
-
-            pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+            if( xInterruptsMasked == pdTRUE )
+            {
+                /* Handled when interrupts are enabled again. */
+                xInterruptPending = pdTRUE;
+                return;
+            }
+
+            #if ( configPOSIX_SCHEDULE_LOG == 1 )
+            {
+                /* Interrupts are only taken where they have been placed in
+                 * the schedule by an interrupt window, straight away while
+                 * the idle task is running, or when forced on a task that has
+                 * not passed a window for too long. */
+                if( ( xScheduleLogMode != portSCHEDULE_LOG_OFF ) && ( ( ulPendingInterrupts & ulInterruptMask ) == 0U ) )
+                {
+                    BaseType_t xScheduled = pdFALSE;
+
+                    xInterruptsMasked = pdTRUE;
+
+                    if( prvIsIdleTaskRunning() == pdTRUE )
+                    {
+                        xScheduled = prvScheduleInterrupts( portLOG_RECORD_IDLE_INTERRUPT );
+                    }
+                    else if( xTaskGetCurrentTaskHandle() != xTaskGetIdleTaskHandle() )
+                    {
+                        xScheduled = prvScheduleInterrupts( portLOG_RECORD_FORCED_INTERRUPT );
+                    }
+                    else
+                    {
+                        /* The idle task with the scheduler suspended, whose
+                         * timing is not repeatable. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xScheduled == pdFALSE )
+                    {
+                        xInterruptsMasked = pdFALSE;
+                        return;
+                    }
+                }
+            }
+            #endif
+
+            xInterruptPending = pdFALSE;
+            xInterruptsMasked = pdTRUE;
+        }
+        #endif
 
-            prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            Thread_t * pxThreadToSuspend;
+            Thread_t * pxThreadToResume;
+
+            uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+
+            pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+            #if ( configPOSIX_VIRTUAL_TIME == 1 )
+            {
+                /* Simulated time only passes while the idle task runs.  A tick
+                 * that arrives while another task runs measures how long the
+                 * host took to run it, which differs between runs, so is
+                 * discarded. */
+                if( xTaskGetCurrentTaskHandle() != xTaskGetIdleTaskHandle() )
+                {
+                    ( void ) __atomic_exchange_n( &ulPendingTicks, 0, __ATOMIC_RELAXED );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif
+
+            if( prvDispatchInterrupts( ulInterruptMask ) != pdFALSE )
+            {
+                /* Select Next Task. */
+                vTaskSwitchContext();
+
+                #if ( configPOSIX_SCHEDULE_LOG == 1 )
+                {
+                    prvLogSwitch();
+                }
+                #endif
+
+                pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+                prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+            }
+
+            uxCriticalNesting--;
+        }
+        #else /* configNUMBER_OF_CORES == 1 */
+        {
+            /* vTaskSwitchContext() must be called outside of the critical
+             * section taken by the tick. */
+            if( prvDispatchInterrupts( ulInterruptMask ) != pdFALSE )
+            {
+                prvPortYieldFromISR();
+            }
         }
+        #endif /* configNUMBER_OF_CORES == 1 */
 
-        uxCriticalNesting--;
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
+        {
+            xInterruptsMasked = pdFALSE;
+        }
+        #endif
     }
     else
     {
@@ -516,6 +2323,35 @@ static void vPortSystemTickHandler( int sig )
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * Handles the simulated interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ * SIG_HIGH_INTERRUPT is not blocked by critical sections or by
+ * vPortSystemTickHandler(), and these handlers cannot request a context
+ * switch as they must not call the FreeRTOS API.
+ */
+static void prvHighPriorityInterruptHandler( int sig )
+{
+    ( void ) sig;
+
+    if( prvIsFreeRTOSThread() == pdTRUE )
+    {
+        ( void ) prvDispatchInterrupts( ulHighPriorityInterrupts );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+    static void prvYieldHandler( int sig )
+    {
+        ( void ) sig;
+
+        prvPortYieldFromISR();
+    }
+
+#endif /* configNUMBER_OF_CORES > 1 */
+/*-----------------------------------------------------------*/
+
 void vPortThreadDying( void * pxTaskToDelete,
                        volatile BaseType_t * pxPendYield )
 {
@@ -529,51 +2365,100 @@ void vPortThreadDying( void * pxTaskToDelete,
 
 void vPortCancelThread( void * pxTaskToDelete )
 {
-    Thread_t * pxThreadToCancel = prvGetThreadFromTask( pxTaskToDelete );
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        /* The task's context lives on its stack, which the kernel frees, and
+         * the task is never resumed once deleted, so there is nothing to do. */
+        ( void ) pxTaskToDelete;
+    }
+    #else
+    {
+        Thread_t * pxThreadToCancel = prvGetThreadFromTask( pxTaskToDelete );
 
-    /*
-     * The thread has already been suspended so it can be safely cancelled.
-     */
-    pthread_cancel( pxThreadToCancel->pthread );
-    event_signal( pxThreadToCancel->ev );
-    pthread_join( pxThreadToCancel->pthread, NULL );
-    event_delete( pxThreadToCancel->ev );
+        /*
+         * The thread has already been suspended so it can be safely cancelled.
+         */
+        pthread_cancel( pxThreadToCancel->pthread );
+        event_signal( pxThreadToCancel->ev );
+        pthread_join( pxThreadToCancel->pthread, NULL );
+        event_delete( pxThreadToCancel->ev );
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
-static void * prvWaitForStart( void * pvParams )
-{
-    Thread_t * pxThread = pvParams;
+#if ( configPOSIX_USE_UCONTEXT == 1 )
 
-    prvMarkAsFreeRTOSThread();
+    static void prvTaskEntry( void )
+    {
+        /* A task's context is only ever resumed by a switch to that task, so
+         * the first time it runs it is the current task. */
+        Thread_t * pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        /* Resumed for the first time, unblocks all signals. */
+        uxCriticalNesting = 0;
+        vPortEnableInterrupts();
 
-    prvSuspendSelf( pxThread );
+        /* Call the task's entry point. */
+        pxThread->pxCode( pxThread->pvParams );
 
-    /* Resumed for the first time, unblocks all signals. */
-    uxCriticalNesting = 0;
-    vPortEnableInterrupts();
+        /* A function that implements a task must not exit or attempt to return
+         * to its caller as there is nothing to return to. If a task wants to
+         * exit it should instead call vTaskDelete( NULL ). Artificially force
+         * an assert() to be triggered if configASSERT() is defined, so
+         * application writers can catch the error. */
+        configASSERT( pdFALSE );
+    }
 
-    /* Set thread name */
-    prvPortSetCurrentThreadName( pcTaskGetName( xTaskGetCurrentTaskHandle() ) );
+#else /* configPOSIX_USE_UCONTEXT */
 
-    /* Call the task's entry point. */
-    pxThread->pxCode( pxThread->pvParams );
+    static void * prvWaitForStart( void * pvParams )
+    {
+        Thread_t * pxThread = pvParams;
 
-    /* A function that implements a task must not exit or attempt to return to
-     * its caller as there is nothing to return to. If a task wants to exit it
-     * should instead call vTaskDelete( NULL ). Artificially force an assert()
-     * to be triggered if configASSERT() is defined, so application writers can
-     * catch the error. */
-    configASSERT( pdFALSE );
+        prvMarkAsFreeRTOSThread();
 
-    return NULL;
-}
+        #if ( configNUMBER_OF_CORES > 1 )
+        {
+            pxThisThread = pxThread;
+        }
+        #endif
+
+        prvSuspendSelf( pxThread );
+
+        /* Resumed for the first time, unblocks all signals. */
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            uxCriticalNesting = 0;
+        }
+        #endif
+        vPortEnableInterrupts();
+
+        /* Set thread name */
+        prvPortSetCurrentThreadName( pcTaskGetName( xTaskGetCurrentTaskHandle() ) );
+
+        /* Call the task's entry point. */
+        pxThread->pxCode( pxThread->pvParams );
+
+        /* A function that implements a task must not exit or attempt to return to
+         * its caller as there is nothing to return to. If a task wants to exit it
+         * should instead call vTaskDelete( NULL ). Artificially force an assert()
+         * to be triggered if configASSERT() is defined, so application writers can
+         * catch the error. */
+        configASSERT( pdFALSE );
+
+        return NULL;
+    }
+
+#endif /* configPOSIX_USE_UCONTEXT */
 /*-----------------------------------------------------------*/
 
 static void prvSwitchThread( Thread_t * pxThreadToResume,
                              Thread_t * pxThreadToSuspend )
 {
-    BaseType_t uxSavedCriticalNesting;
+    #if ( configNUMBER_OF_CORES == 1 )
+        BaseType_t uxSavedCriticalNesting;
+    #endif
 
     if( pxThreadToSuspend != pxThreadToResume )
     {
@@ -582,52 +2467,77 @@ static void prvSwitchThread( Thread_t * pxThreadToResume,
          *
          * The critical section nesting is per-task, so save it on the
          * stack of the current (suspending thread), restoring it when
-         * we switch back to this task.
+         * we switch back to this task.  With more than one core the
+         * kernel keeps it in the TCB instead.
          */
-        uxSavedCriticalNesting = uxCriticalNesting;
-
-        prvResumeThread( pxThreadToResume );
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            uxSavedCriticalNesting = uxCriticalNesting;
+        }
+        #endif
 
-        if( pxThreadToSuspend->xDying == pdTRUE )
+        #if ( configPOSIX_USE_UCONTEXT == 1 )
         {
-            pthread_exit( NULL );
+            /* A dying task's context is saved but never resumed. */
+            if( swapcontext( &pxThreadToSuspend->xContext, &pxThreadToResume->xContext ) == -1 )
+            {
+                prvFatalError( "swapcontext", errno );
+            }
         }
+        #else
+        {
+            prvResumeThread( pxThreadToResume );
+
+            if( pxThreadToSuspend->xDying == pdTRUE )
+            {
+                pthread_exit( NULL );
+            }
 
-        prvSuspendSelf( pxThreadToSuspend );
+            prvSuspendSelf( pxThreadToSuspend );
+        }
+        #endif
 
-        uxCriticalNesting = uxSavedCriticalNesting;
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            uxCriticalNesting = uxSavedCriticalNesting;
+        }
+        #endif
     }
 }
 /*-----------------------------------------------------------*/
 
-static void prvSuspendSelf( Thread_t * thread )
-{
-    /*
-     * Suspend this thread by waiting for a pthread_cond_signal event.
-     *
-     * A suspended thread must not handle signals (interrupts) so
-     * all signals must be blocked by calling this from:
-     *
-     * - Inside a critical section (vPortEnterCritical() /
-     *   vPortExitCritical()).
-     *
-     * - From a signal handler that has all signals masked.
-     *
-     * - A thread with all signals blocked with pthread_sigmask().
-     */
-    event_wait( thread->ev );
-    pthread_testcancel();
-}
+#if ( configPOSIX_USE_UCONTEXT == 0 )
 
-/*-----------------------------------------------------------*/
+    static void prvSuspendSelf( Thread_t * thread )
+    {
+        /*
+         * Suspend this thread by waiting for a pthread_cond_signal event.
+         *
+         * A suspended thread must not handle signals (interrupts) so
+         * all signals must be blocked by calling this from:
+         *
+         * - Inside a critical section (vPortEnterCritical() /
+         *   vPortExitCritical()).
+         *
+         * - From a signal handler that has all signals masked.
+         *
+         * - A thread with all signals blocked with pthread_sigmask().
+         */
+        event_wait( thread->ev );
+        pthread_testcancel();
+    }
 
-static void prvResumeThread( Thread_t * xThreadId )
-{
-    if( pthread_self() != xThreadId->pthread )
+    /*-----------------------------------------------------------*/
+
+    static void prvResumeThread( Thread_t * xThreadId )
     {
-        event_signal( xThreadId->ev );
+        if( pthread_self() != xThreadId->pthread )
+        {
+            event_signal( xThreadId->ev );
+        }
     }
-}
+
+#endif /* configPOSIX_USE_UCONTEXT */
 /*-----------------------------------------------------------*/
 
 static void prvSetupSignalsAndSchedulerPolicy( void )
@@ -644,6 +2554,10 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
      * in a critical section. */
     sigdelset( &xAllSignals, SIGINT );
 
+    /* Simulated interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY are
+     * never masked. */
+    sigdelset( &xAllSignals, SIG_HIGH_INTERRUPT );
+
     /*
      * Block all signals in this thread so all new threads
      * inherits this mask.
@@ -658,6 +2572,7 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     sigtick.sa_flags = 0;
     sigtick.sa_handler = vPortSystemTickHandler;
     sigfillset( &sigtick.sa_mask );
+    sigdelset( &sigtick.sa_mask, SIG_HIGH_INTERRUPT );
 
     iRet = sigaction( SIGALRM, &sigtick, NULL );
 
@@ -665,6 +2580,39 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     {
         prvFatalError( "sigaction", errno );
     }
+
+    sigtick.sa_handler = prvHighPriorityInterruptHandler;
+    sigfillset( &sigtick.sa_mask );
+
+    #if ( configPOSIX_USE_UCONTEXT == 1 )
+    {
+        sigtick.sa_flags = SA_ONSTACK;
+    }
+    #endif
+
+    iRet = sigaction( SIG_HIGH_INTERRUPT, &sigtick, NULL );
+
+    if( iRet == -1 )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+
+    #if ( configNUMBER_OF_CORES > 1 )
+    {
+        struct sigaction sigyield;
+
+        sigyield.sa_flags = 0;
+        sigyield.sa_handler = prvYieldHandler;
+        sigfillset( &sigyield.sa_mask );
+
+        iRet = sigaction( SIG_YIELD, &sigyield, NULL );
+
+        if( iRet == -1 )
+        {
+            prvFatalError( "sigaction", errno );
+        }
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -102,20 +102,60 @@ extern void vPortYield( void );
 /* Critical section management. */
 extern void vPortDisableInterrupts( void );
 extern void vPortEnableInterrupts( void );
-#define portSET_INTERRUPT_MASK()      ( vPortDisableInterrupts() )
-#define portCLEAR_INTERRUPT_MASK()    ( vPortEnableInterrupts() )
+#define portDISABLE_INTERRUPTS()    vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()     vPortEnableInterrupts()
 
 extern UBaseType_t xPortSetInterruptMask( void );
 extern void vPortClearInterruptMask( UBaseType_t xMask );
-
-extern void vPortEnterCritical( void );
-extern void vPortExitCritical( void );
 #define portSET_INTERRUPT_MASK_FROM_ISR()         xPortSetInterruptMask()
 #define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )    vPortClearInterruptMask( x )
-#define portDISABLE_INTERRUPTS()                  portSET_INTERRUPT_MASK()
-#define portENABLE_INTERRUPTS()                   portCLEAR_INTERRUPT_MASK()
-#define portENTER_CRITICAL()                      vPortEnterCritical()
-#define portEXIT_CRITICAL()                       vPortExitCritical()
+
+#if ( configNUMBER_OF_CORES == 1 )
+    #define portSET_INTERRUPT_MASK()      ( vPortDisableInterrupts() )
+    #define portCLEAR_INTERRUPT_MASK()    ( vPortEnableInterrupts() )
+
+    extern void vPortEnterCritical( void );
+    extern void vPortExitCritical( void );
+    #define portENTER_CRITICAL()    vPortEnterCritical()
+    #define portEXIT_CRITICAL()     vPortExitCritical()
+#else
+
+/* Each core is the host thread of the task running on it, so masking
+ * interrupts masks signals for the calling thread only. */
+    #define portSET_INTERRUPT_MASK()           xPortSetInterruptMask()
+    #define portCLEAR_INTERRUPT_MASK( x )      vPortClearInterruptMask( x )
+
+    #define portCRITICAL_NESTING_IN_TCB        1
+
+    extern void vTaskEnterCritical( void );
+    extern void vTaskExitCritical( void );
+    extern UBaseType_t vTaskEnterCriticalFromISR( void );
+    extern void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus );
+    #define portENTER_CRITICAL()               vTaskEnterCritical()
+    #define portEXIT_CRITICAL()                vTaskExitCritical()
+    #define portENTER_CRITICAL_FROM_ISR()      vTaskEnterCriticalFromISR()
+    #define portEXIT_CRITICAL_FROM_ISR( x )    vTaskExitCriticalFromISR( x )
+#endif /* if ( configNUMBER_OF_CORES == 1 ) */
+/*-----------------------------------------------------------*/
+
+/* Multi-core. */
+#if ( configNUMBER_OF_CORES > 1 )
+    #define portTASK_LOCK    0
+    #define portISR_LOCK     1
+
+    extern BaseType_t xPortGetCoreID( void );
+    extern void vPortYieldCore( BaseType_t xCoreID );
+    extern void vPortRecursiveLock( BaseType_t xCoreID,
+                                    UBaseType_t uxLockNum,
+                                    BaseType_t xAcquire );
+
+    #define portGET_CORE_ID()                   xPortGetCoreID()
+    #define portYIELD_CORE( xCoreID )           vPortYieldCore( xCoreID )
+    #define portGET_TASK_LOCK( xCoreID )        vPortRecursiveLock( ( xCoreID ), portTASK_LOCK, pdTRUE )
+    #define portRELEASE_TASK_LOCK( xCoreID )    vPortRecursiveLock( ( xCoreID ), portTASK_LOCK, pdFALSE )
+    #define portGET_ISR_LOCK( xCoreID )         vPortRecursiveLock( ( xCoreID ), portISR_LOCK, pdTRUE )
+    #define portRELEASE_ISR_LOCK( xCoreID )     vPortRecursiveLock( ( xCoreID ), portISR_LOCK, pdFALSE )
+#endif /* if ( configNUMBER_OF_CORES > 1 ) */
 
 /*-----------------------------------------------------------*/
 
@@ -126,6 +166,82 @@ extern void vPortCancelThread( void * pxTaskToDelete );
 #define portCLEAN_UP_TCB( pxTCB )                                  vPortCancelThread( pxTCB )
 /*-----------------------------------------------------------*/
 
+/* Simulated interrupts. */
+#define portMAX_INTERRUPTS                         ( 32UL )
+#define portMAX_INTERRUPT_PRIORITY                 ( 255UL )
+#define portINTERRUPT_TICK                         ( 0UL )
+#define portINTERRUPT_APPLICATION_DEFINED_START    ( 1UL )
+
+/*
+ * Install the handler of a simulated interrupt.  The interrupt number must be
+ * at least portINTERRUPT_APPLICATION_DEFINED_START and below
+ * portMAX_INTERRUPTS.
+ *
+ * Interrupt handler functions must return a non-zero value if executing the
+ * handler resulted in a task switch being required, rather than calling
+ * portYIELD_FROM_ISR().
+ */
+extern void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                                      uint32_t ( * pvHandler )( void ) );
+
+/*
+ * Set the priority of a simulated interrupt, from 0 (the default, and the
+ * priority of the tick) to portMAX_INTERRUPT_PRIORITY.  Higher numbers are
+ * higher priorities.  Pending interrupts are handled highest priority first,
+ * and interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY are not masked by
+ * critical sections and can interrupt the handlers of those below it, so must
+ * not call the FreeRTOS API.  Should be set before the interrupt is raised.
+ */
+extern void vPortSetInterruptPriority( uint32_t ulInterruptNumber,
+                                       UBaseType_t uxPriority );
+
+/*
+ * Raise a simulated interrupt.  Can be called from tasks and from host
+ * threads that are not FreeRTOS tasks.  An interrupt raised again before
+ * its handler runs is handled once.
+ */
+extern void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Raise a simulated interrupt ulRateHz times a second from a host thread, or
+ * stop raising it if ulRateHz is 0.
+ */
+extern void vPortSetInterruptRate( uint32_t ulInterruptNumber,
+                                   uint32_t ulRateHz );
+
+#ifdef configASSERT
+    extern void vPortValidateInterruptPriority( void );
+    #define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()    vPortValidateInterruptPriority()
+#endif
+/*-----------------------------------------------------------*/
+
+/* Tickless idle implementation, used to skip idle time in virtual time mode. */
+#if defined( configPOSIX_VIRTUAL_TIME ) && ( configPOSIX_VIRTUAL_TIME == 1 )
+    extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+    #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Schedule record and replay. */
+#if defined( configPOSIX_SCHEDULE_LOG ) && ( configPOSIX_SCHEDULE_LOG == 1 )
+
+/*
+ * Log the ticks and interrupts taken, the points at which they were taken,
+ * and every task selected by vTaskSwitchContext() to the file pcFileName.
+ * Must be called before the scheduler is started.
+ */
+    extern void vPortRecordSchedule( const char * pcFileName );
+
+/*
+ * Take ticks and interrupts at the points logged in pcFileName by
+ * vPortRecordSchedule() rather than when they arrive, so the tasks run in
+ * the same interleaving, and abort if a different task is selected.  Must be
+ * called before the scheduler is started.
+ */
+    extern void vPortReplaySchedule( const char * pcFileName );
+#endif
+/*-----------------------------------------------------------*/
+
 #define portTASK_FUNCTION_PROTO( vFunction, pvParameters )         void vFunction( void * pvParameters ) __attribute__( ( noreturn ) )
 #define portTASK_FUNCTION( vFunction, pvParameters )               void vFunction( void * pvParameters )
 /*-----------------------------------------------------------*/
@@ -136,9 +252,13 @@ extern void vPortCancelThread( void * pxTaskToDelete );
  * which also imply a full memory barrier.
  *
  * Thus, only a compiler barrier is needed to prevent the compiler
- * reordering.
+ * reordering, unless several cores run tasks at the same time.
  */
-#define portMEMORY_BARRIER()                        __asm volatile ( "" ::: "memory" )
+#if ( configNUMBER_OF_CORES == 1 )
+    #define portMEMORY_BARRIER()    __asm volatile ( "" ::: "memory" )
+#else
+    #define portMEMORY_BARRIER()    __atomic_thread_fence( __ATOMIC_SEQ_CST )
+#endif
 
 extern uint32_t ulPortGetRunTime( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    /* no-op */
@@ -82,6 +82,23 @@ typedef struct SemaphoreData
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH    ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME          ( ( TickType_t ) 0U )
 
+/* Dynamically allocated queues that have no storage area, which includes all
+ * semaphores and mutexes, are taken from and returned to a pool of queue
+ * structures if configQUEUE_POOL_SLAB_LENGTH is greater than 0.  Queues that
+ * have a storage area are allocated in a single block that holds both the
+ * structure and the storage, so are always allocated from the heap. */
+#if ( configQUEUE_POOL_SLAB_LENGTH > 0 )
+    #define prvAllocateQueue( xQueueSizeInBytes )                                                           \
+    ( ( ( xQueueSizeInBytes ) == ( size_t ) 0U ) ? pvTaskAllocateFromObjectPool( tskQUEUE_OBJECT_POOL ) : \
+      pvPortMalloc( sizeof( Queue_t ) + ( xQueueSizeInBytes ) ) )
+    #define prvFreeQueue( pxQueue )                                                          \
+    ( ( ( pxQueue )->uxItemSize == queueSEMAPHORE_QUEUE_ITEM_LENGTH ) ?                      \
+      vTaskReturnToObjectPool( tskQUEUE_OBJECT_POOL, ( pxQueue ) ) : vPortFree( pxQueue ) )
+#else
+    #define prvAllocateQueue( xQueueSizeInBytes )    pvPortMalloc( sizeof( Queue_t ) + ( xQueueSizeInBytes ) )
+    #define prvFreeQueue( pxQueue )                  vPortFree( pxQueue )
+#endif
+
 #if ( configUSE_PREEMPTION == 0 )
 
 /* If the cooperative scheduler is being used then a yield should not be
@@ -526,7 +543,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes );
+            pxNewQueue = ( Queue_t * ) prvAllocateQueue( xQueueSizeInBytes );
 
             if( pxNewQueue != NULL )
             {
@@ -2280,7 +2297,7 @@ void vQueueDelete( QueueHandle_t xQueue )
     {
         /* The queue can only have been allocated dynamically - free it
          * again. */
-        vPortFree( pxQueue );
+        prvFreeQueue( pxQueue );
     }
     #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
     {
@@ -2288,7 +2305,7 @@ void vQueueDelete( QueueHandle_t xQueue )
          * check before attempting to free the memory. */
         if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
         {
-            vPortFree( pxQueue );
+            prvFreeQueue( pxQueue );
         }
         else
         {
@@ -124,6 +124,23 @@
 #define tskSTATICALLY_ALLOCATED_STACK_ONLY        ( ( uint8_t ) 1 )
 #define tskSTATICALLY_ALLOCATED_STACK_AND_TCB     ( ( uint8_t ) 2 )
 
+/* Dynamically allocated TCBs are taken from, and returned to, a pool of TCBs
+ * if configTASK_POOL_SLAB_LENGTH is greater than 0. */
+#if ( configTASK_POOL_SLAB_LENGTH > 0 )
+    #define prvAllocateTCB()       pvTaskAllocateFromObjectPool( tskTCB_OBJECT_POOL )
+    #define prvFreeTCB( pxTCB )    vTaskReturnToObjectPool( tskTCB_OBJECT_POOL, ( pxTCB ) )
+#else
+    #define prvAllocateTCB()       pvPortMalloc( sizeof( TCB_t ) )
+    #define prvFreeTCB( pxTCB )    vPortFree( pxTCB )
+#endif
+
+/* True if any kernel object type is allocated from a pool. */
+#define tskUSE_OBJECT_POOLS                       ( ( configTASK_POOL_SLAB_LENGTH > 0 ) || ( configQUEUE_POOL_SLAB_LENGTH > 0 ) || ( configTIMER_POOL_SLAB_LENGTH > 0 ) || ( configEVENT_GROUP_POOL_SLAB_LENGTH > 0 ) )
+#define tskNUMBER_OF_OBJECT_POOLS                 ( 4U )
+
+/* Access the pointer to the next free object held in a free pooled object. */
+#define tskOBJECT_POOL_LINK( pvObject )           ( *( ( void ** ) ( void * ) ( pvObject ) ) )
+
 /* If any of the following are set then task stacks are filled with a known
  * value so the high water mark can be determined.  If none of the following are
  * set then don't fill the stack so there is no unnecessary dependency on memset. */
@@ -314,6 +331,22 @@
     #define taskEVENT_LIST_ITEM_VALUE_IN_USE    ( ( uint64_t ) 0x8000000000000000U )
 #endif
 
+/* Event groups store their value in the event list item of a task blocked on
+ * an unordered event list.  If configUSE_64_BIT_EVENT_GROUPS is 1 the value may
+ * be wider than the list item value, so it is held in the TCB instead and the
+ * list item value only records that the event list item is in use. */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #define taskSET_EVENT_ITEM_VALUE( pxTCB, xValue )                                                \
+    do {                                                                                             \
+        ( pxTCB )->uxEventItemValue = ( xValue );                                                    \
+        listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ), taskEVENT_LIST_ITEM_VALUE_IN_USE ); \
+    } while( 0 )
+    #define taskGET_EVENT_ITEM_VALUE( pxTCB )    ( ( pxTCB )->uxEventItemValue )
+#else
+    #define taskSET_EVENT_ITEM_VALUE( pxTCB, xValue )    listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ), ( xValue ) | taskEVENT_LIST_ITEM_VALUE_IN_USE )
+    #define taskGET_EVENT_ITEM_VALUE( pxTCB )            listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ) )
+#endif
+
 /* Indicates that the task is not actively running on any core. */
 #define taskTASK_NOT_RUNNING           ( ( BaseType_t ) ( -1 ) )
 
@@ -449,6 +482,10 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        EventItemValue_t uxEventItemValue; /**< Holds the event group value while the task is using its event list item for an event group, as the value is wider than the list item value can hold. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -538,6 +575,35 @@ PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime[ conf
 
 #endif
 
+#if ( tskUSE_OBJECT_POOLS )
+
+/* Each object pool is a singly linked list of free objects, with the pointer to
+ * the next free object held in the first bytes of each free object.  The size
+ * of the objects in each pool is rounded up so the objects in a slab are
+ * aligned, and the number of objects allocated when a pool is refilled is set
+ * by the pool's config[TASK|QUEUE|TIMER|EVENT_GROUP]_POOL_SLAB_LENGTH
+ * setting.  The Static* structures have the same size as the private
+ * structures they stand in for. */
+    PRIVILEGED_DATA static void * pvObjectPoolFreeLists[ tskNUMBER_OF_OBJECT_POOLS ] = { NULL };
+
+    static const size_t xObjectPoolObjectSizes[ tskNUMBER_OF_OBJECT_POOLS ] =
+    {
+        ( sizeof( TCB_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ),
+        ( sizeof( StaticQueue_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ),
+        ( sizeof( StaticTimer_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ),
+        ( sizeof( StaticEventGroup_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK )
+    };
+
+    static const size_t xObjectPoolSlabLengths[ tskNUMBER_OF_OBJECT_POOLS ] =
+    {
+        ( size_t ) configTASK_POOL_SLAB_LENGTH,
+        ( size_t ) configQUEUE_POOL_SLAB_LENGTH,
+        ( size_t ) configTIMER_POOL_SLAB_LENGTH,
+        ( size_t ) configEVENT_GROUP_POOL_SLAB_LENGTH
+    };
+
+#endif /* #if ( tskUSE_OBJECT_POOLS ) */
+
 /*-----------------------------------------------------------*/
 
 /* File private functions. --------------------------------*/
@@ -1032,9 +1098,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
                                      &pxCurrentTCBs[ xCoreID ]->xStateListItem ) == pdTRUE )
         {
-            ( void ) uxListRemove( &pxCurrentTCBs[ xCoreID ]->xStateListItem );
-            vListInsertEnd( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
-                            &pxCurrentTCBs[ xCoreID ]->xStateListItem );
+            listMOVE_TO_END( &pxCurrentTCBs[ xCoreID ]->xStateListItem );
         }
 
         while( xTaskScheduled == pdFALSE )
@@ -1120,7 +1184,14 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
                     if( xTaskScheduled != pdFALSE )
                     {
-                        /* A task has been selected to run on this core. */
+                        /* A task has been selected to run on this core.  Tasks
+                         * that are running are kept at the end of the ready
+                         * list, behind the tasks waiting for a core, so the
+                         * search above does not have to step over them.  This
+                         * does not change the order tasks are selected in, as
+                         * a running task is moved to the end of the list
+                         * before its core selects another task anyway. */
+                        listMOVE_TO_END( pxIterator );
                         break;
                     }
                 }
@@ -1532,7 +1603,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = ( TCB_t * ) prvAllocateTCB();
 
             if( pxNewTCB != NULL )
             {
@@ -1659,7 +1730,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = ( TCB_t * ) prvAllocateTCB();
 
             if( pxNewTCB != NULL )
             {
@@ -1676,7 +1747,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 if( pxNewTCB->pxStack == NULL )
                 {
                     /* Could not allocate the stack.  Delete the allocated TCB. */
-                    vPortFree( pxNewTCB );
+                    prvFreeTCB( pxNewTCB );
                     pxNewTCB = NULL;
                 }
             }
@@ -1697,7 +1768,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 /* MISRA Ref 11.5.1 [Malloc memory assignment] */
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                 /* coverity[misra_c_2012_rule_11_5_violation] */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+                pxNewTCB = ( TCB_t * ) prvAllocateTCB();
 
                 if( pxNewTCB != NULL )
                 {
@@ -4039,15 +4110,26 @@ BaseType_t xTaskResumeAll( void )
             {
                 if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
                 {
+                    const ListItem_t * const pxEndMarker = listGET_END_MARKER( &xPendingReadyList );
+                    ListItem_t * pxIterator = listGET_HEAD_ENTRY( &xPendingReadyList );
+                    ListItem_t * pxNextItem;
+
                     /* Move any readied tasks from the pending list into the
-                     * appropriate ready list. */
-                    while( listLIST_IS_EMPTY( &xPendingReadyList ) == pdFALSE )
+                     * appropriate ready list.  The whole batch is taken in one
+                     * pass - each event list item is only marked as no longer
+                     * being in a list rather than being unlinked, and the
+                     * pending list is emptied once all the tasks have been
+                     * moved. */
+                    while( pxIterator != pxEndMarker )
                     {
+                        pxNextItem = listGET_NEXT( pxIterator );
+
                         /* MISRA Ref 11.5.3 [Void pointer assignment] */
                         /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                         /* coverity[misra_c_2012_rule_11_5_violation] */
-                        pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) );
-                        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                        pxTCB = listGET_LIST_ITEM_OWNER( pxIterator );
+                        pxIterator->pxContainer = NULL;
+                        pxIterator = pxNextItem;
                         portMEMORY_BARRIER();
                         listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
                         prvAddTaskToReadyList( pxTCB );
@@ -4076,6 +4158,8 @@ BaseType_t xTaskResumeAll( void )
 
                     if( pxTCB != NULL )
                     {
+                        vListInitialise( &xPendingReadyList );
+
                         /* A task was unblocked while the scheduler was suspended,
                          * which may have prevented the next unblock time from being
                          * re-calculated, in which case re-calculate it now.  Mainly
@@ -5323,7 +5407,7 @@ void vTaskPlaceOnEventList( List_t * const pxEventList,
 /*-----------------------------------------------------------*/
 
 void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
-                                     const TickType_t xItemValue,
+                                     const EventItemValue_t xItemValue,
                                      const TickType_t xTicksToWait )
 {
     traceENTER_vTaskPlaceOnUnorderedEventList( pxEventList, xItemValue, xTicksToWait );
@@ -5337,13 +5421,15 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
     /* Store the item value in the event list item.  It is safe to access the
      * event list item here as interrupts won't access the event list item of a
      * task that is not in the Blocked state. */
-    listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+    taskSET_EVENT_ITEM_VALUE( pxCurrentTCB, xItemValue );
 
     /* Place the event list item of the TCB at the end of the appropriate event
      * list.  It is safe to access the event list here because it is part of an
      * event group implementation - and interrupts don't access event groups
      * directly (instead they access them indirectly by pending function calls to
-     * the task level). */
+     * the task level).  If configUSE_EVENT_GROUP_DIRECT_FROM_ISR is 1 then
+     * interrupts do access event groups directly, but the event group calls this
+     * function from within a critical section. */
     listINSERT_END( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
     prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
@@ -5485,7 +5571,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
 /*-----------------------------------------------------------*/
 
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
-                                        const TickType_t xItemValue )
+                                        const EventItemValue_t xItemValue )
 {
     TCB_t * pxUnblockedTCB;
 
@@ -5495,9 +5581,6 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
      * the event flags implementation. */
     configASSERT( uxSchedulerSuspended != ( UBaseType_t ) 0U );
 
-    /* Store the new item value in the event list. */
-    listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
-
     /* Remove the event list form the event flag.  Interrupts do not access
      * event flags. */
     /* MISRA Ref 11.5.3 [Void pointer assignment] */
@@ -5505,6 +5588,10 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
     /* coverity[misra_c_2012_rule_11_5_violation] */
     pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem );
     configASSERT( pxUnblockedTCB );
+
+    /* Store the new item value in the event list. */
+    taskSET_EVENT_ITEM_VALUE( pxUnblockedTCB, xItemValue );
+
     listREMOVE_ITEM( pxEventListItem );
 
     #if ( configUSE_TICKLESS_IDLE != 0 )
@@ -5556,6 +5643,92 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EVENT_GROUP_DIRECT_FROM_ISR == 1 )
+
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const EventItemValue_t xItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+        BaseType_t xReturn;
+
+        traceENTER_xTaskRemoveFromUnorderedEventListFromISR( pxEventListItem, xItemValue );
+
+        /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
+         * called from a critical section within an ISR.  The event group that
+         * owns the event list accesses the list only from within critical
+         * sections, so exclusive access to the event list is guaranteed here. */
+
+        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem );
+        configASSERT( pxUnblockedTCB );
+
+        /* Store the new item value in the event list. */
+        taskSET_EVENT_ITEM_VALUE( pxUnblockedTCB, xItemValue );
+
+        listREMOVE_ITEM( pxEventListItem );
+
+        if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
+        {
+            listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
+            prvAddTaskToReadyList( pxUnblockedTCB );
+
+            #if ( configUSE_TICKLESS_IDLE != 0 )
+            {
+                /* See the comment in xTaskRemoveFromEventList(). */
+                prvResetNextTaskUnblockTime();
+            }
+            #endif
+        }
+        else
+        {
+            /* The delayed and ready lists cannot be accessed, so hold this task
+             * pending until the scheduler is resumed. */
+            listINSERT_END( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+        }
+
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+            {
+                /* Return true if the task removed from the event list has a higher
+                 * priority than the calling task.  Also mark that a yield is pending
+                 * in case the caller does not use the "xHigherPriorityTaskWoken"
+                 * parameter. */
+                xReturn = pdTRUE;
+                xYieldPendings[ 0 ] = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+        }
+        #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+        {
+            xReturn = pdFALSE;
+
+            #if ( configUSE_PREEMPTION == 1 )
+            {
+                prvYieldForTask( pxUnblockedTCB );
+
+                if( xYieldPendings[ portGET_CORE_ID() ] != pdFALSE )
+                {
+                    xReturn = pdTRUE;
+                }
+            }
+            #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+        }
+        #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+
+        traceRETURN_xTaskRemoveFromUnorderedEventListFromISR( xReturn );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_FROM_ISR */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     traceENTER_vTaskSetTimeOutState( pxTimeOut );
@@ -6478,7 +6651,7 @@ static void prvCheckTasksWaitingTermination( void )
             /* The task can only have been allocated dynamically - free both
              * the stack and TCB. */
             vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
+            prvFreeTCB( pxTCB );
         }
         #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
         {
@@ -6490,13 +6663,13 @@ static void prvCheckTasksWaitingTermination( void )
                 /* Both the stack and TCB were allocated dynamically, so both
                  * must be freed. */
                 vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                prvFreeTCB( pxTCB );
             }
             else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
             {
                 /* Only the stack was statically allocated, so the TCB is the
                  * only memory that must be freed. */
-                vPortFree( pxTCB );
+                prvFreeTCB( pxTCB );
             }
             else
             {
@@ -7643,13 +7816,13 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) ) */
 /*-----------------------------------------------------------*/
 
-TickType_t uxTaskResetEventItemValue( void )
+EventItemValue_t uxTaskResetEventItemValue( void )
 {
-    TickType_t uxReturn;
+    EventItemValue_t uxReturn;
 
     traceENTER_uxTaskResetEventItemValue();
 
-    uxReturn = listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ) );
+    uxReturn = taskGET_EVENT_ITEM_VALUE( pxCurrentTCB );
 
     /* Reset the event list item to its normal value - so it can be used with
      * queues and semaphores. */
@@ -7661,6 +7834,34 @@ TickType_t uxTaskResetEventItemValue( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    EventItemValue_t uxTaskGetEventListItemValue( const ListItem_t * pxEventListItem )
+    {
+        const TCB_t * pxTCB;
+        EventItemValue_t uxReturn;
+
+        traceENTER_uxTaskGetEventListItemValue( pxEventListItem );
+
+        /* The value stored with a task blocked on an event group is too wide
+         * for the event list item, so it is held in the TCB of the task that
+         * owns the event list item. */
+        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem );
+        configASSERT( pxTCB );
+
+        uxReturn = taskGET_EVENT_ITEM_VALUE( pxTCB );
+
+        traceRETURN_uxTaskGetEventListItemValue( uxReturn );
+
+        return uxReturn;
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     TaskHandle_t pvTaskIncrementMutexHeldCount( void )
@@ -8799,9 +9000,146 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
     }
 
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+        void vApplicationGetPerCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                                    StackType_t ** ppxTimerTaskStackBuffer,
+                                                    configSTACK_DEPTH_TYPE * puxTimerTaskStackSize,
+                                                    BaseType_t xTimerTaskIndex )
+        {
+            static StaticTask_t xTimerTaskTCBs[ configNUMBER_OF_CORES - 1 ];
+            static StackType_t uxTimerTaskStacks[ configNUMBER_OF_CORES - 1 ][ configTIMER_TASK_STACK_DEPTH ];
+
+            *ppxTimerTaskTCBBuffer = &( xTimerTaskTCBs[ xTimerTaskIndex ] );
+            *ppxTimerTaskStackBuffer = &( uxTimerTaskStacks[ xTimerTaskIndex ][ 0 ] );
+            *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+        }
+
+    #endif /* #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 ) */
+
 #endif /* #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configKERNEL_PROVIDED_STATIC_MEMORY == 1 ) && ( portUSING_MPU_WRAPPERS == 0 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( tskUSE_OBJECT_POOLS )
+
+    void * pvTaskAllocateFromObjectPool( UBaseType_t uxPool )
+    {
+        void * pvObject;
+        uint8_t * pucSlab;
+        size_t xObjectSize, xSlabLength, x;
+
+        traceENTER_pvTaskAllocateFromObjectPool( uxPool );
+
+        configASSERT( uxPool < tskNUMBER_OF_OBJECT_POOLS );
+
+        taskENTER_CRITICAL();
+        {
+            pvObject = pvObjectPoolFreeLists[ uxPool ];
+
+            if( pvObject != NULL )
+            {
+                /* MISRA Ref 11.5.6 [Object pool link] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pvObjectPoolFreeLists[ uxPool ] = tskOBJECT_POOL_LINK( pvObject );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( pvObject == NULL )
+        {
+            /* The pool is empty, so refill it with a slab of objects from the
+             * heap.  The heap is not accessed from within the critical
+             * section. */
+            xObjectSize = xObjectPoolObjectSizes[ uxPool ];
+            xSlabLength = xObjectPoolSlabLengths[ uxPool ];
+            configASSERT( xSlabLength > ( size_t ) 0U );
+
+            /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pucSlab = ( uint8_t * ) pvPortMalloc( xObjectSize * xSlabLength );
+
+            if( pucSlab != NULL )
+            {
+                /* The first object in the slab is returned.  Link the
+                 * remaining objects together before adding them all to the
+                 * pool in one step. */
+                pvObject = ( void * ) pucSlab;
+
+                if( xSlabLength > ( size_t ) 1U )
+                {
+                    for( x = ( size_t ) 1U; x < ( xSlabLength - ( size_t ) 1U ); x++ )
+                    {
+                        /* MISRA Ref 11.5.6 [Object pool link] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        tskOBJECT_POOL_LINK( &( pucSlab[ x * xObjectSize ] ) ) = &( pucSlab[ ( x + ( size_t ) 1U ) * xObjectSize ] );
+                    }
+
+                    taskENTER_CRITICAL();
+                    {
+                        /* MISRA Ref 11.5.6 [Object pool link] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        tskOBJECT_POOL_LINK( &( pucSlab[ ( xSlabLength - ( size_t ) 1U ) * xObjectSize ] ) ) = pvObjectPoolFreeLists[ uxPool ];
+                        pvObjectPoolFreeLists[ uxPool ] = &( pucSlab[ xObjectSize ] );
+                    }
+                    taskEXIT_CRITICAL();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_pvTaskAllocateFromObjectPool( pvObject );
+
+        return pvObject;
+    }
+
+#endif /* #if ( tskUSE_OBJECT_POOLS ) */
+/*-----------------------------------------------------------*/
+
+#if ( tskUSE_OBJECT_POOLS )
+
+    void vTaskReturnToObjectPool( UBaseType_t uxPool,
+                                  void * pvObject )
+    {
+        traceENTER_vTaskReturnToObjectPool( uxPool, pvObject );
+
+        configASSERT( uxPool < tskNUMBER_OF_OBJECT_POOLS );
+        configASSERT( pvObject != NULL );
+
+        taskENTER_CRITICAL();
+        {
+            /* MISRA Ref 11.5.6 [Object pool link] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            tskOBJECT_POOL_LINK( pvObject ) = pvObjectPoolFreeLists[ uxPool ];
+            pvObjectPoolFreeLists[ uxPool ] = pvObject;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskReturnToObjectPool();
+    }
+
+#endif /* #if ( tskUSE_OBJECT_POOLS ) */
+/*-----------------------------------------------------------*/
+
 /*
  * Reset the state in this file. This state is normally initialized at start up.
  * This function must be called by the application before restarting the
@@ -8830,6 +9168,18 @@ void vTaskResetState( void )
     }
     #endif /* #if ( configUSE_POSIX_ERRNO == 1 ) */
 
+    #if ( tskUSE_OBJECT_POOLS )
+    {
+        UBaseType_t uxPool;
+
+        /* The slabs are part of the heap, which is also reset. */
+        for( uxPool = 0U; uxPool < tskNUMBER_OF_OBJECT_POOLS; uxPool++ )
+        {
+            pvObjectPoolFreeLists[ uxPool ] = NULL;
+        }
+    }
+    #endif /* #if ( tskUSE_OBJECT_POOLS ) */
+
     /* Other file private variables. */
     uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
     xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
@@ -79,17 +79,47 @@
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( 0x02U )
     #define tmrSTATUS_IS_AUTORELOAD              ( 0x04U )
 
+/* Dynamically allocated timers are taken from, and returned to, a pool of
+ * timers if configTIMER_POOL_SLAB_LENGTH is greater than 0. */
+    #if ( configTIMER_POOL_SLAB_LENGTH > 0 )
+        #define prvAllocateTimer()         pvTaskAllocateFromObjectPool( tskTIMER_OBJECT_POOL )
+        #define prvFreeTimer( pxTimer )    vTaskReturnToObjectPool( tskTIMER_OBJECT_POOL, ( pxTimer ) )
+    #else
+        #define prvAllocateTimer()         pvPortMalloc( sizeof( Timer_t ) )
+        #define prvFreeTimer( pxTimer )    vPortFree( pxTimer )
+    #endif
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/* Definitions used by the timer wheel.  Each level of the wheel has
+ * tmrWHEEL_SLOTS slots, and each slot of level n spans tmrWHEEL_SLOTS^n ticks.
+ * tmrWHEEL_SLOT() returns the slot of level uxLevel that holds a timer that
+ * expires at xTime. */
+        #define tmrWHEEL_SLOTS                   ( ( UBaseType_t ) 1U << configTIMER_WHEEL_SLOT_BITS )
+        #define tmrWHEEL_SLOT_MASK               ( ( TickType_t ) tmrWHEEL_SLOTS - ( TickType_t ) 1U )
+        #define tmrWHEEL_RANGE_BITS              ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS )
+        #define tmrWHEEL_SLOT( xTime, uxLevel )    ( ( UBaseType_t ) ( ( ( xTime ) >> ( ( uxLevel ) * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK ) )
+    #endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                                               /* The old naming convention is used to prevent breaking kernel aware debuggers. */
     {
         const char * pcTimerName;                                                /**< Text name.  This is not used by the kernel, it is included simply to make debugging easier. */
         ListItem_t xTimerListItem;                                               /**< Standard linked list item as used by all kernel features for event management. */
         TickType_t xTimerPeriodInTicks;                                          /**< How quickly and often the timer expires. */
+        #if ( configUSE_TIMER_SLACK == 1 )
+            TickType_t xTimerSlackInTicks;                                       /**< How long the processing of the timer may be delayed after it expires, so it can be processed together with other timers. */
+        #endif
         void * pvTimerID;                                                        /**< An ID to identify the timer.  This allows the timer to be identified when the same callback is used for multiple timers. */
         portTIMER_CALLBACK_ATTRIBUTE TimerCallbackFunction_t pxCallbackFunction; /**< The function that will be called when the timer expires. */
         #if ( configUSE_TRACE_FACILITY == 1 )
             UBaseType_t uxTimerNumber;                                           /**< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
+        #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            BaseType_t xTimerCoreID;                                             /**< The core whose timer service task processes the timer, or tmrFOLLOW_CALLING_CORE. */
+            BaseType_t xTimerServiceID;                                          /**< The timer service that currently owns the timer. */
+            UBaseType_t uxTimerUseCount;                                         /**< The number of commands sent for the timer that are not yet processed, plus one while its expiry is processed.  The timer can only move to another timer service while this is zero. */
+        #endif
         uint8_t ucStatus;                                                        /**< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
     } xTIMER;
 
@@ -134,20 +164,112 @@
         } u;
     } DaemonTaskMessage_t;
 
-/* The list in which active timers are stored.  Timers are referenced in expire
- * time order, with the nearest expiry time at the front of the list.  Only the
- * timer service task is allowed to access these lists.
- * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
- * breaks some kernel aware debuggers, and debuggers that reply on removing the
- * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
-
-/* A queue that is used to send commands to the timer service task. */
-    PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
-    PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
+/* The number of timer services.  When configUSE_TIMER_SERVICE_TASK_PER_CORE is
+ * 1 each core runs its own timer service task, otherwise a single timer service
+ * task processes the timers of all the cores. */
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+        #define tmrNUMBER_OF_TIMER_SERVICES    configNUMBER_OF_CORES
+    #else
+        #define tmrNUMBER_OF_TIMER_SERVICES    1
+    #endif
+
+/* The state of a timer service, which is passed explicitly to each function
+ * that accesses it.  The timer service task of a core only runs on that core and
+ * receives its timer service as its task parameter, whereas the functions that
+ * operate on a timer use the timer service that owns the timer.
+ *
+ * xActiveList1 and xActiveList2 hold the active timers.  Timers are referenced
+ * in expire time order, with the nearest expiry time at the front of the list.
+ * Only the timer service task is allowed to access these lists.
+ *
+ * When configUSE_TIMER_WHEEL is 1, active timers that expire in the same
+ * tmrWHEEL_SLOTS^configTIMER_WHEEL_LEVELS tick block as xWheelTime are
+ * referenced from the timer wheel instead of the lists above.  A timer is held in
+ * the lowest level whose slot distinguishes its expiry time from xWheelTime, so
+ * starting, stopping and resetting such a timer does not require walking a list.
+ * Level n is held in xWheel[ n * tmrWHEEL_SLOTS ] onwards.  Timers that expire in
+ * a later block remain in pxCurrentList, and are moved into the wheel when
+ * xWheelTime reaches their block.
+ *
+ * xQueue is used to send commands to the timer service task, and
+ * xLastSampledTime is the tick count when prvSampleTimeNow() was last called.
+ *
+ * When configUSE_TIMER_DIRECT_COMMANDS is 1, tasks start, stop and reset timers
+ * by updating the active timers directly with the scheduler suspended.  The
+ * timer service task records the time until which it is blocked in xWakeTime so
+ * tasks only need to wake it when a timer expires before that time.
+ *
+ * The timer queue is allocated statically when configSUPPORT_STATIC_ALLOCATION
+ * is 1 in case configSUPPORT_DYNAMIC_ALLOCATION is 0. */
+    typedef struct tmrTimerService
+    {
+        List_t xActiveList1;
+        List_t xActiveList2;
+        List_t * pxCurrentList;
+        List_t * pxOverflowList;
+        #if ( configUSE_TIMER_WHEEL == 1 )
+            List_t xWheel[ configTIMER_WHEEL_LEVELS * tmrWHEEL_SLOTS ];
+            UBaseType_t uxWheelLevelCount[ configTIMER_WHEEL_LEVELS ];
+            TickType_t xWheelTime;
+        #endif
+        QueueHandle_t xQueue;
+        TaskHandle_t xTaskHandle;
+        TickType_t xLastSampledTime;
+        #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            TickType_t xWakeTime;
+            BaseType_t xBlockedIndefinitely;
+        #endif
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            StaticQueue_t xStaticQueue;
+            uint8_t ucStaticQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ];
+        #endif
+    } TimerService_t;
+
+/* xTimerServices could be at function scope but that breaks some kernel aware
+ * debuggers, and debuggers that rely on removing the static qualifier. */
+    PRIVILEGED_DATA static TimerService_t xTimerServices[ tmrNUMBER_OF_TIMER_SERVICES ];
+
+    #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+
+/* When configTIMER_DEFERRED_CALL_RING_LENGTH is greater than 0, functions
+ * pended from interrupts are written to a ring that belongs to the core on which
+ * the interrupt executes instead of being sent on the timer queue.  Only
+ * interrupts on that core (with interrupts masked) write uxHead, and only the
+ * timer service task writes uxTail.  The ring has one more slot than the number
+ * of calls it can hold so a full ring can be distinguished from an empty ring.
+ * uxOverflowCount counts the calls that failed because the ring was full. */
+        typedef struct tmrDeferredCallRing
+        {
+            volatile UBaseType_t uxHead;
+            volatile UBaseType_t uxTail;
+            UBaseType_t uxOverflowCount;
+            CallbackParameters_t xCalls[ configTIMER_DEFERRED_CALL_RING_LENGTH + 1 ];
+        } DeferredCallRing_t;
+
+        PRIVILEGED_DATA static DeferredCallRing_t xDeferredCallRings[ configNUMBER_OF_CORES ];
+
+/* An interrupt publishes a call and then checks whether the ring was empty,
+ * while the timer service task frees a slot and then checks whether the ring is
+ * empty.  If neither saw the other's write the interrupt would not wake the timer
+ * service task, and the timer service task would block with a call in the ring.
+ * When the ring is drained by a timer service task on the same core as the
+ * interrupts that write to it, masking interrupts and portMEMORY_BARRIER() are
+ * enough to prevent that.  When a single timer service task drains the rings of
+ * all the cores, portMEMORY_BARRIER() does not order the accesses made by
+ * different cores, so both sides are performed while holding the ISR lock, which
+ * also ensures the timer service task reads a call only after it is written. */
+        #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 0 ) )
+            #define tmrENTER_RING_CRITICAL_FROM_ISR()                         taskENTER_CRITICAL_FROM_ISR()
+            #define tmrEXIT_RING_CRITICAL_FROM_ISR( uxSavedInterruptStatus )    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus )
+            #define tmrENTER_RING_CRITICAL()                                  taskENTER_CRITICAL()
+            #define tmrEXIT_RING_CRITICAL()                                   taskEXIT_CRITICAL()
+        #else
+            #define tmrENTER_RING_CRITICAL_FROM_ISR()                         portSET_INTERRUPT_MASK_FROM_ISR()
+            #define tmrEXIT_RING_CRITICAL_FROM_ISR( uxSavedInterruptStatus )    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus )
+            #define tmrENTER_RING_CRITICAL()                                  portMEMORY_BARRIER()
+            #define tmrEXIT_RING_CRITICAL()                                   portMEMORY_BARRIER()
+        #endif
+    #endif
 
 /*-----------------------------------------------------------*/
 
@@ -159,8 +281,8 @@
 
 /*
  * The timer service task (daemon).  Timer functionality is controlled by this
- * task.  Other tasks communicate with the timer service task using the
- * xTimerQueue queue.
+ * task.  Other tasks communicate with the timer service task using the queue
+ * of the timer service passed as pvParameters.
  */
     static portTASK_FUNCTION_PROTO( prvTimerTask, pvParameters ) PRIVILEGED_FUNCTION;
 
@@ -168,13 +290,14 @@
  * Called by the timer service task to interpret and process a command it
  * received on the timer queue.
  */
-    static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
+    static void prvProcessReceivedCommands( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
 
 /*
- * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * Insert the timer into either the current or the overflow timer list of
+ * pxService, depending on if the expire time causes a timer counter overflow.
  */
-    static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+    static BaseType_t prvInsertTimerInActiveList( TimerService_t * const pxService,
+                                                  Timer_t * const pxTimer,
                                                   const TickType_t xNextExpiryTime,
                                                   const TickType_t xTimeNow,
                                                   const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
@@ -184,7 +307,8 @@
  * clear the backlog, calling the callback for each additional reload.  When
  * this function returns, the next expiry time is after xTimeNow.
  */
-    static void prvReloadTimer( Timer_t * const pxTimer,
+    static void prvReloadTimer( TimerService_t * const pxService,
+                                Timer_t * const pxTimer,
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
@@ -192,20 +316,100 @@
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+/*
+ * Execute the callback of an expired timer.  When
+ * configUSE_TIMER_DIRECT_COMMANDS is 1 this is called with the scheduler
+ * suspended, and the scheduler is resumed while the callback executes.
+ */
+    static void prvExecuteTimerCallback( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+    #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+
+/*
+ * Execute the functions that have been written to the deferred call ring, in
+ * the order in which they were written, until the ring is empty.
+ */
+        static void prvExecuteDeferredCalls( DeferredCallRing_t * const pxRing ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+/*
+ * Apply a start, reset, stop or change period command issued by a task directly
+ * to the active timers, waking the timer service task only if the timer expires
+ * before the timer service task would otherwise unblock.  Returns pdFAIL if the
+ * command must be sent to the timer service task instead.
+ */
+        static BaseType_t prvProcessCommandDirect( TimerService_t * const pxService,
+                                                   Timer_t * const pxTimer,
+                                                   const BaseType_t xCommandID,
+                                                   const TickType_t xOptionalValue ) PRIVILEGED_FUNCTION;
+    #endif
+
+/*
+ * Remove the timer from whichever active timer list or timer wheel slot it is
+ * referenced from.
+ */
+    static void prvRemoveTimerFromActiveList( TimerService_t * const pxService,
+                                              Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+/*
+ * Called from a critical section before a command is sent for the timer.  If
+ * the timer is dormant it is first moved to the timer service of the core to
+ * which it is bound, or of xCallingCoreID if it follows the calling core.  The
+ * timer is then held in the timer service that owns it until the command has
+ * been processed, and that timer service is returned.
+ */
+        static TimerService_t * prvClaimTimerService( Timer_t * const pxTimer,
+                                                const BaseType_t xCallingCoreID ) PRIVILEGED_FUNCTION;
+
+/*
+ * Reverse the effect of prvClaimTimerService() once the command has been
+ * processed, or could not be sent.
+ */
+        static void prvReleaseTimerService( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * Reference the timer from the timer wheel slot that corresponds to
+ * xNextExpiryTime.  Returns pdFALSE without inserting the timer if
+ * xNextExpiryTime is beyond the range of the wheel.
+ */
+        static BaseType_t prvInsertTimerInWheel( TimerService_t * const pxService,
+                                                 Timer_t * const pxTimer,
+                                                 const TickType_t xNextExpiryTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the timer wheel forward to xNewTime, which must not be later than the
+ * time returned by prvGetNextExpireTime().  Timers held in the slots of the
+ * higher levels that xNewTime enters are cascaded down to the lower levels, and
+ * timers in the current timer list that now fall within the range of the wheel
+ * are moved into the wheel.
+ */
+        static void prvAdvanceTimerWheel( TimerService_t * const pxService,
+                                          const TickType_t xNewTime ) PRIVILEGED_FUNCTION;
+    #endif /* configUSE_TIMER_WHEEL */
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+    static void prvSwitchTimerLists( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
  * if a tick count overflow occurred since prvSampleTimeNow() was last called.
  */
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
 
 /*
  * If the timer list contains any active timers then return the expire time of
@@ -213,15 +417,36 @@
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
  * to pdTRUE.
  */
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
+    static TickType_t prvGetNextExpireTime( const TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
 /*
  * If a timer has expired, process it.  Otherwise, block the timer service task
  * until either a timer does expire or a command is received.
  */
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+/*
+ * Return the latest time at which the timer service task can process the timer
+ * that expires at xNextExpireTime, along with all the other timers that expire
+ * before that time, without exceeding the slack of any of them.
+ */
+        static TickType_t prvGetCoalescedExpireTime( const TimerService_t * const pxService,
+                                                     const TickType_t xNextExpireTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Reduce xCoalescedTime to the time at which the slack of each timer in pxList
+ * that expires before xCoalescedTime elapses, and return the result.  pxList
+ * must be sorted in expiry time order.
+ */
+        static TickType_t prvCoalesceTimersInList( const List_t * const pxList,
+                                                   TickType_t xCoalescedTime ) PRIVILEGED_FUNCTION;
+    #endif
+
 /*
  * Called after a Timer_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -237,6 +462,11 @@
     BaseType_t xTimerCreateTimerTask( void )
     {
         BaseType_t xReturn = pdFAIL;
+        TimerService_t * pxService = &( xTimerServices[ 0 ] );
+
+        #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            BaseType_t xServiceID = 0;
+        #endif
 
         traceENTER_xTimerCreateTimerTask();
 
@@ -246,9 +476,69 @@
          * been created then the initialisation will already have been performed. */
         prvCheckForValidListAndQueue();
 
-        if( xTimerQueue != NULL )
+        if( pxService->xQueue != NULL )
         {
-            #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                /* Create a timer service task for each core, each of which can
+                 * only run on its own core. */
+                xReturn = pdPASS;
+
+                for( xServiceID = 0; ( xServiceID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( xReturn == pdPASS ); xServiceID++ )
+                {
+                    xReturn = pdFAIL;
+                    pxService = &( xTimerServices[ xServiceID ] );
+
+                    if( pxService->xQueue != NULL )
+                    {
+                        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                        {
+                            StaticTask_t * pxTimerTaskTCBBuffer = NULL;
+                            StackType_t * pxTimerTaskStackBuffer = NULL;
+                            configSTACK_DEPTH_TYPE uxTimerTaskStackSize;
+
+                            if( xServiceID == 0 )
+                            {
+                                vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
+                            }
+                            else
+                            {
+                                vApplicationGetPerCoreTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize, xServiceID - 1 );
+                            }
+
+                            pxService->xTaskHandle = xTaskCreateStaticAffinitySet( &prvTimerTask,
+                                                                                   configTIMER_SERVICE_TASK_NAME,
+                                                                                   uxTimerTaskStackSize,
+                                                                                   pxService,
+                                                                                   ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                                                   pxTimerTaskStackBuffer,
+                                                                                   pxTimerTaskTCBBuffer,
+                                                                                   ( UBaseType_t ) 1U << ( UBaseType_t ) xServiceID );
+
+                            if( pxService->xTaskHandle != NULL )
+                            {
+                                xReturn = pdPASS;
+                            }
+                        }
+                        #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                        {
+                            xReturn = xTaskCreateAffinitySet( &prvTimerTask,
+                                                              configTIMER_SERVICE_TASK_NAME,
+                                                              configTIMER_TASK_STACK_DEPTH,
+                                                              pxService,
+                                                              ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                              ( UBaseType_t ) 1U << ( UBaseType_t ) xServiceID,
+                                                              &( pxService->xTaskHandle ) );
+                        }
+                        #endif /* configSUPPORT_STATIC_ALLOCATION */
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            #elif ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
             {
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -257,16 +547,16 @@
                     configSTACK_DEPTH_TYPE uxTimerTaskStackSize;
 
                     vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
-                    xTimerTaskHandle = xTaskCreateStaticAffinitySet( &prvTimerTask,
-                                                                     configTIMER_SERVICE_TASK_NAME,
-                                                                     uxTimerTaskStackSize,
-                                                                     NULL,
-                                                                     ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                                     pxTimerTaskStackBuffer,
-                                                                     pxTimerTaskTCBBuffer,
-                                                                     configTIMER_SERVICE_TASK_CORE_AFFINITY );
-
-                    if( xTimerTaskHandle != NULL )
+                    pxService->xTaskHandle = xTaskCreateStaticAffinitySet( &prvTimerTask,
+                                                                           configTIMER_SERVICE_TASK_NAME,
+                                                                           uxTimerTaskStackSize,
+                                                                           pxService,
+                                                                           ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                                           pxTimerTaskStackBuffer,
+                                                                           pxTimerTaskTCBBuffer,
+                                                                           configTIMER_SERVICE_TASK_CORE_AFFINITY );
+
+                    if( pxService->xTaskHandle != NULL )
                     {
                         xReturn = pdPASS;
                     }
@@ -276,14 +566,14 @@
                     xReturn = xTaskCreateAffinitySet( &prvTimerTask,
                                                       configTIMER_SERVICE_TASK_NAME,
                                                       configTIMER_TASK_STACK_DEPTH,
-                                                      NULL,
+                                                      pxService,
                                                       ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
                                                       configTIMER_SERVICE_TASK_CORE_AFFINITY,
-                                                      &xTimerTaskHandle );
+                                                      &( pxService->xTaskHandle ) );
                 }
                 #endif /* configSUPPORT_STATIC_ALLOCATION */
             }
-            #else /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
+            #else /* #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 ) */
             {
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -292,15 +582,15 @@
                     configSTACK_DEPTH_TYPE uxTimerTaskStackSize;
 
                     vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
-                    xTimerTaskHandle = xTaskCreateStatic( &prvTimerTask,
-                                                          configTIMER_SERVICE_TASK_NAME,
-                                                          uxTimerTaskStackSize,
-                                                          NULL,
-                                                          ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                          pxTimerTaskStackBuffer,
-                                                          pxTimerTaskTCBBuffer );
-
-                    if( xTimerTaskHandle != NULL )
+                    pxService->xTaskHandle = xTaskCreateStatic( &prvTimerTask,
+                                                                configTIMER_SERVICE_TASK_NAME,
+                                                                uxTimerTaskStackSize,
+                                                                pxService,
+                                                                ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                                pxTimerTaskStackBuffer,
+                                                                pxTimerTaskTCBBuffer );
+
+                    if( pxService->xTaskHandle != NULL )
                     {
                         xReturn = pdPASS;
                     }
@@ -310,13 +600,13 @@
                     xReturn = xTaskCreate( &prvTimerTask,
                                            configTIMER_SERVICE_TASK_NAME,
                                            configTIMER_TASK_STACK_DEPTH,
-                                           NULL,
+                                           pxService,
                                            ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                           &xTimerTaskHandle );
+                                           &( pxService->xTaskHandle ) );
                 }
                 #endif /* configSUPPORT_STATIC_ALLOCATION */
             }
-            #endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
+            #endif /* #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 ) */
         }
         else
         {
@@ -346,7 +636,7 @@
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) );
+            pxNewTimer = ( Timer_t * ) prvAllocateTimer();
 
             if( pxNewTimer != NULL )
             {
@@ -432,8 +722,20 @@
          * parameters. */
         pxNewTimer->pcTimerName = pcTimerName;
         pxNewTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
+        #if ( configUSE_TIMER_SLACK == 1 )
+        {
+            pxNewTimer->xTimerSlackInTicks = ( TickType_t ) configTIMER_DEFAULT_SLACK;
+        }
+        #endif
         pxNewTimer->pvTimerID = pvTimerID;
         pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+        #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+        {
+            pxNewTimer->xTimerCoreID = tmrFOLLOW_CALLING_CORE;
+            pxNewTimer->xTimerServiceID = 0;
+            pxNewTimer->uxTimerUseCount = 0U;
+        }
+        #endif
         vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
 
         if( xAutoReload != pdFALSE )
@@ -454,13 +756,17 @@
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
 
+        /* The timer queues of all the timer services are created together, so
+         * checking the first is enough to know they exist. */
+        TimerService_t * pxService = &( xTimerServices[ 0 ] );
+
         ( void ) pxHigherPriorityTaskWoken;
 
         traceENTER_xTimerGenericCommandFromTask( xTimer, xCommandID, xOptionalValue, pxHigherPriorityTaskWoken, xTicksToWait );
 
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
-        if( ( xTimerQueue != NULL ) && ( xTimer != NULL ) )
+        if( ( pxService->xQueue != NULL ) && ( xTimer != NULL ) )
         {
             /* Send a command to the timer service task to start the xTimer timer. */
             xMessage.xMessageID = xCommandID;
@@ -471,13 +777,67 @@
 
             if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
             {
-                if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+                #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                {
+                    taskENTER_CRITICAL();
+                    {
+                        pxService = prvClaimTimerService( xTimer, ( BaseType_t ) portGET_CORE_ID() );
+                    }
+                    taskEXIT_CRITICAL();
+                }
+                #endif
+
+                #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                {
+                    /* Deleting a timer is left to the timer service task as the
+                     * timer might be in use by the timer service task. */
+                    if( xCommandID < tmrCOMMAND_DELETE )
+                    {
+                        xReturn = prvProcessCommandDirect( pxService, xTimer, xCommandID, xOptionalValue );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_TIMER_DIRECT_COMMANDS */
+
+                if( xReturn != pdPASS )
                 {
-                    xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
+                    if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+                    {
+                        xReturn = xQueueSendToBack( pxService->xQueue, &xMessage, xTicksToWait );
+                    }
+                    else
+                    {
+                        xReturn = xQueueSendToBack( pxService->xQueue, &xMessage, tmrNO_DELAY );
+                    }
+
+                    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                    {
+                        if( xReturn != pdPASS )
+                        {
+                            prvReleaseTimerService( xTimer );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif
                 }
                 else
                 {
-                    xReturn = xQueueSendToBack( xTimerQueue, &xMessage, tmrNO_DELAY );
+                    /* The command was applied directly. */
+                    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                    {
+                        prvReleaseTimerService( xTimer );
+                    }
+                    #else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                    #endif
                 }
             }
 
@@ -502,6 +862,11 @@
     {
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
+        TimerService_t * pxService = &( xTimerServices[ 0 ] );
+
+        #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            UBaseType_t uxSavedInterruptStatus;
+        #endif
 
         ( void ) xTicksToWait;
 
@@ -509,7 +874,7 @@
 
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
-        if( ( xTimerQueue != NULL ) && ( xTimer != NULL ) )
+        if( ( pxService->xQueue != NULL ) && ( xTimer != NULL ) )
         {
             /* Send a command to the timer service task to start the xTimer timer. */
             xMessage.xMessageID = xCommandID;
@@ -520,7 +885,34 @@
 
             if( xCommandID >= tmrFIRST_FROM_ISR_COMMAND )
             {
-                xReturn = xQueueSendToBackFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                {
+                    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+                    {
+                        pxService = prvClaimTimerService( xTimer, ( BaseType_t ) portGET_CORE_ID() );
+                    }
+                    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+                }
+                #endif
+
+                xReturn = xQueueSendToBackFromISR( pxService->xQueue, &xMessage, pxHigherPriorityTaskWoken );
+
+                #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                {
+                    if( xReturn != pdPASS )
+                    {
+                        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+                        {
+                            xTimer->uxTimerUseCount--;
+                        }
+                        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif
             }
 
             traceTIMER_COMMAND_SEND( xTimer, xCommandID, xOptionalValue, xReturn );
@@ -538,15 +930,20 @@
 
     TaskHandle_t xTimerGetTimerDaemonTaskHandle( void )
     {
+        /* When configUSE_TIMER_SERVICE_TASK_PER_CORE is 1 this is the timer
+         * service task of core 0, which is also the task that executes the
+         * daemon task startup hook. */
+        const TimerService_t * const pxService = &( xTimerServices[ 0 ] );
+
         traceENTER_xTimerGetTimerDaemonTaskHandle();
 
         /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
-         * started, then xTimerTaskHandle will be NULL. */
-        configASSERT( ( xTimerTaskHandle != NULL ) );
+         * started, then the task handle will be NULL. */
+        configASSERT( ( pxService->xTaskHandle != NULL ) );
 
-        traceRETURN_xTimerGetTimerDaemonTaskHandle( xTimerTaskHandle );
+        traceRETURN_xTimerGetTimerDaemonTaskHandle( pxService->xTaskHandle );
 
-        return xTimerTaskHandle;
+        return pxService->xTaskHandle;
     }
 /*-----------------------------------------------------------*/
 
@@ -564,6 +961,91 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        void vTimerSetSlack( TimerHandle_t xTimer,
+                             const TickType_t xSlackInTicks )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            traceENTER_vTimerSetSlack( xTimer, xSlackInTicks );
+
+            configASSERT( xTimer );
+
+            taskENTER_CRITICAL();
+            {
+                pxTimer->xTimerSlackInTicks = xSlackInTicks;
+            }
+            taskEXIT_CRITICAL();
+
+            traceRETURN_vTimerSetSlack();
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        TickType_t xTimerGetSlack( TimerHandle_t xTimer )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            traceENTER_xTimerGetSlack( xTimer );
+
+            configASSERT( xTimer );
+
+            traceRETURN_xTimerGetSlack( pxTimer->xTimerSlackInTicks );
+
+            return pxTimer->xTimerSlackInTicks;
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+        void vTimerSetCoreID( TimerHandle_t xTimer,
+                              const BaseType_t xCoreID )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            traceENTER_vTimerSetCoreID( xTimer, xCoreID );
+
+            configASSERT( xTimer );
+            configASSERT( ( xCoreID == tmrFOLLOW_CALLING_CORE ) || ( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) ) );
+
+            /* The timer only moves to the timer service of the new core the next
+             * time it is sent a command while it is dormant. */
+            taskENTER_CRITICAL();
+            {
+                pxTimer->xTimerCoreID = xCoreID;
+            }
+            taskEXIT_CRITICAL();
+
+            traceRETURN_vTimerSetCoreID();
+        }
+
+    #endif /* configUSE_TIMER_SERVICE_TASK_PER_CORE */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+        BaseType_t xTimerGetCoreID( TimerHandle_t xTimer )
+        {
+            const Timer_t * pxTimer = xTimer;
+
+            traceENTER_xTimerGetCoreID( xTimer );
+
+            configASSERT( xTimer );
+
+            traceRETURN_xTimerGetCoreID( pxTimer->xTimerCoreID );
+
+            return pxTimer->xTimerCoreID;
+        }
+
+    #endif /* configUSE_TIMER_SERVICE_TASK_PER_CORE */
+/*-----------------------------------------------------------*/
+
     void vTimerSetReloadMode( TimerHandle_t xTimer,
                               const BaseType_t xAutoReload )
     {
@@ -692,52 +1174,141 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvReloadTimer( Timer_t * const pxTimer,
+    static void prvReloadTimer( TimerService_t * const pxService,
+                                Timer_t * const pxTimer,
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow )
     {
         /* Insert the timer into the appropriate list for the next expiry time.
          * If the next expiry time has already passed, advance the expiry time,
          * call the callback function, and try again. */
-        while( prvInsertTimerInActiveList( pxTimer, ( xExpiredTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xExpiredTime ) != pdFALSE )
+        while( prvInsertTimerInActiveList( pxService, pxTimer, ( xExpiredTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xExpiredTime ) != pdFALSE )
         {
             /* Advance the expiry time. */
             xExpiredTime += pxTimer->xTimerPeriodInTicks;
 
             /* Call the timer callback. */
-            traceTIMER_EXPIRED( pxTimer );
+            prvExecuteTimerCallback( pxTimer );
+
+            #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            {
+                /* A task may have restarted or stopped the timer while the
+                 * scheduler was resumed to execute the callback, in which case
+                 * the backlog no longer applies. */
+                if( ( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) ||
+                    ( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0U ) )
+                {
+                    break;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_TIMER_DIRECT_COMMANDS */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvExecuteTimerCallback( Timer_t * const pxTimer )
+    {
+        traceTIMER_EXPIRED( pxTimer );
+
+        #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+        {
+            /* The active timers are only accessed with the scheduler suspended,
+             * but the callback must execute with the scheduler running. */
+            ( void ) xTaskResumeAll();
+            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            vTaskSuspendAll();
+        }
+        #else
+        {
             pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
         }
+        #endif
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
-        /* MISRA Ref 11.5.3 [Void pointer assignment] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-        /* coverity[misra_c_2012_rule_11_5_violation] */
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+        Timer_t * pxTimer = NULL;
+
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            const List_t * pxSlot;
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+            /* xNextExpireTime is either the expiry time of the timers in a level
+             * zero slot, or a time at which the wheel must cascade.  In the
+             * latter case there may not be a timer to process. */
+            prvAdvanceTimerWheel( pxService, xNextExpireTime );
+            pxSlot = &( pxService->xWheel[ tmrWHEEL_SLOT( xNextExpireTime, 0U ) ] );
 
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            if( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
+        {
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxService->pxCurrentList );
+        }
+        #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
 
-        /* If the timer is an auto-reload timer then calculate the next
-         * expiry time and re-insert the timer in the list of active timers. */
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
+        if( pxTimer != NULL )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                /* Keep the timer in this timer service until its callback has
+                 * executed, even if it is a one-shot timer that becomes dormant. */
+                taskENTER_CRITICAL();
+                {
+                    pxTimer->uxTimerUseCount++;
+                }
+                taskEXIT_CRITICAL();
+            }
+            #endif
+
+            /* Remove the timer from the list of active timers.  A check has
+             * already been performed to ensure the list is not empty. */
+            prvRemoveTimerFromActiveList( pxService, pxTimer );
+
+            /* If the timer is an auto-reload timer then calculate the next
+             * expiry time and re-insert the timer in the list of active timers. */
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
+            {
+                prvReloadTimer( pxService, pxTimer, xNextExpireTime, xTimeNow );
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+
+            /* Call the timer callback. */
+            prvExecuteTimerCallback( pxTimer );
+
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                prvReleaseTimerService( pxTimer );
+            }
+            #endif
         }
         else
         {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            mtCOVERAGE_TEST_MARKER();
         }
-
-        /* Call the timer callback. */
-        traceTIMER_EXPIRED( pxTimer );
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
     }
 /*-----------------------------------------------------------*/
 
@@ -746,8 +1317,12 @@
         TickType_t xNextExpireTime;
         BaseType_t xListWasEmpty;
 
-        /* Just to avoid compiler warnings. */
-        ( void ) pvParameters;
+        /* The timer service processed by this task is passed in as the task
+         * parameter. */
+        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        TimerService_t * const pxService = ( TimerService_t * ) pvParameters;
 
         #if ( configUSE_DAEMON_TASK_STARTUP_HOOK == 1 )
         {
@@ -755,27 +1330,52 @@
              * this task at the point the task starts executing.  This is useful if the
              * application includes initialisation code that would benefit from
              * executing after the scheduler has been started. */
-            vApplicationDaemonTaskStartupHook();
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                /* Only the timer service task of core 0 executes the hook. */
+                if( pxService == &( xTimerServices[ 0 ] ) )
+                {
+                    vApplicationDaemonTaskStartupHook();
+                }
+            }
+            #else
+            {
+                vApplicationDaemonTaskStartupHook();
+            }
+            #endif
         }
         #endif /* configUSE_DAEMON_TASK_STARTUP_HOOK */
 
         for( ; configCONTROL_INFINITE_LOOP(); )
         {
-            /* Query the timers list to see if it contains any timers, and if so,
-             * obtain the time at which the next timer will expire. */
-            xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+            #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            {
+                /* Tasks can change the active timers at any time, so the time at
+                 * which the next timer will expire is obtained with the
+                 * scheduler suspended inside prvProcessTimerOrBlockTask(). */
+                xNextExpireTime = ( TickType_t ) 0U;
+                xListWasEmpty = pdTRUE;
+            }
+            #else
+            {
+                /* Query the timers list to see if it contains any timers, and if so,
+                 * obtain the time at which the next timer will expire. */
+                xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
+            }
+            #endif
 
             /* If a timer has expired, process it.  Otherwise, block this task
              * until either a timer does expire, or a command is received. */
-            prvProcessTimerOrBlockTask( xNextExpireTime, xListWasEmpty );
+            prvProcessTimerOrBlockTask( pxService, xNextExpireTime, xListWasEmpty );
 
             /* Empty the command queue. */
-            prvProcessReceivedCommands();
+            prvProcessReceivedCommands( pxService );
         }
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty )
     {
         TickType_t xTimeNow;
@@ -783,22 +1383,37 @@
 
         vTaskSuspendAll();
         {
+            #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+            {
+                xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
+            }
+            #endif
+
             /* Obtain the time now to make an assessment as to whether the timer
              * has expired or not.  If obtaining the time causes the lists to switch
              * then don't process this timer as any timers that remained in the list
              * when the lists were switched will have been processed within the
              * prvSampleTimeNow() function. */
-            xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+            xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
 
             if( xTimerListsWereSwitched == pdFALSE )
             {
                 /* The tick count has not overflowed, has the timer expired? */
                 if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
                 {
-                    ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
-                }
-                else
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                    {
+                        prvProcessExpiredTimer( pxService, xNextExpireTime, xTimeNow );
+                        ( void ) xTaskResumeAll();
+                    }
+                    #else
+                    {
+                        ( void ) xTaskResumeAll();
+                        prvProcessExpiredTimer( pxService, xNextExpireTime, xTimeNow );
+                    }
+                    #endif
+                }
+                else
                 {
                     /* The tick count has not overflowed, and the next expire
                      * time has not been reached yet.  This task should therefore
@@ -806,14 +1421,37 @@
                      * received - whichever comes first.  The following line cannot
                      * be reached unless xNextExpireTime > xTimeNow, except in the
                      * case when the current timer list is empty. */
+                    #if ( configUSE_TIMER_SLACK == 1 )
+                    {
+                        if( xListWasEmpty == pdFALSE )
+                        {
+                            /* Block until the latest time at which the next timer
+                             * can be processed, so other timers that expire before
+                             * then are processed in the same wake up. */
+                            xNextExpireTime = prvGetCoalescedExpireTime( pxService, xNextExpireTime );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif /* configUSE_TIMER_SLACK */
+
                     if( xListWasEmpty != pdFALSE )
                     {
                         /* The current timer list is empty - is the overflow list
                          * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        xListWasEmpty = listLIST_IS_EMPTY( pxService->pxOverflowList );
+                    }
+
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                    {
+                        pxService->xWakeTime = xNextExpireTime;
+                        pxService->xBlockedIndefinitely = xListWasEmpty;
                     }
+                    #endif
 
-                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+                    vQueueWaitForMessageRestricted( pxService->xQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
                     if( xTaskResumeAll() == pdFALSE )
                     {
@@ -837,7 +1475,8 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+    static TickType_t prvGetNextExpireTime( const TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty )
     {
         TickType_t xNextExpireTime;
 
@@ -848,32 +1487,197 @@
          * this task to unblock when the tick count overflows, at which point the
          * timer lists will be switched and the next expiry time can be
          * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+        *pxListWasEmpty = listLIST_IS_EMPTY( pxService->pxCurrentList );
 
-        if( *pxListWasEmpty == pdFALSE )
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            UBaseType_t uxLevel, uxSlot, uxShift;
+            BaseType_t xFound = pdFALSE;
+
+            /* The timers held in the wheel expire before any timer left in the
+             * current timer list.  Search the wheel one level at a time, starting
+             * from the slot that corresponds to xWheelTime.  The slot of
+             * xWheelTime itself only needs searching in level zero because timers
+             * are held in the lowest level at which their slot differs from that
+             * of xWheelTime. */
+            for( uxLevel = 0U; ( uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS ) && ( xFound == pdFALSE ); uxLevel++ )
+            {
+                if( pxService->uxWheelLevelCount[ uxLevel ] > 0U )
+                {
+                    uxShift = uxLevel * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS;
+                    uxSlot = tmrWHEEL_SLOT( pxService->xWheelTime, uxLevel );
+
+                    if( uxLevel > 0U )
+                    {
+                        uxSlot++;
+                    }
+
+                    for( ; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                    {
+                        if( listLIST_IS_EMPTY( &( pxService->xWheel[ ( uxLevel * tmrWHEEL_SLOTS ) + uxSlot ] ) ) == pdFALSE )
+                        {
+                            /* For level zero this is the expiry time of the
+                             * timers in the slot, for the higher levels it is the
+                             * time at which the slot must be cascaded. */
+                            xNextExpireTime = pxService->xWheelTime & ~( ( ( TickType_t ) 1U << ( uxShift + ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS ) ) - ( TickType_t ) 1U );
+                            xNextExpireTime |= ( ( TickType_t ) uxSlot ) << uxShift;
+                            xFound = pdTRUE;
+                            break;
+                        }
+                    }
+
+                    /* A level that holds timers must hold a timer in a slot that
+                     * follows the slot of xWheelTime. */
+                    configASSERT( xFound != pdFALSE );
+                }
+            }
+
+            if( xFound != pdFALSE )
+            {
+                *pxListWasEmpty = pdFALSE;
+            }
+            else if( *pxListWasEmpty == pdFALSE )
+            {
+                /* The wheel is empty, so wake at the start of the block in which
+                 * the first timer in the current timer list expires, at which
+                 * point the timer is moved into the wheel. */
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentList ) & ~( ( ( TickType_t ) 1U << tmrWHEEL_RANGE_BITS ) - ( TickType_t ) 1U );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
-        else
+        #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
+        #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
 
         return xNextExpireTime;
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
+    #if ( configUSE_TIMER_SLACK == 1 )
+
+        static TickType_t prvGetCoalescedExpireTime( const TimerService_t * const pxService,
+                                                     const TickType_t xNextExpireTime )
+        {
+            TickType_t xCoalescedTime;
+
+            #if ( configUSE_TIMER_WHEEL == 1 )
+            {
+                UBaseType_t uxSlot;
+
+                if( ( ( xNextExpireTime ^ pxService->xWheelTime ) >> configTIMER_WHEEL_SLOT_BITS ) == ( TickType_t ) 0U )
+                {
+                    /* xNextExpireTime is the expiry time of the timers in a level
+                     * zero slot.  Only the level zero slots that follow it need to
+                     * be searched as any timer in a higher level expires after the
+                     * last of them. */
+                    xCoalescedTime = pxService->xWheelTime | tmrWHEEL_SLOT_MASK;
+
+                    for( uxSlot = tmrWHEEL_SLOT( xNextExpireTime, 0U ); uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                    {
+                        if( ( ( pxService->xWheelTime & ~tmrWHEEL_SLOT_MASK ) | ( TickType_t ) uxSlot ) > xCoalescedTime )
+                        {
+                            break;
+                        }
+
+                        xCoalescedTime = prvCoalesceTimersInList( &( pxService->xWheel[ uxSlot ] ), xCoalescedTime );
+                    }
+                }
+                else
+                {
+                    /* xNextExpireTime is a time at which the wheel must cascade,
+                     * which cannot be delayed. */
+                    xCoalescedTime = xNextExpireTime;
+                }
+            }
+            #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
+            {
+                /* The slack of a timer cannot delay its processing beyond the
+                 * tick count overflowing, as the lists are switched at that
+                 * time. */
+                ( void ) xNextExpireTime;
+                xCoalescedTime = prvCoalesceTimersInList( pxService->pxCurrentList, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
+            #endif /* if ( configUSE_TIMER_WHEEL == 1 ) */
+
+            return xCoalescedTime;
+        }
+/*-----------------------------------------------------------*/
+
+        static TickType_t prvCoalesceTimersInList( const List_t * const pxList,
+                                                   TickType_t xCoalescedTime )
+        {
+            const ListItem_t * pxListItem;
+            const ListItem_t * const pxListEnd = listGET_END_MARKER( pxList );
+            const Timer_t * pxTimer;
+            TickType_t xExpiryTime, xLatestTime;
+
+            for( pxListItem = listGET_HEAD_ENTRY( pxList ); pxListItem != pxListEnd; pxListItem = listGET_NEXT( pxListItem ) )
+            {
+                xExpiryTime = listGET_LIST_ITEM_VALUE( pxListItem );
+
+                /* Timers that expire after xCoalescedTime are not processed in
+                 * this wake up, so do not constrain it. */
+                if( xExpiryTime > xCoalescedTime )
+                {
+                    break;
+                }
+
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( const Timer_t * ) listGET_LIST_ITEM_OWNER( pxListItem );
+                xLatestTime = xExpiryTime + pxTimer->xTimerSlackInTicks;
+
+                if( xLatestTime < xExpiryTime )
+                {
+                    /* The slack extends beyond the tick count overflowing. */
+                    xLatestTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( xLatestTime < xCoalescedTime )
+                {
+                    xCoalescedTime = xLatestTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            return xCoalescedTime;
+        }
+
+    #endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
+        if( xTimeNow < pxService->xLastSampledTime )
         {
-            prvSwitchTimerLists();
+            prvSwitchTimerLists( pxService );
             *pxTimerListsWereSwitched = pdTRUE;
         }
         else
@@ -881,13 +1685,14 @@
             *pxTimerListsWereSwitched = pdFALSE;
         }
 
-        xLastTime = xTimeNow;
+        pxService->xLastSampledTime = xTimeNow;
 
         return xTimeNow;
     }
 /*-----------------------------------------------------------*/
 
-    static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+    static BaseType_t prvInsertTimerInActiveList( TimerService_t * const pxService,
+                                                  Timer_t * const pxTimer,
                                                   const TickType_t xNextExpiryTime,
                                                   const TickType_t xTimeNow,
                                                   const TickType_t xCommandTime )
@@ -909,7 +1714,7 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                vListInsert( pxService->pxOverflowList, &( pxTimer->xTimerListItem ) );
             }
         }
         else
@@ -923,7 +1728,22 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    if( prvInsertTimerInWheel( pxService, pxTimer, xNextExpiryTime ) == pdFALSE )
+                    {
+                        vListInsert( pxService->pxCurrentList, &( pxTimer->xTimerListItem ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #else
+                {
+                    vListInsert( pxService->pxCurrentList, &( pxTimer->xTimerListItem ) );
+                }
+                #endif
             }
         }
 
@@ -931,14 +1751,324 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessReceivedCommands( void )
+    static void prvRemoveTimerFromActiveList( TimerService_t * const pxService,
+                                              Timer_t * const pxTimer )
+    {
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            const List_t * const pxContainer = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+
+            if( ( pxContainer >= &( pxService->xWheel[ 0 ] ) ) && ( pxContainer < &( pxService->xWheel[ configTIMER_WHEEL_LEVELS * tmrWHEEL_SLOTS ] ) ) )
+            {
+                pxService->uxWheelLevelCount[ ( UBaseType_t ) ( pxContainer - &( pxService->xWheel[ 0 ] ) ) / tmrWHEEL_SLOTS ]--;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else
+        {
+            /* Only the timer wheel needs the timer service. */
+            ( void ) pxService;
+        }
+        #endif /* configUSE_TIMER_WHEEL */
+
+        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+        static TimerService_t * prvClaimTimerService( Timer_t * const pxTimer,
+                                                      const BaseType_t xCallingCoreID )
+        {
+            BaseType_t xTargetID = pxTimer->xTimerCoreID;
+
+            if( xTargetID == tmrFOLLOW_CALLING_CORE )
+            {
+                xTargetID = xCallingCoreID;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* A timer that is not active, and that has no commands waiting to be
+             * processed, is not referenced by its timer service, so can safely be
+             * moved to another.  Otherwise the command must be processed by the
+             * timer service that already owns the timer so commands are processed
+             * in the order in which they were sent. */
+            if( ( xTargetID != pxTimer->xTimerServiceID ) &&
+                ( pxTimer->uxTimerUseCount == 0U ) &&
+                ( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0U ) )
+            {
+                pxTimer->xTimerServiceID = xTargetID;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxTimer->uxTimerUseCount++;
+
+            return &( xTimerServices[ pxTimer->xTimerServiceID ] );
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvReleaseTimerService( Timer_t * const pxTimer )
+        {
+            taskENTER_CRITICAL();
+            {
+                configASSERT( pxTimer->uxTimerUseCount > 0U );
+                pxTimer->uxTimerUseCount--;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* configUSE_TIMER_SERVICE_TASK_PER_CORE */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+
+        static BaseType_t prvProcessCommandDirect( TimerService_t * const pxService,
+                                                   Timer_t * const pxTimer,
+                                                   const BaseType_t xCommandID,
+                                                   const TickType_t xOptionalValue )
+        {
+            BaseType_t xReturn = pdFAIL;
+            BaseType_t xWakeTimerTask = pdFALSE;
+            TickType_t xTimeNow, xNextExpiryTime;
+            DaemonTaskMessage_t xMessage;
+
+            vTaskSuspendAll();
+            {
+                xTimeNow = xTaskGetTickCount();
+
+                /* If the tick count has overflowed since the timer service task
+                 * last sampled it then the timer lists have not been switched yet,
+                 * so leave the command to the timer service task. */
+                if( xTimeNow >= pxService->xLastSampledTime )
+                {
+                    xReturn = pdPASS;
+
+                    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+                    {
+                        prvRemoveTimerFromActiveList( pxService, pxTimer );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    switch( xCommandID )
+                    {
+                        case tmrCOMMAND_START_DONT_TRACE:
+                        case tmrCOMMAND_START:
+                        case tmrCOMMAND_RESET:
+                            if( prvInsertTimerInActiveList( pxService, pxTimer, xOptionalValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xOptionalValue ) == pdFALSE )
+                            {
+                                pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
+                                xWakeTimerTask = pdTRUE;
+                            }
+                            else
+                            {
+                                /* The timer expired before it was added to the
+                                 * active timer list.  Its callback must execute in
+                                 * the timer service task, so send the command. */
+                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                                xReturn = pdFAIL;
+                            }
+
+                            break;
+
+                        case tmrCOMMAND_STOP:
+                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                            break;
+
+                        case tmrCOMMAND_CHANGE_PERIOD:
+                            pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
+                            pxTimer->xTimerPeriodInTicks = xOptionalValue;
+                            configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+                            ( void ) prvInsertTimerInActiveList( pxService, pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                            xWakeTimerTask = pdTRUE;
+                            break;
+
+                        default:
+                            /* Don't expect to get here. */
+                            xReturn = pdFAIL;
+                            break;
+                    }
+
+                    if( xWakeTimerTask != pdFALSE )
+                    {
+                        /* Only wake the timer service task if the timer expires
+                         * before the time until which the timer service task is
+                         * blocked.  Comparing the ticks remaining from xTimeNow
+                         * correctly handles a timer that was placed in the overflow
+                         * list. */
+                        xNextExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+
+                        #if ( configUSE_TIMER_SLACK == 1 )
+                        {
+                            /* The timer does not need processing until its slack
+                             * has elapsed. */
+                            xNextExpiryTime += pxTimer->xTimerSlackInTicks;
+
+                            if( xNextExpiryTime < listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) )
+                            {
+                                xNextExpiryTime = tmrMAX_TIME_BEFORE_OVERFLOW;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        #endif /* configUSE_TIMER_SLACK */
+
+                        if( ( pxService->xBlockedIndefinitely == pdFALSE ) &&
+                            ( ( TickType_t ) ( xNextExpiryTime - xTimeNow ) >= ( TickType_t ) ( pxService->xWakeTime - xTimeNow ) ) )
+                        {
+                            xWakeTimerTask = pdFALSE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            if( ( xWakeTimerTask != pdFALSE ) && ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) )
+            {
+                /* A message that does not reference a timer unblocks the timer
+                 * service task so it re-evaluates its block time.  If the queue is
+                 * full the timer service task is going to run anyway. */
+                xMessage.xMessageID = tmrCOMMAND_START_DONT_TRACE;
+                xMessage.u.xTimerParameters.xMessageValue = xTimeNow;
+                xMessage.u.xTimerParameters.pxTimer = NULL;
+                ( void ) xQueueSendToBack( pxService->xQueue, &xMessage, tmrNO_DELAY );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+
+    #endif /* configUSE_TIMER_DIRECT_COMMANDS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+        static BaseType_t prvInsertTimerInWheel( TimerService_t * const pxService,
+                                                 Timer_t * const pxTimer,
+                                                 const TickType_t xNextExpiryTime )
+        {
+            const TickType_t xDifference = xNextExpiryTime ^ pxService->xWheelTime;
+            UBaseType_t uxLevel = 0U;
+            BaseType_t xReturn = pdFALSE;
+
+            if( ( xDifference >> tmrWHEEL_RANGE_BITS ) == ( TickType_t ) 0U )
+            {
+                /* Find the lowest level at which the slot of the expiry time is
+                 * the only difference from xWheelTime. */
+                while( ( xDifference >> ( ( uxLevel + 1U ) * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS ) ) != ( TickType_t ) 0U )
+                {
+                    uxLevel++;
+                }
+
+                /* Timers are added to the end of the slot so timers that expire
+                 * at the same time are processed in the order in which they were
+                 * started, as they are when held in the sorted list. */
+                listINSERT_END( &( pxService->xWheel[ ( uxLevel * tmrWHEEL_SLOTS ) + tmrWHEEL_SLOT( xNextExpiryTime, uxLevel ) ] ), &( pxTimer->xTimerListItem ) );
+                pxService->uxWheelLevelCount[ uxLevel ]++;
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvAdvanceTimerWheel( TimerService_t * const pxService,
+                                          const TickType_t xNewTime )
+        {
+            const TickType_t xChangedBits = pxService->xWheelTime ^ xNewTime;
+            UBaseType_t uxLevel;
+            List_t * pxSlot;
+            Timer_t * pxTimer;
+
+            pxService->xWheelTime = xNewTime;
+
+            /* Move any timers that expire in the block now referenced by
+             * xWheelTime from the current timer list into the wheel.  The list is
+             * sorted, so they are moved in expiry time order. */
+            while( ( listLIST_IS_EMPTY( pxService->pxCurrentList ) == pdFALSE ) &&
+                   ( ( ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentList ) ^ xNewTime ) >> tmrWHEEL_RANGE_BITS ) == ( TickType_t ) 0U ) )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxService->pxCurrentList );
+                ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                ( void ) prvInsertTimerInWheel( pxService, pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+            }
+
+            /* Cascade the slot of xNewTime in each level whose slot changed,
+             * highest level first so timers cascaded from one level can be
+             * cascaded again from the level below.  Timers are moved in the order
+             * in which they were added to the slot, which preserves the order in
+             * which timers with the same expiry time are processed. */
+            for( uxLevel = ( UBaseType_t ) configTIMER_WHEEL_LEVELS - 1U; uxLevel > 0U; uxLevel-- )
+            {
+                if( ( xChangedBits >> ( uxLevel * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS ) ) != ( TickType_t ) 0U )
+                {
+                    pxSlot = &( pxService->xWheel[ ( uxLevel * tmrWHEEL_SLOTS ) + tmrWHEEL_SLOT( xNewTime, uxLevel ) ] );
+
+                    while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                    {
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                        pxService->uxWheelLevelCount[ uxLevel ]--;
+                        ( void ) prvInsertTimerInWheel( pxService, pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+
+    #endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+    static void prvProcessReceivedCommands( TimerService_t * const pxService )
     {
         DaemonTaskMessage_t xMessage = { 0 };
         Timer_t * pxTimer;
         BaseType_t xTimerListsWereSwitched;
         TickType_t xTimeNow;
 
-        while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL )
+        while( xQueueReceive( pxService->xQueue, &xMessage, tmrNO_DELAY ) != pdFAIL )
         {
             #if ( INCLUDE_xTimerPendFunctionCall == 1 )
             {
@@ -972,10 +2102,25 @@
 
                 if( pxTimer != NULL )
                 {
+                    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                    {
+                        /* Commands are only sent to the timer service that owns
+                         * the timer. */
+                        configASSERT( &( xTimerServices[ pxTimer->xTimerServiceID ] ) == pxService );
+                    }
+                    #endif
+
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                    {
+                        /* Tasks also access the active timers directly. */
+                        vTaskSuspendAll();
+                    }
+                    #endif
+
                     if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
                     {
                         /* The timer is in a list, remove it. */
-                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                        prvRemoveTimerFromActiveList( pxService, pxTimer );
                     }
                     else
                     {
@@ -986,11 +2131,11 @@
 
                     /* In this case the xTimerListsWereSwitched parameter is not used, but
                      *  it must be present in the function call.  prvSampleTimeNow() must be
-                     *  called after the message is received from xTimerQueue so there is no
+                     *  called after the message is received from the timer queue so there is no
                      *  possibility of a higher priority task adding a message to the message
                      *  queue with a time that is ahead of the timer daemon task (because it
                      *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                    xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+                    xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
 
                     switch( xMessage.xMessageID )
                     {
@@ -1001,13 +2146,13 @@
                             /* Start or restart a timer. */
                             pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
 
-                            if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
+                            if( prvInsertTimerInActiveList( pxService, pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
                             {
                                 /* The timer expired before it was added to the active
                                  * timer list.  Process it now. */
                                 if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
                                 {
-                                    prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                                    prvReloadTimer( pxService, pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
                                 }
                                 else
                                 {
@@ -1015,8 +2160,7 @@
                                 }
 
                                 /* Call the timer callback. */
-                                traceTIMER_EXPIRED( pxTimer );
-                                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                                prvExecuteTimerCallback( pxTimer );
                             }
                             else
                             {
@@ -1043,7 +2187,7 @@
                              * be zero the next expiry time can only be in the future,
                              * meaning (unlike for the xTimerStart() case above) there is
                              * no fail case that needs to be handled here. */
-                            ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                            ( void ) prvInsertTimerInActiveList( pxService, pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
                             break;
 
                         case tmrCOMMAND_DELETE:
@@ -1054,7 +2198,7 @@
                                  * allocated. */
                                 if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
                                 {
-                                    vPortFree( pxTimer );
+                                    prvFreeTimer( pxTimer );
                                 }
                                 else
                                 {
@@ -1076,86 +2220,207 @@
                             /* Don't expect to get here. */
                             break;
                     }
+
+                    #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                    {
+                        /* A deleted timer must not be accessed again. */
+                        if( xMessage.xMessageID != tmrCOMMAND_DELETE )
+                        {
+                            prvReleaseTimerService( pxTimer );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif
+
+                    #if ( configUSE_TIMER_DIRECT_COMMANDS == 1 )
+                    {
+                        ( void ) xTaskResumeAll();
+                    }
+                    #endif
                 }
                 else
                 {
+                    /* A message that does not reference a timer is sent to
+                     * unblock this task when configUSE_TIMER_DIRECT_COMMANDS is 1,
+                     * or when a function is written to an empty deferred call
+                     * ring. */
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
         }
+
+        #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+        {
+            /* The ring is drained after the queue is empty.  A function written
+             * to the ring after this point finds the ring empty, so sends a
+             * message that prevents this task from blocking. */
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                /* Each timer service task only executes the functions pended by
+                 * interrupts on its own core, whose ring has the same index as
+                 * its timer service. */
+                prvExecuteDeferredCalls( &( xDeferredCallRings[ pxService - &( xTimerServices[ 0 ] ) ] ) );
+            }
+            #else
+            {
+                BaseType_t xCoreID;
+
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    prvExecuteDeferredCalls( &( xDeferredCallRings[ xCoreID ] ) );
+                }
+            }
+            #endif /* configUSE_TIMER_SERVICE_TASK_PER_CORE */
+        }
+        #endif /* if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) ) */
     }
 /*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
+    #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+
+        static void prvExecuteDeferredCalls( DeferredCallRing_t * const pxRing )
+        {
+            CallbackParameters_t xCall;
+            UBaseType_t uxTail = pxRing->uxTail;
+            UBaseType_t uxHead;
+
+            tmrENTER_RING_CRITICAL();
+            {
+                uxHead = pxRing->uxHead;
+            }
+            tmrEXIT_RING_CRITICAL();
+
+            while( uxTail != uxHead )
+            {
+                xCall = pxRing->xCalls[ uxTail ];
+
+                if( uxTail == ( UBaseType_t ) configTIMER_DEFERRED_CALL_RING_LENGTH )
+                {
+                    uxTail = 0U;
+                }
+                else
+                {
+                    uxTail++;
+                }
+
+                /* Free the slot before executing the call, so the slot can be
+                 * reused by an interrupt while the function executes, then check
+                 * for calls written since the head was last read. */
+                tmrENTER_RING_CRITICAL();
+                {
+                    pxRing->uxTail = uxTail;
+                    uxHead = pxRing->uxHead;
+                }
+                tmrEXIT_RING_CRITICAL();
+
+                xCall.pxCallbackFunction( xCall.pvParameter1, xCall.ulParameter2 );
+            }
+        }
+
+    #endif /* if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) ) */
+/*-----------------------------------------------------------*/
+
+    static void prvSwitchTimerLists( TimerService_t * const pxService )
     {
         TickType_t xNextExpireTime;
+        BaseType_t xListWasEmpty;
         List_t * pxTemp;
 
         /* The tick count has overflowed.  The timer lists must be switched.
          * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
-        {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+         * (or the timer wheel) then they must have expired and should be
+         * processed before the lists are switched. */
+        xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
 
+        while( xListWasEmpty == pdFALSE )
+        {
             /* Process the expired timer.  For auto-reload timers, be careful to
              * process only expirations that occur on the current list.  Further
              * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            prvProcessExpiredTimer( pxService, xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
+        pxTemp = pxService->pxCurrentList;
+        pxService->pxCurrentList = pxService->pxOverflowList;
+        pxService->pxOverflowList = pxTemp;
+
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            /* The wheel is empty, so can restart from the overflowed tick
+             * count. */
+            pxService->xWheelTime = ( TickType_t ) 0U;
+        }
+        #endif
     }
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
     {
+        TimerService_t * pxService;
+
         /* Check that the list from which active timers are referenced, and the
          * queue used to communicate with the timer service, have been
          * initialised. */
         taskENTER_CRITICAL();
         {
-            if( xTimerQueue == NULL )
+            for( pxService = &( xTimerServices[ 0 ] ); pxService < &( xTimerServices[ tmrNUMBER_OF_TIMER_SERVICES ] ); pxService++ )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
-
-                #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                if( pxService->xQueue == NULL )
                 {
-                    /* The timer queue is allocated statically in case
-                     * configSUPPORT_DYNAMIC_ALLOCATION is 0. */
-                    PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue;
-                    PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ];
+                    vListInitialise( &( pxService->xActiveList1 ) );
+                    vListInitialise( &( pxService->xActiveList2 ) );
+                    pxService->pxCurrentList = &( pxService->xActiveList1 );
+                    pxService->pxOverflowList = &( pxService->xActiveList2 );
 
-                    xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
-                }
-                #else
-                {
-                    xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ) );
-                }
-                #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                    #if ( configUSE_TIMER_WHEEL == 1 )
+                    {
+                        UBaseType_t uxIndex;
 
-                #if ( configQUEUE_REGISTRY_SIZE > 0 )
-                {
-                    if( xTimerQueue != NULL )
+                        for( uxIndex = 0U; uxIndex < ( ( UBaseType_t ) configTIMER_WHEEL_LEVELS * tmrWHEEL_SLOTS ); uxIndex++ )
+                        {
+                            vListInitialise( &( pxService->xWheel[ uxIndex ] ) );
+                        }
+
+                        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxIndex++ )
+                        {
+                            pxService->uxWheelLevelCount[ uxIndex ] = 0U;
+                        }
+
+                        pxService->xWheelTime = ( TickType_t ) 0U;
+                    }
+                    #endif /* configUSE_TIMER_WHEEL */
+
+                    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                     {
-                        vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+                        pxService->xQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( pxService->ucStaticQueueStorage[ 0 ] ), &( pxService->xStaticQueue ) );
                     }
-                    else
+                    #else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        pxService->xQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ) );
                     }
+                    #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+
+                    #if ( configQUEUE_REGISTRY_SIZE > 0 )
+                    {
+                        if( pxService->xQueue != NULL )
+                        {
+                            vQueueAddToRegistry( pxService->xQueue, "TmrQ" );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif /* configQUEUE_REGISTRY_SIZE */
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
-                #endif /* configQUEUE_REGISTRY_SIZE */
-            }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
             }
         }
         taskEXIT_CRITICAL();
@@ -1241,16 +2506,109 @@
             DaemonTaskMessage_t xMessage;
             BaseType_t xReturn;
 
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+
+                /* The function is executed by the timer service task of the core
+                 * on which the interrupt executes. */
+                const TimerService_t * const pxService = &( xTimerServices[ portGET_CORE_ID() ] );
+            #else
+                const TimerService_t * const pxService = &( xTimerServices[ 0 ] );
+            #endif
+
             traceENTER_xTimerPendFunctionCallFromISR( xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken );
 
-            /* Complete the message with the function parameters and post it to the
-             * daemon task. */
-            xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
-            xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
-            xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
-            xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+            #if ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 )
+            {
+                DeferredCallRing_t * pxRing;
+                UBaseType_t uxHead, uxNextHead, uxSavedInterruptStatus;
+                BaseType_t xRingWasEmpty = pdFALSE;
+
+                /* Mask interrupts so a nested interrupt on this core cannot
+                 * write to the same slot.  Interrupts on other cores use their
+                 * own ring, but the ISR lock is also taken if this ring is
+                 * drained by a timer service task on another core. */
+                uxSavedInterruptStatus = tmrENTER_RING_CRITICAL_FROM_ISR();
+                {
+                    #if ( configNUMBER_OF_CORES > 1 )
+                        pxRing = &( xDeferredCallRings[ portGET_CORE_ID() ] );
+                    #else
+                        pxRing = &( xDeferredCallRings[ 0 ] );
+                    #endif
+
+                    uxHead = pxRing->uxHead;
+
+                    if( uxHead == ( UBaseType_t ) configTIMER_DEFERRED_CALL_RING_LENGTH )
+                    {
+                        uxNextHead = 0U;
+                    }
+                    else
+                    {
+                        uxNextHead = uxHead + 1U;
+                    }
 
-            xReturn = xQueueSendFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+                    if( uxNextHead != pxRing->uxTail )
+                    {
+                        pxRing->xCalls[ uxHead ].pxCallbackFunction = xFunctionToPend;
+                        pxRing->xCalls[ uxHead ].pvParameter1 = pvParameter1;
+                        pxRing->xCalls[ uxHead ].ulParameter2 = ulParameter2;
+
+                        /* Publish the call, then check whether the timer service
+                         * task had already consumed every earlier call, in which
+                         * case it might not look at the ring again until it is
+                         * woken. */
+                        portMEMORY_BARRIER();
+                        pxRing->uxHead = uxNextHead;
+                        portMEMORY_BARRIER();
+
+                        if( pxRing->uxTail == uxHead )
+                        {
+                            xRingWasEmpty = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        xReturn = pdPASS;
+                    }
+                    else
+                    {
+                        /* The call is not sent on the timer queue instead as it
+                         * could then execute before the calls already in the
+                         * ring. */
+                        pxRing->uxOverflowCount++;
+                        xReturn = pdFAIL;
+                    }
+                }
+                tmrEXIT_RING_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+                if( xRingWasEmpty != pdFALSE )
+                {
+                    /* A message that does not reference a timer unblocks the
+                     * timer service task.  If the queue is full the timer service
+                     * task is going to run, and drain the ring, anyway. */
+                    xMessage.xMessageID = tmrCOMMAND_START_DONT_TRACE;
+                    xMessage.u.xTimerParameters.xMessageValue = ( TickType_t ) 0U;
+                    xMessage.u.xTimerParameters.pxTimer = NULL;
+                    ( void ) xQueueSendFromISR( pxService->xQueue, &xMessage, pxHigherPriorityTaskWoken );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #else /* if ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) */
+            {
+                /* Complete the message with the function parameters and post it to the
+                 * daemon task. */
+                xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
+                xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
+                xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
+                xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+
+                xReturn = xQueueSendFromISR( pxService->xQueue, &xMessage, pxHigherPriorityTaskWoken );
+            }
+            #endif /* if ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) */
 
             tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
             traceRETURN_xTimerPendFunctionCallFromISR( xReturn );
@@ -1270,13 +2628,30 @@
         {
             DaemonTaskMessage_t xMessage;
             BaseType_t xReturn;
+            const TimerService_t * pxService = &( xTimerServices[ 0 ] );
+
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+                UBaseType_t uxSavedInterruptStatus;
+            #endif
 
             traceENTER_xTimerPendFunctionCall( xFunctionToPend, pvParameter1, ulParameter2, xTicksToWait );
 
+            #if ( configUSE_TIMER_SERVICE_TASK_PER_CORE == 1 )
+            {
+                /* The function is executed by the timer service task of the core
+                 * on which the calling task is running. */
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+                {
+                    pxService = &( xTimerServices[ portGET_CORE_ID() ] );
+                }
+                portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+            }
+            #endif
+
             /* This function can only be called after a timer has been created or
              * after the scheduler has been started because, until then, the timer
              * queue does not exist. */
-            configASSERT( xTimerQueue );
+            configASSERT( pxService->xQueue );
 
             /* Complete the message with the function parameters and post it to the
              * daemon task. */
@@ -1285,7 +2660,7 @@
             xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
             xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
 
-            xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
+            xReturn = xQueueSendToBack( pxService->xQueue, &xMessage, xTicksToWait );
 
             tracePEND_FUNC_CALL( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
             traceRETURN_xTimerPendFunctionCall( xReturn );
@@ -1296,6 +2671,28 @@
     #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
+    #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+
+        UBaseType_t uxTimerGetDeferredCallOverflowCount( void )
+        {
+            UBaseType_t uxOverflowCount = 0U;
+            BaseType_t xCoreID;
+
+            traceENTER_uxTimerGetDeferredCallOverflowCount();
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                uxOverflowCount += xDeferredCallRings[ xCoreID ].uxOverflowCount;
+            }
+
+            traceRETURN_uxTimerGetDeferredCallOverflowCount( uxOverflowCount );
+
+            return uxOverflowCount;
+        }
+
+    #endif /* if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) ) */
+/*-----------------------------------------------------------*/
+
     #if ( configUSE_TRACE_FACILITY == 1 )
 
         UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer )
@@ -1332,8 +2729,26 @@
  */
     void vTimerResetState( void )
     {
-        xTimerQueue = NULL;
-        xTimerTaskHandle = NULL;
+        TimerService_t * pxService;
+
+        for( pxService = &( xTimerServices[ 0 ] ); pxService < &( xTimerServices[ tmrNUMBER_OF_TIMER_SERVICES ] ); pxService++ )
+        {
+            pxService->xQueue = NULL;
+            pxService->xTaskHandle = NULL;
+        }
+
+        #if ( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configTIMER_DEFERRED_CALL_RING_LENGTH > 0 ) )
+        {
+            BaseType_t xCoreID;
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                xDeferredCallRings[ xCoreID ].uxHead = 0U;
+                xDeferredCallRings[ xCoreID ].uxTail = 0U;
+                xDeferredCallRings[ xCoreID ].uxOverflowCount = 0U;
+            }
+        }
+        #endif
     }
 /*-----------------------------------------------------------*/
 